@@ -0,0 +1,78 @@
+#include "strings_generated.hpp"
+#include "vec3f_generated.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/string.hpp>
+#include <lidlrt/vector.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+// Messages can't be larger than this since offsets are 16 bits.
+alignas(8) std::array<uint8_t, 32768> buffer;
+
+void message_builder_allocate(benchmark::State& state) {
+    for (auto _ : state) {
+        lidl::message_builder builder(buffer);
+        // The size isn't a multiple of the alignment, so every allocation after the
+        // first one needs padding.
+        for (int i = 0; i < 64; ++i) {
+            benchmark::DoNotOptimize(builder.allocate(6, 4));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(message_builder_allocate);
+
+void create_string(benchmark::State& state) {
+    std::string str(state.range(0), 'x');
+    for (auto _ : state) {
+        lidl::message_builder builder(buffer);
+        benchmark::DoNotOptimize(&lidl::create_string(builder, str));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+BENCHMARK(create_string)->RangeMultiplier(8)->Range(8, 4096);
+
+void create_vector(benchmark::State& state) {
+    std::vector<float> elems(state.range(0), 1.f);
+    for (auto _ : state) {
+        lidl::message_builder builder(buffer);
+        benchmark::DoNotOptimize(
+            &lidl::create_vector<float>(builder, tos::span<const float>(elems)));
+    }
+    state.SetBytesProcessed(state.iterations() * elems.size() * sizeof(float));
+}
+BENCHMARK(create_vector)->RangeMultiplier(8)->Range(8, 4096);
+
+void create_person(benchmark::State& state) {
+    for (auto _ : state) {
+        lidl::message_builder builder(buffer);
+        benchmark::DoNotOptimize(
+            &lidl::create<module::person>(builder,
+                                          lidl::create_string(builder, "Ada"),
+                                          lidl::create_string(builder, "Lovelace")));
+    }
+}
+BENCHMARK(create_person);
+
+void create_vertex(benchmark::State& state) {
+    for (auto _ : state) {
+        lidl::message_builder builder(buffer);
+        benchmark::DoNotOptimize(&lidl::create<gfx::vertex>(
+            builder, gfx::vec3f{1, 2, 3}, gfx::vec3f{0, 0, 1}));
+    }
+}
+BENCHMARK(create_vertex);
+
+void create_texture(benchmark::State& state) {
+    for (auto _ : state) {
+        lidl::message_builder builder(buffer);
+        benchmark::DoNotOptimize(&lidl::create<gfx::texture2d>(
+            builder, int16_t{64}, 64, lidl::create_string(builder, "albedo.png")));
+    }
+}
+BENCHMARK(create_texture);
+} // namespace
@@ -0,0 +1,68 @@
+#include "service_generated.hpp"
+#include "strings_generated.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/find_extent.hpp>
+#include <lidlrt/string.hpp>
+#include <lidlrt/vector.hpp>
+
+namespace {
+alignas(8) std::array<uint8_t, 256> person_buffer;
+alignas(8) std::array<uint8_t, 512> deep_buffer;
+
+tos::span<uint8_t> make_person() {
+    lidl::message_builder builder(person_buffer);
+    lidl::create<module::person>(builder,
+                                 lidl::create_string(builder, "Ada"),
+                                 lidl::create_string(builder, "Lovelace"));
+    return builder.get_buffer();
+}
+
+lidl_example::deep_struct& make_deep() {
+    lidl::message_builder builder(deep_buffer);
+    auto& vec = lidl::create_vector_sized<uint8_t>(builder, 128);
+    auto& base = lidl::create<lidl_example::string_struct>(
+        builder, lidl::create_string(builder, "hello"));
+    return lidl::create<lidl_example::deep_struct>(builder, vec, base);
+}
+
+void get_root_person(benchmark::State& state) {
+    auto buf = make_person();
+    for (auto _ : state) {
+        auto& p = lidl::get_root<module::person>(buf);
+        benchmark::DoNotOptimize(p.name().string_view().size() +
+                                 p.surname().string_view().size());
+    }
+}
+BENCHMARK(get_root_person);
+
+void read_deep(benchmark::State& state) {
+    auto& deep = make_deep();
+    for (auto _ : state) {
+        int sum = 0;
+        for (auto byte : deep.vec().span()) {
+            sum += byte;
+        }
+        benchmark::DoNotOptimize(sum + deep.base().str().string_view().size());
+    }
+}
+BENCHMARK(read_deep);
+
+void find_extent_person(benchmark::State& state) {
+    auto& p = lidl::get_root<module::person>(make_person());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lidl::meta::detail::find_extent(p));
+    }
+}
+BENCHMARK(find_extent_person);
+
+void find_extent_deep(benchmark::State& state) {
+    auto& deep = make_deep();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lidl::meta::detail::find_extent(deep));
+    }
+}
+BENCHMARK(find_extent_deep);
+} // namespace
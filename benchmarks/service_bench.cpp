@@ -0,0 +1,164 @@
+#include "service_generated.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/service.hpp>
+#include <lidlrt/transport/local.hpp>
+#include <lidlrt/zerocopy_vtable.hpp>
+
+namespace {
+using lidl_example::repeat;
+using lidl_example::scientific_calculator;
+
+class calculator_impl : public scientific_calculator::sync_server {
+public:
+    double add(const double& left, const double& right) override {
+        return left + right;
+    }
+
+    double multiply(const double& left, const double& right) override {
+        return left * right;
+    }
+
+    double log(const double& val) override {
+        return std::log(val);
+    }
+};
+
+class repeat_impl : public repeat::sync_server {
+public:
+    const lidl::vector<uint8_t>&
+    return_vector(lidl::message_builder& response_builder) override {
+        return lidl::create_vector_sized<uint8_t>(response_builder, 20);
+    }
+
+    std::string_view echo(std::string_view str,
+                          lidl::message_builder& response_builder) override {
+        return str;
+    }
+
+    tos::span<uint8_t> echo_bytes(tos::span<uint8_t> arg,
+                                  lidl::message_builder& response_builder) override {
+        return arg;
+    }
+};
+
+/**
+ * Runs the serialized requests a local_transport receives with a service.
+ */
+template<class ServiceT, class ImplT>
+struct local_server {
+    bool run_message(tos::span<uint8_t> req, lidl::message_builder& response) {
+        return handler(impl, req, response);
+    }
+
+    ImplT impl;
+    lidl::typed_procedure_runner_t<typename ServiceT::sync_server> handler =
+        lidl::make_procedure_runner<typename ServiceT::sync_server>();
+};
+
+/**
+ * Layer for zerocopy clients that calls a service in the same address space through
+ * its zerocopy vtable, without serializing anything.
+ */
+template<class ServiceT>
+struct zerocopy_local {
+    explicit zerocopy_local(lidl::service_base& serv)
+        : m_serv{&serv} {
+    }
+
+    template<int ProcId>
+    bool execute(std::integral_constant<int, ProcId>, const void* params, void* ret) {
+        return vtable[ProcId](*m_serv, params, ret);
+    }
+
+    static constexpr auto vtable = lidl::make_zerocopy_vtable<ServiceT>();
+    lidl::service_base* m_serv;
+};
+
+alignas(8) std::array<uint8_t, 256> request_buffer;
+alignas(8) std::array<uint8_t, 256> response_buffer;
+
+void request_handler_multiply(benchmark::State& state) {
+    lidl::message_builder builder(request_buffer);
+    lidl::create<scientific_calculator::wire_types::call_union>(
+        builder, lidl_example::calculator::wire_types::multiply_params(3, 5));
+    lidl::attach_envelope(builder);
+    auto req = builder.get_buffer();
+
+    calculator_impl calc;
+    auto handler = lidl::make_procedure_runner<scientific_calculator::sync_server>();
+
+    for (auto _ : state) {
+        lidl::message_builder response(response_buffer);
+        benchmark::DoNotOptimize(handler(calc, req, response));
+    }
+}
+BENCHMARK(request_handler_multiply);
+
+void request_handler_echo(benchmark::State& state) {
+    lidl::message_builder builder(request_buffer);
+    lidl::create<repeat::wire_types::call_union>(
+        builder,
+        lidl::create<repeat::wire_types::echo_params>(
+            builder, lidl::create_string(builder, "hello world")));
+    lidl::attach_envelope(builder);
+    auto req = builder.get_buffer();
+
+    repeat_impl rep;
+    auto handler = lidl::make_procedure_runner<repeat::sync_server>();
+
+    for (auto _ : state) {
+        lidl::message_builder response(response_buffer);
+        benchmark::DoNotOptimize(handler(rep, req, response));
+    }
+}
+BENCHMARK(request_handler_echo);
+
+void zerocopy_client_multiply(benchmark::State& state) {
+    calculator_impl calc;
+    scientific_calculator::zerocopy_client<zerocopy_local<scientific_calculator>> client(
+        calc);
+
+    double x = 3;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x);
+        benchmark::DoNotOptimize(client.multiply(x, 5));
+    }
+}
+BENCHMARK(zerocopy_client_multiply);
+
+void zerocopy_client_echo(benchmark::State& state) {
+    repeat_impl rep;
+    repeat::zerocopy_client<zerocopy_local<repeat>> client(rep);
+
+    for (auto _ : state) {
+        lidl::message_builder response(response_buffer);
+        benchmark::DoNotOptimize(client.echo("hello world", response));
+    }
+}
+BENCHMARK(zerocopy_client_echo);
+
+void local_transport_multiply(benchmark::State& state) {
+    scientific_calculator::stub_client<
+        lidl::local_transport<local_server<scientific_calculator, calculator_impl>>>
+        client;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(client.multiply(3, 5));
+    }
+}
+BENCHMARK(local_transport_multiply);
+
+void local_transport_echo(benchmark::State& state) {
+    repeat::stub_client<lidl::local_transport<local_server<repeat, repeat_impl>>> client;
+
+    for (auto _ : state) {
+        lidl::message_builder response(response_buffer);
+        benchmark::DoNotOptimize(client.echo("hello world", response));
+    }
+}
+BENCHMARK(local_transport_echo);
+} // namespace
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <fmt/format.h>
+#include <lidl/basic_types.hpp>
+#include <lidl/error.hpp>
+#include <lidl/eval/constants.hpp>
+#include <lidl/eval/evaluation.hpp>
+
+namespace lidl::eval {
+namespace {
+std::string type_string(const name& type) {
+    return fmt::format("{}", fmt::join(absolute_name(type.base), "::"));
+}
+
+common_errors mismatch(const name& type, const value& val) {
+    return common_errors{
+        {}, fmt::format("{} is not a valid {}", to_string(val), type_string(type))};
+}
+
+evaluate_result convert_integral(const integral_type& type,
+                                 const name& type_name,
+                                 const value& val) {
+    if (!val.is_integral()) {
+        return mismatch(type_name, val);
+    }
+
+    auto x = val.as_integral();
+    if (type.is_unsigned) {
+        auto fits = x >= 0 && (type.size_in_bits >= 64 ||
+                               uint64_t(x) < (uint64_t(1) << type.size_in_bits));
+        if (!fits) {
+            return mismatch(type_name, val);
+        }
+        return val;
+    }
+
+    if (type.size_in_bits < 64) {
+        auto limit = int64_t(1) << (type.size_in_bits - 1);
+        if (x < -limit || x >= limit) {
+            return mismatch(type_name, val);
+        }
+    }
+    return val;
+}
+
+// Constants being evaluated on this thread, used to detect cycles.
+thread_local std::vector<const constant*> in_progress;
+} // namespace
+
+evaluate_result convert_to(const module& mod, const name& type, const value& val) {
+    if (!is_type(type) || is_generic(type)) {
+        return common_errors{
+            {}, fmt::format("Constants of type {} are not supported", type_string(type))};
+    }
+
+    auto t = get_type(mod, type);
+
+    if (auto integral = dynamic_cast<const integral_type*>(t)) {
+        return convert_integral(*integral, type, val);
+    }
+
+    if (dynamic_cast<const float_type*>(t) || dynamic_cast<const double_type*>(t)) {
+        if (val.is_integral()) {
+            return value(static_cast<double>(val.as_integral()));
+        }
+        if (!val.is_double()) {
+            return mismatch(type, val);
+        }
+        return val;
+    }
+
+    if (dynamic_cast<const bool_type*>(t)) {
+        if (!val.is_bool()) {
+            return mismatch(type, val);
+        }
+        return val;
+    }
+
+    if (dynamic_cast<const string_type*>(t)) {
+        if (!val.is_string()) {
+            return mismatch(type, val);
+        }
+        return val;
+    }
+
+    if (auto enumeration = dynamic_cast<const lidl::enumeration*>(t)) {
+        if (!val.is_enum()) {
+            return mismatch(type, val);
+        }
+        auto member = get_symbol(val.as_enum().enum_value.base);
+        auto members = enumeration->all_members();
+        auto belongs = std::any_of(members.begin(), members.end(), [&](auto& mem) {
+            return mem.second == member;
+        });
+        if (!belongs) {
+            return mismatch(type, val);
+        }
+        return val;
+    }
+
+    return common_errors{
+        {}, fmt::format("Constants of type {} are not supported", type_string(type))};
+}
+
+evaluate_result evaluate_constant(const module& mod, const constant& c) {
+    if (std::find(in_progress.begin(), in_progress.end(), &c) != in_progress.end()) {
+        return common_errors{c.src_info, "Constant depends on its own value"};
+    }
+
+    in_progress.push_back(&c);
+    auto res = evaluate_expression(mod, *c.value);
+    in_progress.pop_back();
+
+    if (auto val = std::get_if<value>(&res)) {
+        res = convert_to(mod, c.type, *val);
+        if (auto err = std::get_if<common_errors>(&res); err && !err->src_info) {
+            err->src_info = c.src_info;
+        }
+    }
+    return res;
+}
+
+evaluate_result evaluate_default(const module& mod, const member& mem) {
+    auto res = evaluate_expression(mod, *mem.default_value);
+
+    if (auto val = std::get_if<value>(&res)) {
+        res = convert_to(mod, mem.type_, *val);
+        if (auto err = std::get_if<common_errors>(&res); err && !err->src_info) {
+            err->src_info = mem.src_info;
+        }
+    }
+    return res;
+}
+
+void check_constants(const module& mod) {
+    for (auto& [_, child] : mod.children) {
+        check_constants(*child);
+    }
+
+    for (auto& c : mod.constants) {
+        auto res = evaluate_constant(mod, *c);
+        if (auto err = std::get_if<common_errors>(&res)) {
+            report_user_error(error_type::fatal,
+                              err->src_info ? err->src_info : c->src_info,
+                              "Invalid constant: {}",
+                              err->message);
+        }
+    }
+
+    for (auto& str : mod.structs) {
+        for (auto& [name, mem] : str->all_members()) {
+            if (!mem.default_value) {
+                continue;
+            }
+            auto res = evaluate_default(mod, mem);
+            if (auto err = std::get_if<common_errors>(&res)) {
+                report_user_error(error_type::fatal,
+                                  err->src_info ? err->src_info : mem.src_info,
+                                  "Invalid default value for {}: {}",
+                                  name,
+                                  err->message);
+            }
+        }
+    }
+}
+} // namespace lidl::eval
@@ -1,5 +1,44 @@
+#include <lidl/error.hpp>
 #include <lidl/eval/evaluation.hpp>
 
 namespace lidl::eval {
+evaluate_result evaluate_expression(const module& mod, const expression& expr) {
+    auto res = expr.evaluate(mod);
+    if (auto err = std::get_if<common_errors>(&res); err && !err->src_info) {
+        err->src_info = expr.src_info;
+    }
+    return res;
+}
 
-}
\ No newline at end of file
+void check_static_assertions(const module& mod) {
+    for (auto& [_, child] : mod.children) {
+        check_static_assertions(*child);
+    }
+
+    for (auto& assertion : mod.static_assertions) {
+        auto res = evaluate_expression(mod, *assertion.condition);
+
+        if (auto err = std::get_if<common_errors>(&res)) {
+            report_user_error(error_type::fatal,
+                              err->src_info ? err->src_info : assertion.src_info,
+                              "Could not evaluate static assertion: {}",
+                              err->message);
+        }
+
+        auto& val = std::get<value>(res);
+        if (!val.is_bool()) {
+            report_user_error(error_type::fatal,
+                              assertion.src_info,
+                              "Static assertion condition must be a boolean, got {}",
+                              to_string(val));
+        }
+
+        if (!val.as_bool()) {
+            report_user_error(error_type::fatal,
+                              assertion.src_info,
+                              "Static assertion failed{}",
+                              assertion.message ? ": " + *assertion.message : "");
+        }
+    }
+}
+} // namespace lidl::eval
@@ -1,3 +1,8 @@
 #pragma once
 
-#include <lidl/eval/expression.hpp>
\ No newline at end of file
+#include <lidl/eval/constants.hpp>
+#include <lidl/eval/evaluation.hpp>
+#include <lidl/eval/expression.hpp>
+#include <lidl/eval/literals.hpp>
+#include <lidl/eval/relational_expressions.hpp>
+#include <lidl/eval/type_queries.hpp>
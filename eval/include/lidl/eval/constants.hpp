@@ -0,0 +1,34 @@
+#pragma once
+
+#include <lidl/constant.hpp>
+#include <lidl/eval/expression.hpp>
+#include <lidl/member.hpp>
+#include <lidl/module.hpp>
+
+namespace lidl::eval {
+/**
+ * Converts a value to the given type. Integers must fit in the type, integers become
+ * doubles for floating point types, and enum values must belong to the enumeration.
+ * Only numeric, boolean, enumeration and string types can hold constants.
+ */
+evaluate_result convert_to(const module& mod, const name& type, const value& val);
+
+/**
+ * Evaluates a constant and converts it to its declared type. Constants that refer to
+ * themselves, directly or not, are errors.
+ */
+evaluate_result evaluate_constant(const module& mod, const constant& c);
+
+/**
+ * Evaluates the default value of a member and converts it to the type of the member.
+ * The member must have a default value.
+ */
+evaluate_result evaluate_default(const module& mod, const member& mem);
+
+/**
+ * Evaluates every constant and member default in the given module and its children,
+ * and reports the ones that can't be evaluated or don't fit their types as fatal
+ * errors.
+ */
+void check_constants(const module& mod);
+} // namespace lidl::eval
@@ -4,7 +4,18 @@
 #include <lidl/module.hpp>
 
 namespace lidl::eval {
-struct any_value {};
+/**
+ * Evaluates the given expression. Errors without a source location get the location
+ * of the expression.
+ */
+evaluate_result evaluate_expression(const module& mod, const expression& expr);
 
-any_value evaluate_expression(const module& mod, const expression& expr);
-} // namespace lidl::eval
\ No newline at end of file
+/**
+ * Evaluates every static assertion in the given module and its children, and reports
+ * the ones that fail or can't be evaluated as fatal errors.
+ *
+ * Assertions may query layouts, so this must run once layouts are final, i.e. after
+ * member reordering has been decided.
+ */
+void check_static_assertions(const module& mod);
+} // namespace lidl::eval
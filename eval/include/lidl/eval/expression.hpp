@@ -3,10 +3,12 @@
 #include <lidl/eval/value.hpp>
 #include <lidl/module.hpp>
 #include <memory>
+#include <string>
 
 namespace lidl::eval {
 struct common_errors {
     std::optional<source_info> src_info;
+    std::string message;
 };
 
 using evaluate_result = std::variant<value, common_errors>;
@@ -9,7 +9,7 @@
 
 namespace lidl::eval {
 struct integral_literal_expression final : expression {
-    uint64_t value;
+    int64_t value;
     evaluate_result evaluate(const module& mod) const noexcept override {
         return lidl::eval::value(this->value);
     }
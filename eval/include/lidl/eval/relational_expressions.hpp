@@ -4,17 +4,58 @@
 #include <lidl/eval/value.hpp>
 #include <lidl/module.hpp>
 #include <memory>
+#include <optional>
+#include <string_view>
 
 namespace lidl::eval {
 enum class binary_operators
 {
-    eqeq
+    eqeq,
+    noteq,
+    less,
+    less_eq,
+    greater,
+    greater_eq,
+    add,
+    sub,
+    mul,
+    div,
+    mod,
+    logical_and,
+    logical_or,
 };
 
+enum class unary_operators
+{
+    negate,
+    logical_not,
+};
+
+/**
+ * Maps the spelling of an operator, such as `<=`, to the operator.
+ */
+std::optional<binary_operators> parse_binary_operator(std::string_view spelling);
+std::optional<unary_operators> parse_unary_operator(std::string_view spelling);
+
+std::string_view to_string(binary_operators op);
+std::string_view to_string(unary_operators op);
+
+/**
+ * Arithmetic is done in 64 bit signed integers, or in doubles if either operand is a
+ * double. Enum values take part in arithmetic and ordering as their numeric values.
+ * Overflows and divisions by zero are errors rather than wrapping around.
+ */
 struct binary_expression final : expression {
     std::unique_ptr<expression> left, right;
     binary_operators op;
 
     evaluate_result evaluate(const module& mod) const noexcept override;
 };
-} // namespace lidl::eval
\ No newline at end of file
+
+struct unary_expression final : expression {
+    std::unique_ptr<expression> operand;
+    unary_operators op;
+
+    evaluate_result evaluate(const module& mod) const noexcept override;
+};
+} // namespace lidl::eval
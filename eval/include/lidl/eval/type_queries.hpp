@@ -0,0 +1,24 @@
+#pragma once
+
+#include <lidl/eval/expression.hpp>
+#include <lidl/module.hpp>
+
+namespace lidl::eval {
+/**
+ * Size of the wire representation of a type in bytes, as laid out in messages.
+ */
+struct sizeof_expression final : expression {
+    name type_name;
+
+    evaluate_result evaluate(const module& mod) const noexcept override;
+};
+
+/**
+ * Alignment of the wire representation of a type in bytes.
+ */
+struct alignof_expression final : expression {
+    name type_name;
+
+    evaluate_result evaluate(const module& mod) const noexcept override;
+};
+} // namespace lidl::eval
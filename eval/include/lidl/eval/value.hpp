@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <functional>
 #include <lidl/basic.hpp>
+#include <string>
 #include <string_view>
 #include <unordered_map>
 #include <variant>
@@ -22,7 +23,7 @@ struct value {
         : m_data(std::string(val)) {
     }
 
-    explicit value(uint64_t val)
+    explicit value(int64_t val)
         : m_data(val) {
     }
 
@@ -59,7 +60,7 @@ struct value {
     }
 
     bool is_integral() const {
-        return std::get_if<uint64_t>(&m_data);
+        return std::get_if<int64_t>(&m_data);
     }
 
     bool is_bool() const {
@@ -78,6 +79,10 @@ struct value {
         return std::get_if<map_t>(&m_data);
     }
 
+    bool is_enum() const {
+        return std::get_if<enum_val_t>(&m_data);
+    }
+
     std::string_view as_string() const noexcept {
         assert(is_string());
         return std::get<std::string>(m_data);
@@ -88,9 +93,9 @@ struct value {
         return std::get<double>(m_data);
     }
 
-    uint64_t as_integral() const noexcept {
+    int64_t as_integral() const noexcept {
         assert(is_integral());
-        return std::get<uint64_t>(m_data);
+        return std::get<int64_t>(m_data);
     }
 
     bool as_bool() const noexcept {
@@ -98,10 +103,17 @@ struct value {
         return std::get<bool>(m_data);
     }
 
+    const enum_val_t& as_enum() const noexcept {
+        assert(is_enum());
+        return std::get<enum_val_t>(m_data);
+    }
+
     friend bool operator==(const value& a, const value& b);
 
+    friend std::string to_string(const value& val);
+
 private:
-    std::variant<std::string, uint64_t, double, bool, fun_t, map_t, vec_t, enum_val_t>
+    std::variant<std::string, int64_t, double, bool, fun_t, map_t, vec_t, enum_val_t>
         m_data;
 };
 
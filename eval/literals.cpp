@@ -1,3 +1,5 @@
+#include <fmt/format.h>
+#include <lidl/eval/constants.hpp>
 #include <lidl/eval/literals.hpp>
 
 namespace lidl::eval {
@@ -8,6 +10,13 @@ evaluate_result name_literal_expression::evaluate(const module& mod) const noexc
         return value(value::enum_val_t{value_name});
     }
 
-    return common_errors{};
+    if (auto c = dynamic_cast<const constant*>(sym_base)) {
+        return evaluate_constant(mod, *c);
+    }
+
+    return common_errors{
+        src_info,
+        fmt::format("{} does not name a constant",
+                    fmt::join(absolute_name(value_name.base), "::"))};
 }
 } // namespace lidl::eval
\ No newline at end of file
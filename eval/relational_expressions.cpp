@@ -1,15 +1,284 @@
+#include <algorithm>
+#include <array>
+#include <fmt/format.h>
+#include <lidl/enumeration.hpp>
 #include <lidl/eval/relational_expressions.hpp>
 
 namespace lidl::eval {
-evaluate_result binary_expression::evaluate(const module& mod) const noexcept {
-    auto left_val  = std::get<value>(left->evaluate(mod));
-    auto right_val = std::get<value>(right->evaluate(mod));
+namespace {
+constexpr std::array<std::pair<std::string_view, binary_operators>, 13> binary_spellings{{
+    {"==", binary_operators::eqeq},
+    {"!=", binary_operators::noteq},
+    {"<", binary_operators::less},
+    {"<=", binary_operators::less_eq},
+    {">", binary_operators::greater},
+    {">=", binary_operators::greater_eq},
+    {"+", binary_operators::add},
+    {"-", binary_operators::sub},
+    {"*", binary_operators::mul},
+    {"/", binary_operators::div},
+    {"%", binary_operators::mod},
+    {"&&", binary_operators::logical_and},
+    {"||", binary_operators::logical_or},
+}};
+
+constexpr std::array<std::pair<std::string_view, unary_operators>, 2> unary_spellings{{
+    {"-", unary_operators::negate},
+    {"!", unary_operators::logical_not},
+}};
+
+common_errors error(const expression& expr, std::string message) {
+    return common_errors{expr.src_info, std::move(message)};
+}
 
+using number = std::variant<int64_t, double>;
+
+/**
+ * Numeric view of a value, where enum values are replaced with their numeric values.
+ */
+std::optional<number> as_number(const value& val) {
+    if (val.is_integral()) {
+        return val.as_integral();
+    }
+    if (val.is_double()) {
+        return val.as_double();
+    }
+    if (val.is_enum()) {
+        auto member = dynamic_cast<const enum_member*>(
+            get_symbol(val.as_enum().enum_value.base));
+        if (member) {
+            return static_cast<int64_t>(member->value);
+        }
+    }
+    return {};
+}
+
+double as_double(const number& num) {
+    return std::visit([](auto x) { return static_cast<double>(x); }, num);
+}
+
+template<class T>
+evaluate_result compare(binary_operators op, T l, T r) {
     switch (op) {
     case binary_operators::eqeq:
-        return value(left_val == right_val);
+        return value(l == r);
+    case binary_operators::noteq:
+        return value(l != r);
+    case binary_operators::less:
+        return value(l < r);
+    case binary_operators::less_eq:
+        return value(l <= r);
+    case binary_operators::greater:
+        return value(l > r);
+    case binary_operators::greater_eq:
+        return value(l >= r);
+    default:
+        return common_errors{};
+    }
+}
+
+evaluate_result
+arithmetic(const expression& expr, binary_operators op, int64_t l, int64_t r) {
+    int64_t res;
+    switch (op) {
+    case binary_operators::add:
+        if (__builtin_add_overflow(l, r, &res)) {
+            return error(expr, "Overflow in constant expression");
+        }
+        return value(res);
+    case binary_operators::sub:
+        if (__builtin_sub_overflow(l, r, &res)) {
+            return error(expr, "Overflow in constant expression");
+        }
+        return value(res);
+    case binary_operators::mul:
+        if (__builtin_mul_overflow(l, r, &res)) {
+            return error(expr, "Overflow in constant expression");
+        }
+        return value(res);
+    case binary_operators::div:
+    case binary_operators::mod:
+        if (r == 0) {
+            return error(expr, "Division by zero in constant expression");
+        }
+        if (l == INT64_MIN && r == -1) {
+            return error(expr, "Overflow in constant expression");
+        }
+        return value(op == binary_operators::div ? l / r : l % r);
+    default:
+        return common_errors{};
+    }
+}
+
+evaluate_result
+arithmetic(const expression& expr, binary_operators op, double l, double r) {
+    switch (op) {
+    case binary_operators::add:
+        return value(l + r);
+    case binary_operators::sub:
+        return value(l - r);
+    case binary_operators::mul:
+        return value(l * r);
+    case binary_operators::div:
+        if (r == 0) {
+            return error(expr, "Division by zero in constant expression");
+        }
+        return value(l / r);
+    default:
+        return error(expr, "Operator % expects integral operands");
+    }
+}
+
+bool is_comparison(binary_operators op) {
+    return op == binary_operators::eqeq || op == binary_operators::noteq ||
+           op == binary_operators::less || op == binary_operators::less_eq ||
+           op == binary_operators::greater || op == binary_operators::greater_eq;
+}
+} // namespace
+
+std::optional<binary_operators> parse_binary_operator(std::string_view spelling) {
+    auto it = std::find_if(binary_spellings.begin(),
+                           binary_spellings.end(),
+                           [&](auto& entry) { return entry.first == spelling; });
+    if (it == binary_spellings.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+std::optional<unary_operators> parse_unary_operator(std::string_view spelling) {
+    auto it = std::find_if(unary_spellings.begin(),
+                           unary_spellings.end(),
+                           [&](auto& entry) { return entry.first == spelling; });
+    if (it == unary_spellings.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+std::string_view to_string(binary_operators op) {
+    return std::find_if(binary_spellings.begin(),
+                        binary_spellings.end(),
+                        [&](auto& entry) { return entry.second == op; })
+        ->first;
+}
+
+std::string_view to_string(unary_operators op) {
+    return std::find_if(unary_spellings.begin(),
+                        unary_spellings.end(),
+                        [&](auto& entry) { return entry.second == op; })
+        ->first;
+}
+
+evaluate_result binary_expression::evaluate(const module& mod) const noexcept {
+    auto left_res = left->evaluate(mod);
+    if (std::holds_alternative<common_errors>(left_res)) {
+        return left_res;
+    }
+    auto& left_val = std::get<value>(left_res);
+
+    if (op == binary_operators::logical_and || op == binary_operators::logical_or) {
+        if (!left_val.is_bool()) {
+            return error(
+                *this,
+                fmt::format("Operator {} expects boolean operands", to_string(op)));
+        }
+
+        // Short circuit like C++ does, the right hand side may only be valid if the
+        // left hand side allows it to be evaluated.
+        if (left_val.as_bool() == (op == binary_operators::logical_or)) {
+            return value(left_val.as_bool());
+        }
+
+        auto right_res = right->evaluate(mod);
+        if (std::holds_alternative<common_errors>(right_res)) {
+            return right_res;
+        }
+        auto& right_val = std::get<value>(right_res);
+        if (!right_val.is_bool()) {
+            return error(
+                *this,
+                fmt::format("Operator {} expects boolean operands", to_string(op)));
+        }
+        return right_val;
+    }
+
+    auto right_res = right->evaluate(mod);
+    if (std::holds_alternative<common_errors>(right_res)) {
+        return right_res;
+    }
+    auto& right_val = std::get<value>(right_res);
+
+    // Values of the same enumeration are compared by identity, everything else that
+    // has a numeric value is compared numerically.
+    if ((op == binary_operators::eqeq || op == binary_operators::noteq) &&
+        left_val.is_enum() && right_val.is_enum()) {
+        return value((left_val == right_val) == (op == binary_operators::eqeq));
+    }
+
+    auto left_num  = as_number(left_val);
+    auto right_num = as_number(right_val);
+
+    if (left_num && right_num) {
+        if (std::holds_alternative<int64_t>(*left_num) &&
+            std::holds_alternative<int64_t>(*right_num)) {
+            auto l = std::get<int64_t>(*left_num);
+            auto r = std::get<int64_t>(*right_num);
+            return is_comparison(op) ? compare(op, l, r) : arithmetic(*this, op, l, r);
+        }
+
+        auto l = as_double(*left_num);
+        auto r = as_double(*right_num);
+        return is_comparison(op) ? compare(op, l, r) : arithmetic(*this, op, l, r);
+    }
+
+    if (is_comparison(op)) {
+        if (left_val.is_string() && right_val.is_string()) {
+            return compare(op, left_val.as_string(), right_val.as_string());
+        }
+
+        if ((op == binary_operators::eqeq || op == binary_operators::noteq) &&
+            left_val.is_bool() && right_val.is_bool()) {
+            return compare(op, left_val.as_bool(), right_val.as_bool());
+        }
+    }
+
+    return error(*this,
+                 fmt::format("Invalid operands to {}: {} and {}",
+                             to_string(op),
+                             to_string(left_val),
+                             to_string(right_val)));
+}
+
+evaluate_result unary_expression::evaluate(const module& mod) const noexcept {
+    auto res = operand->evaluate(mod);
+    if (std::holds_alternative<common_errors>(res)) {
+        return res;
+    }
+    auto& val = std::get<value>(res);
+
+    switch (op) {
+    case unary_operators::logical_not:
+        if (!val.is_bool()) {
+            return error(*this, "Operator ! expects a boolean operand");
+        }
+        return value(!val.as_bool());
+    case unary_operators::negate:
+        if (val.is_double()) {
+            return value(-val.as_double());
+        }
+        if (auto num = as_number(val); num && std::holds_alternative<int64_t>(*num)) {
+            auto x = std::get<int64_t>(*num);
+            if (x == INT64_MIN) {
+                return error(*this, "Overflow in constant expression");
+            }
+            return value(-x);
+        }
+        return error(
+            *this,
+            fmt::format("Operator - expects a numeric operand, got {}", to_string(val)));
     }
 
-    return value(false);
+    return error(*this, "Unknown operator");
 }
 } // namespace lidl::eval
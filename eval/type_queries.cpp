@@ -0,0 +1,48 @@
+#include <fmt/format.h>
+#include <lidl/eval/type_queries.hpp>
+
+namespace lidl::eval {
+namespace {
+/**
+ * Types are queried as they are, even if a member of that type would be stored behind
+ * a pointer. Views have no layout of their own, so they are queried by the type that
+ * represents them in members.
+ */
+const wire_type* find_wire_type(const module& mod, const name& type_name) {
+    if (!is_type(type_name) && !is_view(type_name)) {
+        return nullptr;
+    }
+    if (is_generic(type_name) && type_name.args.empty()) {
+        return nullptr;
+    }
+    if (is_type(type_name)) {
+        if (auto type = dynamic_cast<const wire_type*>(get_type(mod, type_name))) {
+            return type;
+        }
+    }
+    return get_wire_type(mod, type_name);
+}
+
+common_errors not_a_type(const expression& expr, const name& type_name) {
+    return common_errors{
+        expr.src_info,
+        fmt::format("{} is not a type", fmt::join(absolute_name(type_name.base), "::"))};
+}
+} // namespace
+
+evaluate_result sizeof_expression::evaluate(const module& mod) const noexcept {
+    auto type = find_wire_type(mod, type_name);
+    if (!type) {
+        return not_a_type(*this, type_name);
+    }
+    return value(static_cast<int64_t>(type->wire_layout(mod).size()));
+}
+
+evaluate_result alignof_expression::evaluate(const module& mod) const noexcept {
+    auto type = find_wire_type(mod, type_name);
+    if (!type) {
+        return not_a_type(*this, type_name);
+    }
+    return value(static_cast<int64_t>(type->wire_layout(mod).alignment()));
+}
+} // namespace lidl::eval
@@ -1,4 +1,7 @@
+#include <fmt/format.h>
 #include <lidl/eval/value.hpp>
+#include <lidl/scope.hpp>
+
 namespace lidl::eval {
 bool operator==(const value& a, const value& b) {
     return std::visit(
@@ -19,4 +22,24 @@ bool operator==(const value& a, const value& b) {
         a.m_data,
         b.m_data);
 }
+
+std::string to_string(const value& val) {
+    if (val.is_string()) {
+        return fmt::format("\"{}\"", val.as_string());
+    }
+    if (val.is_integral()) {
+        return std::to_string(val.as_integral());
+    }
+    if (val.is_double()) {
+        return fmt::format("{}", val.as_double());
+    }
+    if (val.is_bool()) {
+        return val.as_bool() ? "true" : "false";
+    }
+    if (val.is_enum()) {
+        return fmt::format("{}",
+                           fmt::join(absolute_name(val.as_enum().enum_value.base), "::"));
+    }
+    return "<value>";
+}
 } // namespace lidl::eval
@@ -0,0 +1,84 @@
+#include "service_generated.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/envelope.hpp>
+#include <lidlrt/service.hpp>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using lidl_example::calculator;
+
+// Multiplies by adding, slowly, and gives up once nobody waits for the result anymore.
+class slow_calculator_impl : public calculator::async_server {
+public:
+    tos::Task<double> add(const double& left, const double& right) override {
+        co_return left + right;
+    }
+
+    tos::Task<double> multiply(const double& left, const double& right) override {
+        auto token = co_await tos::current_token();
+        double res = 0;
+        for (int i = 0; i < right; ++i) {
+            if (token.cancelled()) {
+                std::cerr << "multiply gave up after " << i << " steps\n";
+                co_return 0;
+            }
+            std::this_thread::sleep_for(10ms);
+            res += left;
+        }
+        co_return res;
+    }
+};
+
+std::vector<uint8_t> get_request(double left,
+                                 double right,
+                                 const tos::cancellation_token& token) {
+    std::vector<uint8_t> buf(64);
+    lidl::message_builder builder(buf);
+    lidl::create<calculator::wire_types::call_union>(
+        builder, calculator::wire_types::multiply_params(left, right));
+    lidl::attach_envelope(builder, token);
+    buf.resize(builder.size());
+    return buf;
+}
+
+bool run(slow_calculator_impl& impl,
+         std::vector<uint8_t> req,
+         const tos::cancellation_token& token = {}) {
+    auto runner = lidl::make_async_procedure_runner<calculator::async_server>(
+        lidl::interceptor_chain<>{});
+    std::array<uint8_t, 64> resp;
+    lidl::message_builder response(resp);
+    auto task = runner(impl, req, response);
+    // The transport can cancel the calls it runs, when their client disconnects for
+    // instance.
+    task.set_token(token);
+    task.run();
+    return task.value();
+}
+
+int main() {
+    slow_calculator_impl impl;
+    auto in = [](auto duration) {
+        return tos::cancellation_token().with_deadline(std::chrono::steady_clock::now() +
+                                                       duration);
+    };
+
+    auto ok = run(impl, get_request(3, 5, in(1s)));
+    std::cerr << "within the deadline: " << ok << '\n';
+
+    ok = run(impl, get_request(3, 5, in(25ms)));
+    std::cerr << "past the deadline: " << ok << '\n';
+
+    // The deadline passes before the request arrives, so the call is shed.
+    ok = run(impl, get_request(3, 5, in(0ms)));
+    std::cerr << "expired: " << ok << '\n';
+
+    tos::cancellation_source source;
+    source.cancel();
+    ok = run(impl, get_request(3, 5, {}), source.token());
+    std::cerr << "cancelled: " << ok << '\n';
+}
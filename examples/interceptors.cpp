@@ -0,0 +1,145 @@
+#include "service_generated.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/interceptor.hpp>
+#include <lidlrt/service.hpp>
+#include <lidlrt/transport/local.hpp>
+#include <lidlrt/zerocopy_vtable.hpp>
+#include <optional>
+
+using lidl_example::calculator;
+
+class calculator_impl : public calculator::sync_server {
+public:
+    double add(const double& left, const double& right) override {
+        return left + right;
+    }
+
+    double multiply(const double& left, const double& right) override {
+        return left * right;
+    }
+};
+
+class async_calculator_impl : public calculator::async_server {
+public:
+    tos::Task<double> add(const double& left, const double& right) override {
+        co_return left + right;
+    }
+
+    tos::Task<double> multiply(const double& left, const double& right) override {
+        co_return left * right;
+    }
+};
+
+// Prints every call and whether it succeeded.
+struct logger {
+    std::string_view side;
+
+    template<class Info>
+    void after(const Info& info, bool ok) {
+        std::cerr << side << ": " << info.service_name << "::" << info.procedure_name
+                  << (ok ? " succeeded\n" : " failed\n");
+    }
+};
+
+// Measures how long every call takes, passing the start time from before to after.
+struct timer {
+    template<class Info>
+    auto before(const Info&) {
+        return std::optional(std::chrono::steady_clock::now());
+    }
+
+    template<class Info, class StateT>
+    void after(const Info& info, StateT& begin, bool) {
+        auto elapsed = std::chrono::steady_clock::now() - *begin;
+        std::cerr << info.procedure_name << " took "
+                  << std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+                  << "ns\n";
+    }
+};
+
+// Rejects every call once the budget runs out.
+struct rate_limiter {
+    int budget;
+
+    template<class Info>
+    bool before(const Info&) {
+        return budget-- > 0;
+    }
+};
+
+std::vector<uint8_t> get_request(double left, double right) {
+    std::vector<uint8_t> buf(64);
+    lidl::message_builder builder(buf);
+    lidl::create<calculator::wire_types::call_union>(
+        builder, calculator::wire_types::add_params(left, right));
+    lidl::attach_envelope(builder);
+    buf.resize(builder.size());
+    return buf;
+}
+
+// Serves the requests a local_transport receives.
+struct local_server {
+    bool run_message(tos::span<uint8_t> req, lidl::message_builder& response) {
+        return handler(impl, req, response);
+    }
+
+    calculator_impl impl;
+    lidl::typed_procedure_runner_t<calculator::sync_server> handler =
+        lidl::make_procedure_runner<calculator::sync_server>();
+};
+
+// Calls a service in the same address space through its zerocopy vtable.
+struct zerocopy_local {
+    explicit zerocopy_local(lidl::service_base& serv)
+        : m_serv{&serv} {
+    }
+
+    template<int ProcId>
+    bool execute(std::integral_constant<int, ProcId>, const void* params, void* ret) {
+        return vtable[ProcId](*m_serv, params, ret);
+    }
+
+    static constexpr auto vtable = lidl::make_zerocopy_vtable<calculator>();
+    lidl::service_base* m_serv;
+};
+
+int main() {
+    calculator_impl impl;
+
+    auto runner = lidl::make_procedure_runner<calculator::sync_server>(
+        lidl::interceptor_chain(logger{"server"}, timer{}, rate_limiter{2}));
+    for (int i = 0; i < 3; ++i) {
+        auto req = get_request(i, 1);
+        std::array<uint8_t, 64> resp;
+        lidl::message_builder response(resp);
+        if (!runner(impl, req, response)) {
+            std::cerr << "call " << i << " was rejected\n";
+        }
+    }
+
+    async_calculator_impl async_impl;
+    auto async_runner = lidl::make_async_procedure_runner<calculator::async_server>(
+        lidl::interceptor_chain(logger{"async server"}));
+    {
+        auto req = get_request(3, 4);
+        std::array<uint8_t, 64> resp;
+        lidl::message_builder response(resp);
+        auto task = async_runner(async_impl, req, response);
+        task.run();
+    }
+
+    calculator::stub_client<
+        lidl::intercepted_transport<calculator, lidl::local_transport<local_server>, logger>>
+        stub(lidl::interceptor_chain(logger{"stub"}));
+    auto sum = stub.add(2, 3);
+    std::cerr << "stub: 2 + 3 = " << sum << '\n';
+
+    calculator::zerocopy_client<
+        lidl::intercepted_layer<calculator, zerocopy_local, logger, timer>>
+        zerocopy(lidl::interceptor_chain(logger{"zerocopy"}, timer{}), impl);
+    auto product = zerocopy.multiply(2, 3);
+    std::cerr << "zerocopy: 2 * 3 = " << product << '\n';
+}
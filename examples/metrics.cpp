@@ -0,0 +1,62 @@
+#include "service_generated.hpp"
+
+#include <iostream>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/metrics.hpp>
+#include <lidlrt/service.hpp>
+#include <thread>
+#include <vector>
+
+class calculator_impl : public lidl_example::calculator::sync_server {
+public:
+    double add(const double& left, const double& right) override {
+        return left + right;
+    }
+
+    double multiply(const double& left, const double& right) override {
+        return left * right;
+    }
+};
+
+std::vector<uint8_t> get_request(int i) {
+    std::vector<uint8_t> buf(64);
+    lidl::message_builder builder(buf);
+    if (i % 4 == 0) {
+        lidl::create<lidl_example::calculator::wire_types::call_union>(
+            builder, lidl_example::calculator::wire_types::add_params(i, 1));
+    } else {
+        lidl::create<lidl_example::calculator::wire_types::call_union>(
+            builder, lidl_example::calculator::wire_types::multiply_params(i, 2));
+    }
+    lidl::attach_envelope(builder);
+    buf.resize(builder.size());
+    return buf;
+}
+
+int main() {
+    auto handler = lidl::make_procedure_runner<lidl_example::calculator::sync_server>();
+
+    // Every thread records to its own counters, collect() adds them up.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            calculator_impl impl;
+            for (int i = 0; i < 1000; ++i) {
+                auto req = get_request(i);
+                std::array<uint8_t, 64> resp;
+                lidl::message_builder response(resp);
+                handler(impl, req, response);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto snapshot = lidl::metrics::collect();
+    for (auto& proc : snapshot) {
+        std::cerr << proc.service << "::" << proc.procedure << ": " << proc.calls
+                  << " calls, p99 " << proc.latency.value_at_quantile(0.99) << "ns\n";
+    }
+    std::cout << lidl::metrics::format_prometheus(snapshot);
+}
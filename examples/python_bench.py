@@ -0,0 +1,69 @@
+"""
+Compares building and reading messages through the pure python runtime against the
+pybind11 extension lidlc generates for the same schema.
+
+    lidlc -g py -f tests.yaml -o <pure dir>
+    lidlc -g pybind -f tests.yaml -o tests_py.cpp   # built by add_lidlc_python
+    python3 python_bench.py <pure dir> <extension dir>
+
+Both sides are run over the same messages, and each decodes what the other built, so
+the benchmark doubles as a check that the two agree on the wire format.
+"""
+
+import os
+import sys
+import timeit
+
+pure_dir, ext_dir = sys.argv[1], sys.argv[2]
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..", "runtime", "python"))
+sys.path.insert(0, pure_dir)
+sys.path.insert(0, ext_dir)
+
+import lidlrt
+import tests_py
+from module.string_and_vector import string_and_vector
+
+NAME = "benchmark"
+NUMBERS = list(range(1000))
+
+
+def pure_encode():
+    builder = lidlrt.Builder(lidlrt.Memory(bytearray(4096)))
+    name = lidlrt.String.create(builder, NAME)
+    numbers = lidlrt.Vector(lidlrt.U16).create(builder, NUMBERS)
+    builder.create(string_and_vector, name=name, numbers=numbers)
+    return bytes(builder.get())
+
+
+def pure_decode(data):
+    mem = lidlrt.Memory(bytearray(data))
+    mem.set_base(len(data) - string_and_vector.size)
+    msg = string_and_vector.from_memory(mem)
+    return msg.name.value, sum(msg.numbers)
+
+
+def ext_encode():
+    return tests_py.string_and_vector.encode({"name": NAME, "numbers": NUMBERS})
+
+
+def ext_decode(data):
+    msg = tests_py.string_and_vector.from_buffer(data)
+    return msg.name, sum(msg.numbers)
+
+
+expected = (NAME, sum(NUMBERS))
+pure_data = pure_encode()
+ext_data = ext_encode()
+assert pure_decode(pure_data) == expected
+assert ext_decode(pure_data) == expected
+assert pure_decode(ext_data) == expected
+assert ext_decode(ext_data) == expected
+
+runs = 200
+results = {}
+for name, fn in [("encode", (pure_encode, ext_encode)),
+                 ("decode", (lambda: pure_decode(pure_data), lambda: ext_decode(ext_data)))]:
+    pure_time = min(timeit.repeat(fn[0], number=runs, repeat=3)) / runs
+    ext_time = min(timeit.repeat(fn[1], number=runs, repeat=3)) / runs
+    print(f"{name}: pure {pure_time * 1e6:9.1f}us  extension {ext_time * 1e6:9.1f}us  "
+          f"{pure_time / ext_time:6.1f}x")
@@ -0,0 +1,24 @@
+use std::env;
+use std::path::PathBuf;
+use std::process::Command;
+
+// Generates the bindings for strings.yaml, and for union.yaml which the tests use, with
+// lidlc, which is looked up in the LIDLC environment variable first and in the PATH
+// otherwise.
+fn main() {
+    let lidlc = env::var("LIDLC").unwrap_or_else(|_| "lidlc".to_string());
+    let out_dir = PathBuf::from(env::var("OUT_DIR").unwrap());
+
+    for name in &["strings", "union"] {
+        let schema = format!("../../{}.yaml", name);
+        let status = Command::new(&lidlc)
+            .args(&["-g", "rs", "-f", &schema, "-o"])
+            .arg(out_dir.join(format!("{}.rs", name)))
+            .status()
+            .expect("could not run lidlc");
+        assert!(status.success(), "lidlc failed on {}", schema);
+
+        println!("cargo:rerun-if-changed={}", schema);
+    }
+    println!("cargo:rerun-if-env-changed=LIDLC");
+}
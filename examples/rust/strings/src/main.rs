@@ -1,9 +1,103 @@
-use lidl;
+mod strings {
+    include!(concat!(env!("OUT_DIR"), "/strings.rs"));
+}
+
+use strings::module::person;
+
+// Messages are read in place, so the buffer must be aligned for the objects in it.
+#[repr(align(8))]
+struct Buffer([u8; 128]);
 
 fn main() {
-    let mut buf : [u8; 128] = [0; 128];
-    let mut mb = lidl::MessageBuilder::new(&mut buf);
+    let mut buf = Buffer([0; 128]);
+    let mut mb = lidl::MessageBuilder::new(&mut buf.0);
+
+    let name = mb.create_string("hello").unwrap();
+    let surname = mb.create_string("rust").unwrap();
+    person::create(&mut mb, name, surname).unwrap();
+
+    let p = lidl::get_root::<person>(mb.get_buffer()).expect("malformed message");
+    println!("Lidl person: {} {}", p.name.get(), p.surname.get().get());
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    // Only some of the generated types are used.
+    #[allow(dead_code)]
+    mod unions {
+        include!(concat!(env!("OUT_DIR"), "/union.rs"));
+    }
+
+    use unions::module::{procedures, procedures_alternatives};
+
+    fn build_person(buf: &mut Buffer) -> usize {
+        let mut mb = lidl::MessageBuilder::new(&mut buf.0);
+        let name = mb.create_string("hello").unwrap();
+        let surname = mb.create_string("rust").unwrap();
+        person::create(&mut mb, name, surname).unwrap();
+        mb.size()
+    }
+
+    #[test]
+    fn person_round_trip() {
+        let mut buf = Buffer([0; 128]);
+        let size = build_person(&mut buf);
+
+        let p = lidl::get_root::<person>(&buf.0[..size]).unwrap();
+        assert_eq!("hello", p.name.get().get());
+        assert_eq!("rust", p.surname.get().get());
+    }
+
+    #[test]
+    fn person_rejects_bad_pointers() {
+        let mut buf = Buffer([0; 128]);
+        let size = build_person(&mut buf);
+        let root = size - core::mem::size_of::<person>();
+
+        // The name points to itself, which is a null pointer.
+        let mut null = Buffer(buf.0);
+        null.0[root..root + 2].copy_from_slice(&0i16.to_le_bytes());
+        assert!(lidl::get_root::<person>(&null.0[..size]).is_none());
+
+        // The surname points before the start of the message.
+        let mut before = Buffer(buf.0);
+        before.0[root + 2..root + 4].copy_from_slice(&1000i16.to_le_bytes());
+        assert!(lidl::get_root::<person>(&before.0[..size]).is_none());
+
+        // The message is cut before the strings end.
+        assert!(lidl::get_root::<person>(&buf.0[root..size]).is_none());
+    }
+
+    #[test]
+    fn union_round_trip() {
+        let mut buf = Buffer([0; 128]);
+        let mut mb = lidl::MessageBuilder::new(&mut buf.0);
+        procedures::create_x(&mut mb, -5).unwrap();
+        let p = lidl::get_root::<procedures>(mb.get_buffer()).unwrap();
+        assert_eq!(procedures_alternatives::x, p.alternative());
+        assert_eq!(Some(&-5), p.x());
+        assert!(p.y().is_none());
+
+        let mut buf = Buffer([0; 128]);
+        let mut mb = lidl::MessageBuilder::new(&mut buf.0);
+        let s = mb.create_string("why").unwrap();
+        procedures::create_y(&mut mb, s).unwrap();
+        let p = lidl::get_root::<procedures>(mb.get_buffer()).unwrap();
+        assert_eq!(procedures_alternatives::y, p.alternative());
+        assert_eq!("why", p.y().unwrap().get().get());
+        assert!(p.x().is_none());
+    }
+
+    #[test]
+    fn union_rejects_unknown_alternatives() {
+        let mut buf = Buffer([0; 128]);
+        let mut mb = lidl::MessageBuilder::new(&mut buf.0);
+        procedures::create_x(&mut mb, 1).unwrap();
+        let size = mb.size();
 
-    let ostr = lidl::String::new(&mut mb, "hello rust");
-    println!("Lidl string: {}", ostr.get());
+        buf.0[size - core::mem::size_of::<procedures>()] = 2;
+        assert!(lidl::get_root::<procedures>(&buf.0[..size]).is_none());
+    }
 }
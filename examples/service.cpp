@@ -47,6 +47,7 @@ std::vector<uint8_t> get_request() {
     lidl::message_builder builder(buf);
     lidl::create<lidl_example::scientific_calculator::wire_types::call_union>(
         builder, lidl_example::calculator::wire_types::multiply_params(3, 5));
+    lidl::attach_envelope(builder);
     buf.resize(builder.size());
     return buf;
 }
@@ -58,6 +59,7 @@ std::vector<uint8_t> get_echo_req() {
         builder,
         lidl::create<lidl_example::repeat::wire_types::echo_params>(
             builder, lidl::create_string(builder, "foobar")));
+    lidl::attach_envelope(builder);
     buf.resize(builder.size());
     return buf;
 }
@@ -84,9 +86,12 @@ int main(int argc, char** argv) {
     // std::istream_iterator<uint8_t>{});
     auto req = get_request();
     //    std::cout.write((const char*)req.data(), req.size());
+    tos::span<uint8_t> payload = req;
+    lidl::extract_envelope(payload);
     std::cout << lidl::nameof(
                      lidl::get_root<
-                         lidl_example::scientific_calculator::wire_types::call_union>(req)
+                         lidl_example::scientific_calculator::wire_types::call_union>(
+                         payload)
                          .alternative())
               << '\n';
 
@@ -16,4 +16,13 @@ int main() {
               << p.surname().string_view() << '\n';
 
     std::cout << "message took " << builder.size() << " bytes\n";
-}
\ No newline at end of file
+
+    lidl::json::output out;
+    auto json = lidl::json::write(out, p);
+    std::cout << json << '\n';
+
+    std::array<uint8_t, 64> y;
+    lidl::message_builder json_builder(y);
+    auto parsed = lidl::json::parse<module::person>(json, json_builder);
+    std::cout << "round trip " << (parsed && *parsed == p ? "matches" : "differs") << '\n';
+}
@@ -0,0 +1,79 @@
+#include "service_generated.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <lidlrt/service.hpp>
+#include <lidlrt/tracing.hpp>
+#include <lidlrt/transport/local.hpp>
+
+using lidl_example::calculator;
+using lidl_example::scientific_calculator;
+
+class calculator_impl : public calculator::sync_server {
+public:
+    double add(const double& left, const double& right) override {
+        return left + right;
+    }
+
+    double multiply(const double& left, const double& right) override {
+        return left * right;
+    }
+};
+
+// Serves the requests a local_transport receives with the given implementation.
+template<class ServiceT, class ImplT>
+struct local_server {
+    bool run_message(tos::span<uint8_t> req, lidl::message_builder& response) {
+        return handler(impl, req, response);
+    }
+
+    ImplT impl;
+    lidl::typed_procedure_runner_t<typename ServiceT::sync_server> handler =
+        lidl::make_procedure_runner<typename ServiceT::sync_server>();
+};
+
+using calculator_client =
+    calculator::stub_client<lidl::local_transport<local_server<calculator, calculator_impl>>>;
+
+// Forwards the arithmetic to another service, so that every call makes a second hop.
+class scientific_calculator_impl : public scientific_calculator::sync_server {
+public:
+    double add(const double& left, const double& right) override {
+        return m_backend.add(left, right);
+    }
+
+    double multiply(const double& left, const double& right) override {
+        return m_backend.multiply(left, right);
+    }
+
+    double log(const double& val) override {
+        return std::log(val);
+    }
+
+private:
+    calculator_client m_backend;
+};
+
+int main() {
+    lidl::tracing::ring_buffer_exporter spans(16);
+    lidl::tracing::set_exporter(&spans);
+
+    scientific_calculator::stub_client<lidl::local_transport<
+        local_server<scientific_calculator, scientific_calculator_impl>>>
+        client;
+    std::cerr << "3 * 5 = " << client.multiply(3, 5) << '\n';
+    std::cerr << "log(1) = " << client.log(1) << '\n';
+
+    // The backend call ends first, so it's exported before its parent.
+    for (auto& span : spans.spans()) {
+        std::cerr << span.service << "::" << span.procedure << " span " << std::hex
+                  << span.span << " parent " << span.parent << std::dec << " took "
+                  << span.duration.count() << "ns\n";
+    }
+
+    lidl::tracing::file_exporter file(stdout);
+    lidl::tracing::set_exporter(&file);
+    client.add(1, 2);
+    lidl::tracing::set_exporter(nullptr);
+}
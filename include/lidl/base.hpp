@@ -21,6 +21,7 @@ public:
         queue,
         other,
         enum_member,
+        constant,
     };
 
     explicit base(categories category,
@@ -32,8 +32,8 @@ public:
 
 private:
     explicit symbol_handle(scope& s, int id);
-    int m_id = 0;
-    scope* m_scope;
+    int m_id       = 0;
+    scope* m_scope = nullptr;
     friend class scope;
     friend bool operator==(const symbol_handle& left, const symbol_handle& right) {
         return left.m_scope == right.m_scope && left.m_id == right.m_id;
@@ -86,6 +86,15 @@ struct generic_argument : std::variant<name, int64_t> {
 
 bool operator==(const symbol_handle& left, const symbol_handle& right);
 bool operator==(const name&, const name&);
+
+/**
+ * Structural hash of a name, covers the base symbol and all generic arguments
+ * recursively. Equal names always hash to the same value.
+ */
+struct name_hash {
+    size_t operator()(const name& n) const noexcept;
+};
+
 const base* resolve(const module& mod, const name&);
 const type* get_type(const module& mod, const name&);
 name get_wire_type_name(const module& mod, const name& n);
@@ -103,6 +112,12 @@ const Type* get_type(const module& mod, const name& n) {
 
 const wire_type* get_wire_type(const module& mod, const name& n);
 
+/**
+ * Returns the type a reference type is stored as out of line, i.e. the pointee of its
+ * wire type. For instance, returns `string` for both `string` and `ptr<string>`.
+ */
+const type* get_pointee_type(const module& mod, const name& n);
+
 struct procedure_params_info {
     const service* serv;
     std::string proc_name;
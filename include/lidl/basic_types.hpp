@@ -1,6 +1,8 @@
 #pragma once
 #include "generics.hpp"
 
+#include <charconv>
+
 namespace lidl {
 struct array_type : generic_wire_type {
     array_type(module& mod);
@@ -24,33 +26,12 @@ struct array_type : generic_wire_type {
 
     YAML::Node bin2yaml(const module& mod,
                         const name& instantiation,
-                        ibinary_reader& span) const override {
-        throw std::runtime_error("Not implemented!");
-        //
-        //        YAML::Node arr;
-        //        auto& arg = std::get<name>(instantiation.arguments()[0]);
-        //        if (auto pointee = get_type(mod, arg); pointee) {
-        //            auto layout = pointee->wire_layout(mod);
-        //            auto len    = std::get<int64_t>(instantiation.arguments()[1]);
-        //
-        //            for (int i = 0; i < len; ++i) {
-        //                auto obj_span =
-        //                    span.subspan(0, span.size() - (len - i - 1) *
-        //                    layout.size());
-        //                auto [yaml, consumed] = pointee->bin2yaml(mod, obj_span);
-        //                arr.push_back(std::move(yaml));
-        //            }
-        //
-        //            return {std::move(arr), layout.size() * len};
-        //        }
-        //
-        //        throw std::runtime_error("pointee must be a regular type");
-    }
+                        binary_reader& reader) const override;
 
     int yaml2bin(const module& mod,
                  const name& instantiation,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override {
+                 binary_writer& writer) const override {
         auto& len = std::get<int64_t>(instantiation.args[1]);
         if (len != node.size()) {
             throw std::runtime_error("Array sizes do not match!");
@@ -67,6 +48,16 @@ struct array_type : generic_wire_type {
         return pos;
     }
 
+    void bin2json(const module& mod,
+                  const name& instantiation,
+                  binary_reader& reader,
+                  json_writer& writer) const override;
+
+    int json2bin(const module& mod,
+                 const name& instantiation,
+                 const json_value& value,
+                 binary_writer& writer) const override;
+
     name get_wire_type_name_impl(const module& mod, const name& your_name) const override;
 };
 
@@ -92,10 +83,16 @@ struct bool_type : basic_type {
         : basic_type(1) {
     }
 
-    YAML::Node bin2yaml(const module& module, ibinary_reader& reader) const override;
+    YAML::Node bin2yaml(const module& module, binary_reader& reader) const override;
     int yaml2bin(const module& mod,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override;
+                 binary_writer& writer) const override;
+    void bin2json(const module& mod,
+                  binary_reader& reader,
+                  json_writer& writer) const override;
+    int json2bin(const module& mod,
+                 const json_value& value,
+                 binary_writer& writer) const override;
 };
 
 struct integral_type : basic_type {
@@ -104,45 +101,71 @@ struct integral_type : basic_type {
         , is_unsigned(unsigned_) {
     }
 
-    YAML::Node bin2yaml(const module& mod, ibinary_reader& reader) const override {
-        auto layout = wire_layout(mod);
-        auto data   = reader.read_bytes(layout.size());
+    YAML::Node bin2yaml(const module& mod, binary_reader& reader) const override {
+        // YAML::Node formats integers through a stringstream, which dominates the
+        // conversion, so we format them ourselves.
+        char buf[24];
+        std::to_chars_result res;
         if (is_unsigned) {
-            uint64_t x{0};
-            memcpy(reinterpret_cast<char*>(&x), data.data(), data.size());
-            return YAML::Node(x);
+            res = std::to_chars(std::begin(buf), std::end(buf), read_unsigned(mod, reader));
         } else {
-            int64_t x{0};
-            memcpy(reinterpret_cast<char*>(&x), data.data(), data.size());
-            return YAML::Node(x);
+            res = std::to_chars(std::begin(buf), std::end(buf), read_signed(mod, reader));
         }
+        return YAML::Node(std::string(buf, res.ptr));
     }
 
     int yaml2bin(const module& mod,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override {
+                 binary_writer& writer) const override {
         if (is_unsigned) {
             auto data   = node.as<uint64_t>();
             auto layout = wire_layout(mod);
-            std::vector<char> buf(layout.size());
-            memcpy(buf.data(), &data, layout.size());
             writer.align(layout.alignment());
             auto pos = writer.tell();
-            writer.write_raw(buf);
+            writer.write_raw({reinterpret_cast<const char*>(&data), size_t(layout.size())});
             return pos;
         } else {
             auto data   = node.as<int64_t>();
             auto layout = wire_layout(mod);
-            std::vector<char> buf(layout.size());
-            memcpy(buf.data(), &data, layout.size());
             writer.align(layout.alignment());
             auto pos = writer.tell();
-            writer.write_raw(buf);
+            writer.write_raw({reinterpret_cast<const char*>(&data), size_t(layout.size())});
             return pos;
         }
     }
 
+    void bin2json(const module& mod,
+                  binary_reader& reader,
+                  json_writer& writer) const override {
+        if (is_unsigned) {
+            writer.value(read_unsigned(mod, reader));
+        } else {
+            writer.value(read_signed(mod, reader));
+        }
+    }
+
+    int json2bin(const module& mod,
+                 const json_value& value,
+                 binary_writer& writer) const override;
+
     bool is_unsigned;
+
+private:
+    uint64_t read_unsigned(const module& mod, binary_reader& reader) const {
+        auto data = reader.read_bytes(wire_layout(mod).size());
+        uint64_t x{0};
+        memcpy(reinterpret_cast<char*>(&x), data.data(), data.size());
+        return x;
+    }
+
+    int64_t read_signed(const module& mod, binary_reader& reader) const {
+        auto data = reader.read_bytes(wire_layout(mod).size());
+        int64_t x{0};
+        memcpy(reinterpret_cast<char*>(&x), data.data(), data.size());
+        // Sign extend values narrower than 64 bits.
+        auto shift = 64 - 8 * data.size();
+        return static_cast<int64_t>(static_cast<uint64_t>(x) << shift) >> shift;
+    }
 };
 
 struct float_type : basic_type {
@@ -150,18 +173,28 @@ struct float_type : basic_type {
         : basic_type(32) {
     }
 
-    YAML::Node bin2yaml(const module& mod, ibinary_reader& reader) const override {
+    YAML::Node bin2yaml(const module& mod, binary_reader& reader) const override {
         return YAML::Node(reader.read_object<float>());
     }
 
     int yaml2bin(const module& module,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override {
+                 binary_writer& writer) const override {
         writer.align(4);
         auto pos = writer.tell();
         writer.write(node.as<float>());
         return pos;
     }
+
+    void bin2json(const module& mod,
+                  binary_reader& reader,
+                  json_writer& writer) const override {
+        writer.value(reader.read_object<float>());
+    }
+
+    int json2bin(const module& mod,
+                 const json_value& value,
+                 binary_writer& writer) const override;
 };
 
 struct double_type : basic_type {
@@ -169,26 +202,44 @@ struct double_type : basic_type {
         : basic_type(64) {
     }
 
-    YAML::Node bin2yaml(const module& mod, ibinary_reader& reader) const override {
+    YAML::Node bin2yaml(const module& mod, binary_reader& reader) const override {
         return YAML::Node(reader.read_object<double>());
     }
 
     int yaml2bin(const module& module,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override {
+                 binary_writer& writer) const override {
         writer.align(8);
         auto pos = writer.tell();
         writer.write(node.as<double>());
         return pos;
     }
+
+    void bin2json(const module& mod,
+                  binary_reader& reader,
+                  json_writer& writer) const override {
+        writer.value(reader.read_object<double>());
+    }
+
+    int json2bin(const module& mod,
+                 const json_value& value,
+                 binary_writer& writer) const override;
 };
 
 struct string_type : reference_type {
-    YAML::Node bin2yaml(const module&, ibinary_reader& span) const override;
+    YAML::Node bin2yaml(const module&, binary_reader& span) const override;
 
     int yaml2bin(const module& module,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override;
+                 binary_writer& writer) const override;
+
+    void bin2json(const module& mod,
+                  binary_reader& reader,
+                  json_writer& writer) const override;
+
+    int json2bin(const module& mod,
+                 const json_value& value,
+                 binary_writer& writer) const override;
 };
 
 struct vector_type : generic_reference_type {
@@ -196,12 +247,22 @@ struct vector_type : generic_reference_type {
 
     YAML::Node bin2yaml(const module& mod,
                         const name& instantiation,
-                        ibinary_reader& span) const override;
+                        binary_reader& span) const override;
 
     int yaml2bin(const module& mod,
                  const name& instantiation,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override;
+                 binary_writer& writer) const override;
+
+    void bin2json(const module& mod,
+                  const name& instantiation,
+                  binary_reader& reader,
+                  json_writer& writer) const override;
+
+    int json2bin(const module& mod,
+                 const name& instantiation,
+                 const json_value& value,
+                 binary_writer& writer) const override;
 
     name get_wire_type_name_impl(const module& mod, const name& your_name) const override;
 };
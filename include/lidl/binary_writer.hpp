@@ -1,39 +1,96 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <gsl/span>
+#include <ios>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
 #include <vector>
-#include <cstdint>
-#include <cstddef>
 
 namespace lidl {
-struct ibinary_writer {
-    template <class T>
+/**
+ * Accumulates the binary representation of a message in memory.
+ *
+ * Every write appends to a single contiguous buffer, so writes and alignment are plain
+ * buffer operations rather than byte by byte calls.
+ */
+class binary_writer final {
+public:
+    binary_writer() = default;
+
+    explicit binary_writer(size_t capacity_hint) {
+        m_data.reserve(capacity_hint);
+    }
+
+    template<class T>
     void write(const T& t) {
+        static_assert(std::is_trivially_copyable_v<T>);
         write_raw({reinterpret_cast<const char*>(&t), sizeof t});
     }
 
     void write_raw_string(std::string_view str) {
-        write_raw({str.data(), ptrdiff_t(str.size())});
+        write_raw({str.data(), str.size()});
+    }
+
+    void write_raw(gsl::span<const char> data) {
+        auto pos = m_data.size();
+        m_data.resize(pos + data.size());
+        memcpy(m_data.data() + pos, data.data(), data.size());
     }
 
+    /**
+     * Pads the buffer with zeroes until its size is a multiple of the given alignment.
+     */
     void align(int alignment) {
-        while((tell() % alignment) != 0) {
-            char c = 0;
-            write(c);
+        auto padding = (alignment - tell() % alignment) % alignment;
+        m_data.resize(m_data.size() + padding);
+    }
+
+    /**
+     * Pads the buffer with zeroes until its size is at least the given position.
+     */
+    void pad_to(int pos) {
+        if (tell() < pos) {
+            m_data.resize(pos);
         }
     }
 
-    virtual int tell() = 0;
-    virtual void write_raw(gsl::span<const char> data) = 0;
-    virtual ~ibinary_writer() = default;
+    [[nodiscard]] int tell() const {
+        return static_cast<int>(m_data.size());
+    }
+
+    [[nodiscard]] gsl::span<const uint8_t> get() const {
+        return {m_data.data(), m_data.size()};
+    }
+
+private:
+    std::vector<uint8_t> m_data;
 };
 
-struct ibinary_reader {
-    virtual void seek(int bytes, std::ios::seekdir dir) = 0;
+/**
+ * Reads objects out of a serialized message in memory.
+ *
+ * Since lidl messages are read from their end, the reader starts at the end of the
+ * buffer. Reads do not advance the position, callers seek explicitly. Reading past
+ * either end of the buffer throws std::out_of_range.
+ */
+class binary_reader final {
+public:
+    explicit binary_reader(gsl::span<const uint8_t> data)
+        : m_data{data}
+        , m_loc(static_cast<int>(data.size())) {
+    }
 
-    void align(int alignment) {
-        while(tell() % alignment != 0) {
-            seek(1);
+    void seek(int bytes, std::ios::seekdir dir) {
+        if (dir == std::ios::cur) {
+            m_loc += bytes;
+        } else if (dir == std::ios::beg) {
+            m_loc = bytes;
+        } else {
+            m_loc = static_cast<int>(m_data.size()) - bytes;
         }
     }
 
@@ -41,26 +98,35 @@ struct ibinary_reader {
         seek(bytes, std::ios::cur);
     }
 
-    virtual int tell() = 0;
+    void align(int alignment) {
+        m_loc += (alignment - m_loc % alignment) % alignment;
+    }
+
+    [[nodiscard]] int tell() const {
+        return m_loc;
+    }
 
-    template <class T>
-    T read_object() {
+    template<class T>
+    T read_object() const {
         static_assert(std::is_trivially_copyable_v<T>);
-        uint8_t data[sizeof(T)];
-        read(data);
         T t;
-        memcpy(&t, data, sizeof t);
+        memcpy(&t, read_bytes(sizeof t).data(), sizeof t);
         return t;
     }
 
-    std::vector<uint8_t> read_bytes(int bytes) {
-        std::vector<uint8_t> data(bytes);
-        read(data);
-        return data;
+    /**
+     * Returns a view of the given number of bytes at the current position without
+     * copying them. The view is valid as long as the underlying buffer is.
+     */
+    [[nodiscard]] gsl::span<const uint8_t> read_bytes(int bytes) const {
+        if (m_loc < 0 || bytes < 0 || size_t(m_loc) + bytes > m_data.size()) {
+            throw std::out_of_range("Read past the end of the message");
+        }
+        return m_data.subspan(m_loc, bytes);
     }
 
-    virtual gsl::span<uint8_t> read(gsl::span<uint8_t>) = 0;
-
-    virtual ~ibinary_reader() = default;
+private:
+    gsl::span<const uint8_t> m_data;
+    int m_loc;
 };
-}
\ No newline at end of file
+} // namespace lidl
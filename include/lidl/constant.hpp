@@ -0,0 +1,22 @@
+#pragma once
+
+#include <lidl/base.hpp>
+#include <lidl/basic.hpp>
+#include <memory>
+
+namespace lidl::eval {
+struct expression;
+}
+
+namespace lidl {
+/**
+ * A named constant, `const name: type = value;`. The value is evaluated by the eval
+ * library when it's used, and converted to the declared type.
+ */
+struct constant : public cbase<base::categories::constant> {
+    using cbase::cbase;
+
+    name type;
+    std::shared_ptr<const eval::expression> value;
+};
+} // namespace lidl
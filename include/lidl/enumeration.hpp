@@ -74,11 +74,11 @@ public:
         return it->second->value;
     }
 
-    YAML::Node bin2yaml(const module& mod, ibinary_reader& reader) const override;
+    YAML::Node bin2yaml(const module& mod, binary_reader& reader) const override;
 
     int yaml2bin(const module& mod,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override {
+                 binary_writer& writer) const override {
         auto val        = node.as<int64_t>();
         auto underlying = get_type<wire_type>(mod, underlying_type);
         writer.align(underlying->wire_layout(mod).alignment());
@@ -87,6 +87,25 @@ public:
         return pos;
     }
 
+    void bin2json(const module& mod,
+                  binary_reader& reader,
+                  json_writer& writer) const override;
+
+    /**
+     * Enumerations are written by the name of their members, but plain integers are
+     * accepted as well.
+     */
+    int json2bin(const module& mod,
+                 const json_value& value,
+                 binary_writer& writer) const override;
+
+    /**
+     * Reads the integral value of an enumeration without mapping it to a member.
+     */
+    int64_t read_value(const module& mod, binary_reader& reader) const;
+
+    int write_value(const module& mod, int64_t value, binary_writer& writer) const;
+
 private:
 };
 } // namespace lidl
\ No newline at end of file
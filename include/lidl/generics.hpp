@@ -10,6 +10,7 @@
 #include <lidl/scope.hpp>
 #include <lidl/union.hpp>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace lidl {
@@ -96,12 +97,22 @@ struct generic_type : basic_generic {
 
     virtual YAML::Node bin2yaml(const module& mod,
                                 const name& instantiation,
-                                ibinary_reader& reader) const = 0;
+                                binary_reader& reader) const = 0;
 
     virtual int yaml2bin(const module& mod,
                          const name& instantiation,
                          const YAML::Node& node,
-                         ibinary_writer& writer) const = 0;
+                         binary_writer& writer) const = 0;
+
+    virtual void bin2json(const module& mod,
+                          const name& instantiation,
+                          binary_reader& reader,
+                          json_writer& writer) const = 0;
+
+    virtual int json2bin(const module& mod,
+                         const name& instantiation,
+                         const json_value& value,
+                         binary_writer& writer) const = 0;
 
     virtual type_categories category(const module& mod,
                                      const name& instantiation) const = 0;
@@ -123,34 +134,79 @@ struct generic_wire_type : generic_type {
 struct instance_based_wire_type : generic_wire_type {
     using generic_wire_type::generic_wire_type;
 
-    raw_layout wire_layout(const module& mod, const name& instantiation) const override {
-        return instantiate(mod, instantiation)->wire_layout(mod);
-    }
+    raw_layout wire_layout(const module& mod, const name& instantiation) const override;
 
     YAML::Node bin2yaml(const module& mod,
                         const name& instantiation,
-                        ibinary_reader& span) const override {
-        return instantiate(mod, instantiation)->bin2yaml(mod, span);
+                        binary_reader& span) const override {
+        return get_instance(mod, instantiation).bin2yaml(mod, span);
     }
 
     int yaml2bin(const module& mod,
                  const name& instantiation,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override {
-        return instantiate(mod, instantiation)->yaml2bin(mod, node, writer);
+                 binary_writer& writer) const override {
+        return get_instance(mod, instantiation).yaml2bin(mod, node, writer);
+    }
+
+    void bin2json(const module& mod,
+                  const name& instantiation,
+                  binary_reader& reader,
+                  json_writer& writer) const override {
+        get_instance(mod, instantiation).bin2json(mod, reader, writer);
+    }
+
+    int json2bin(const module& mod,
+                 const name& instantiation,
+                 const json_value& value,
+                 binary_writer& writer) const override {
+        return get_instance(mod, instantiation).json2bin(mod, value, writer);
     }
 
     type_categories category(const module& mod,
                              const name& instantiation) const override {
-        return instantiate(mod, instantiation)->category(mod);
+        return get_instance(mod, instantiation).category(mod);
     }
 
     name get_wire_type_name_impl(const module& mod, const name& instantiation) const override {
-        return instantiate(mod, instantiation)->get_wire_type_name_impl(mod, instantiation);
+        return get_instance(mod, instantiation).get_wire_type_name_impl(mod, instantiation);
     }
 
+    /**
+     * Returns the instantiation of this generic with the given arguments.
+     *
+     * Instantiations are memoized per module, so every use of the same arguments
+     * shares a single instantiated type and its layout.
+     */
+    const wire_type& get_instance(const module& mod, const name& instantiation) const;
+
     virtual std::unique_ptr<wire_type> instantiate(const module& mod,
                                                    const name& instantiation) const = 0;
+
+private:
+    struct instance_key {
+        const module* mod;
+        name instantiation;
+
+        friend bool operator==(const instance_key&, const instance_key&) = default;
+    };
+
+    struct instance_key_hash {
+        size_t operator()(const instance_key& key) const noexcept {
+            return std::hash<const module*>{}(key.mod) ^
+                   (name_hash{}(key.instantiation) << 1);
+        }
+    };
+
+    struct cached_instance {
+        std::unique_ptr<wire_type> type;
+        std::optional<raw_layout> layout;
+    };
+
+    cached_instance& get_cached(const module& mod, const name& instantiation) const;
+
+    mutable std::unordered_map<instance_key, cached_instance, instance_key_hash>
+        m_instances;
 };
 
 struct generic_view_type : basic_generic {
@@ -209,11 +265,31 @@ struct pointer_type : generic_wire_type {
     int yaml2bin(const module& mod,
                  const name& instantiation,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override;
+                 binary_writer& writer) const override;
 
     YAML::Node bin2yaml(const module& mod,
                         const name& instantiation,
-                        ibinary_reader& span) const override;
+                        binary_reader& span) const override;
+
+    void bin2json(const module& mod,
+                  const name& instantiation,
+                  binary_reader& reader,
+                  json_writer& writer) const override;
+
+    /**
+     * Like yaml2bin, the value of a pointer is the position of its already written
+     * pointee.
+     */
+    int json2bin(const module& mod,
+                 const name& instantiation,
+                 const json_value& value,
+                 binary_writer& writer) const override;
+
+    /**
+     * Writes a pointer to the object at the given position, returns the position of the
+     * pointer.
+     */
+    static int write(binary_writer& writer, int pointee_pos);
 
     name get_wire_type_name_impl(const module& mod, const name& instantiation) const override {
         return instantiation;
@@ -267,15 +343,27 @@ struct generic_reference_type_instantiation
         return get_generic()->get_wire_type_name_impl(mod, args);
     }
 
-    YAML::Node bin2yaml(const module& module, ibinary_reader& reader) const override {
+    YAML::Node bin2yaml(const module& module, binary_reader& reader) const override {
         return this->get_generic()->bin2yaml(module, args, reader);
     }
 
     int yaml2bin(const module& mod,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override {
+                 binary_writer& writer) const override {
         return this->get_generic()->yaml2bin(mod, args, node, writer);
     }
+
+    void bin2json(const module& module,
+                  binary_reader& reader,
+                  json_writer& writer) const override {
+        this->get_generic()->bin2json(module, args, reader, writer);
+    }
+
+    int json2bin(const module& mod,
+                 const json_value& value,
+                 binary_writer& writer) const override {
+        return this->get_generic()->json2bin(mod, args, value, writer);
+    }
 };
 
 struct generic_wire_type_instantiation
@@ -289,9 +377,15 @@ struct generic_wire_type_instantiation
 
     type_categories category(const module& mod) const override;
     raw_layout wire_layout(const module& mod) const override;
-    YAML::Node bin2yaml(const module& module, ibinary_reader& reader) const override;
+    YAML::Node bin2yaml(const module& module, binary_reader& reader) const override;
     int yaml2bin(const module& mod,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override;
+                 binary_writer& writer) const override;
+    void bin2json(const module& module,
+                  binary_reader& reader,
+                  json_writer& writer) const override;
+    int json2bin(const module& mod,
+                 const json_value& value,
+                 binary_writer& writer) const override;
 };
 } // namespace lidl
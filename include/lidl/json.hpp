@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstdint>
+#include <lidl/errors.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lidl {
+class json_error : public error {
+public:
+    using error::error;
+};
+
+/**
+ * Writes JSON text straight into a string as values are produced, without building a
+ * document first.
+ *
+ * The writer only keeps track of whether a separator is needed, it's up to the caller
+ * to balance objects and arrays and to emit a key before every value in an object.
+ */
+class json_writer {
+public:
+    explicit json_writer(std::string& out)
+        : m_out{&out} {
+    }
+
+    void begin_object();
+    void end_object();
+    void begin_array();
+    void end_array();
+
+    void key(std::string_view key);
+
+    void value(std::string_view str);
+    void value(const char* str) {
+        value(std::string_view(str));
+    }
+    void value(bool b);
+    void value(int64_t i);
+    void value(uint64_t i);
+    void value(float f);
+    void value(double d);
+    void null();
+
+private:
+    void separate() {
+        if (m_need_comma) {
+            m_out->push_back(',');
+        }
+    }
+
+    void write_string(std::string_view str);
+
+    std::string* m_out;
+    bool m_need_comma = false;
+};
+
+enum class json_kind : uint8_t
+{
+    null,
+    boolean,
+    number,
+    string,
+    object,
+    array,
+};
+
+class json_document;
+
+/**
+ * A handle to a single value in a parsed json_document.
+ *
+ * Handles are cheap to copy and stay valid as long as the document they point into.
+ * Members of objects are found by a linear scan, which is faster than hashing for the
+ * small objects lidl messages turn into.
+ */
+class json_value {
+public:
+    json_kind kind() const;
+
+    bool is_null() const {
+        return kind() == json_kind::null;
+    }
+
+    bool is_object() const {
+        return kind() == json_kind::object;
+    }
+
+    bool is_array() const {
+        return kind() == json_kind::array;
+    }
+
+    bool is_string() const {
+        return kind() == json_kind::string;
+    }
+
+    /**
+     * Number of elements of an array or members of an object.
+     */
+    size_t size() const;
+
+    std::optional<json_value> find(std::string_view key) const;
+
+    /**
+     * Returns the member with the given key, throws a json_error if there's no such
+     * member.
+     */
+    json_value operator[](std::string_view key) const;
+
+    /**
+     * Calls the given function with every element of an array, in order.
+     */
+    template<class FnT>
+    void for_each_element(FnT&& fn) const;
+
+    /**
+     * Calls the given function with the key and value of every member of an object, in
+     * order.
+     */
+    template<class FnT>
+    void for_each_member(FnT&& fn) const;
+
+    bool as_bool() const;
+    int64_t as_int() const;
+    uint64_t as_uint() const;
+    double as_double() const;
+    std::string as_string() const;
+
+private:
+    friend class json_document;
+
+    json_value(const json_document* doc, uint32_t index)
+        : m_doc{doc}
+        , m_index{index} {
+    }
+
+    uint32_t first_child() const {
+        return m_index + 1;
+    }
+
+    uint32_t next_sibling(uint32_t index) const;
+    bool key_equals(uint32_t index, std::string_view key) const;
+
+    const json_document* m_doc;
+    uint32_t m_index;
+};
+
+/**
+ * A parsed JSON text.
+ *
+ * Instead of a tree of nodes, the document is a flat tape of tokens in the order they
+ * appear in the text. Every token records where its value ends, so skipping over a
+ * nested value is a single jump. Strings and numbers point into the original text, which
+ * must outlive the document.
+ */
+class json_document {
+public:
+    static json_document parse(std::string_view text);
+
+    json_value root() const {
+        return {this, 0};
+    }
+
+private:
+    friend class json_value;
+
+    class parser;
+
+    struct token {
+        json_kind kind;
+        // Only meaningful for strings, whether the text has escape sequences.
+        bool escaped;
+        // Index of the token after this value, including all of its children.
+        uint32_t next;
+        // Number of elements or members for arrays and objects.
+        uint32_t size;
+        std::string_view text;
+    };
+
+    std::vector<token> m_tokens;
+};
+
+inline json_kind json_value::kind() const {
+    return m_doc->m_tokens[m_index].kind;
+}
+
+inline uint32_t json_value::next_sibling(uint32_t index) const {
+    return m_doc->m_tokens[index].next;
+}
+
+template<class FnT>
+void json_value::for_each_element(FnT&& fn) const {
+    if (!is_array()) {
+        throw json_error("Expected a JSON array");
+    }
+    auto end = next_sibling(m_index);
+    for (auto i = first_child(); i != end; i = next_sibling(i)) {
+        fn(json_value{m_doc, i});
+    }
+}
+
+template<class FnT>
+void json_value::for_each_member(FnT&& fn) const {
+    if (!is_object()) {
+        throw json_error("Expected a JSON object");
+    }
+    auto end = next_sibling(m_index);
+    for (auto i = first_child(); i != end;) {
+        auto val = i + 1;
+        fn(json_value{m_doc, i}.as_string(), json_value{m_doc, val});
+        i = next_sibling(val);
+    }
+}
+} // namespace lidl
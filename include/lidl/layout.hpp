@@ -5,8 +5,10 @@
 #include <fmt/format.h>
 #include <numeric>
 #include <optional>
-#include <unordered_map>
 #include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace lidl {
 struct raw_layout {
@@ -74,8 +76,29 @@ private:
 
 class compound_layout {
 public:
+    struct member_entry {
+        std::string name;
+        size_t offset;
+        size_t size;
+        size_t alignment;
+        // Padding bytes inserted right before this member.
+        size_t padding_before;
+    };
+
+    /**
+     * Places a member after the existing members. If min_alignment is larger than the
+     * member's natural alignment, the member is placed as if it had that alignment, like
+     * an alignas specifier in C.
+     */
     compound_layout& add_member(std::string_view member_name,
-                                const raw_layout& member_layout);
+                                const raw_layout& member_layout,
+                                size_t min_alignment = 1);
+
+    /**
+     * Raises the alignment of the whole compound to at least the given alignment,
+     * padding its end if necessary.
+     */
+    compound_layout& align_to(size_t alignment);
 
     [[nodiscard]] std::optional<size_t> offset_of(std::string_view name) const;
 
@@ -83,9 +106,23 @@ public:
         return m_current;
     }
 
+    /**
+     * Members in the order they were added, along with their offsets.
+     */
+    const std::vector<member_entry>& members() const {
+        return m_members;
+    }
+
+    /**
+     * Total number of bytes in the compound that do not belong to any member, i.e. the
+     * interior padding plus the trailing padding.
+     */
+    [[nodiscard]] size_t padding_bytes() const;
+
 private:
     raw_layout m_current{1, 1};
     size_t m_padding = 1;
     std::unordered_map<std::string, size_t> m_offsets;
+    std::vector<member_entry> m_members;
 };
 } // namespace lidl
\ No newline at end of file
@@ -4,6 +4,11 @@
 #include "source_info.hpp"
 
 #include <lidl/base.hpp>
+#include <memory>
+
+namespace lidl::eval {
+struct expression;
+}
 
 namespace lidl {
 struct member : public cbase<base::categories::member> {
@@ -18,6 +23,24 @@ struct member : public cbase<base::categories::member> {
     name type_;
     bool nullable = false;
 
+    /**
+     * If this member has a value, the member is placed at an offset that's a multiple of
+     * it, even if the natural alignment of its type is smaller.
+     */
+    std::optional<size_t> alignment;
+
+    /**
+     * Cold members are moved out of their structure into a separate, pointed-to cold
+     * structure. See split_cold_members.
+     */
+    bool cold = false;
+
+    /**
+     * Value the member takes when it isn't given one. Only members of numeric, boolean,
+     * enumeration and string types may have defaults.
+     */
+    std::shared_ptr<const eval::expression> default_value;
+
     bool is_nullable() const {
         return nullable;
     }
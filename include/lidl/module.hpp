@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include <lidl/constant.hpp>
 #include <lidl/enumeration.hpp>
 #include <lidl/generics.hpp>
 #include <lidl/scope.hpp>
@@ -8,10 +9,21 @@
 #include <lidl/structure.hpp>
 #include <lidl/types.hpp>
 #include <lidl/union.hpp>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
 namespace lidl {
+/**
+ * A `static_assert(condition, "message")` in a schema. The condition is evaluated by
+ * the eval library once the module is loaded and layouts are final.
+ */
+struct static_assertion {
+    std::shared_ptr<const eval::expression> condition;
+    std::optional<std::string> message;
+    std::optional<source_info> src_info;
+};
+
 struct module : public cbase<base::categories::module> {
     using cbase::cbase;
 
@@ -33,6 +45,9 @@ struct module : public cbase<base::categories::module> {
     std::vector<std::unique_ptr<generic_union>> generic_unions;
 
     std::vector<std::unique_ptr<service>> services;
+
+    std::vector<std::unique_ptr<constant>> constants;
+    std::vector<static_assertion> static_assertions;
     mutable std::vector<std::unique_ptr<basic_generic_instantiation>> instantiations;
 
     const basic_generic_instantiation& create_or_get_instantiation(const name& ins) const;
@@ -44,7 +59,7 @@ struct module : public cbase<base::categories::module> {
     module& add_child(std::string_view child_name, std::unique_ptr<module> child);
 
     mutable std::deque<std::pair<std::string, std::unique_ptr<module>>> children;
-    mutable std::vector<std::pair<name, basic_generic_instantiation*>> name_ins;
+    mutable std::unordered_map<name, basic_generic_instantiation*, name_hash> name_ins;
 
     mutable std::vector<std::unique_ptr<base>> throwaway;
 
@@ -75,6 +90,39 @@ private:
 
 std::unique_ptr<module> basic_module();
 
+/**
+ * Computes the layouts of every structure and union in the given module and its
+ * children, including the parameter and return types of services. Layouts are cached
+ * in the types, so later layout queries from the backends are simple lookups.
+ */
+void compute_layouts(const module& mod);
+
+/**
+ * Enables member reordering for every structure in the given module and its children.
+ * Must be called before any layouts are computed.
+ */
+void enable_member_reordering(const module& mod);
+
+struct reorder_report {
+    std::string type_name;
+    size_t declared_size;
+    size_t reordered_size;
+};
+
+/**
+ * Lists the structures in the given module and its children that have their members
+ * reordered, along with their sizes before and after reordering.
+ */
+std::vector<reorder_report> report_member_reordering(const module& mod);
+
+/**
+ * Moves the cold members of the given structure into a new structure named
+ * `<struct_name>_cold`, which is defined in the given module right before the original
+ * structure. The original structure gets a `cold` member pointing to it in their place.
+ * Structures without cold members are left untouched.
+ */
+void split_cold_members(module& mod, structure& str, std::string_view struct_name);
+
 inline const module& root_module(const module& mod) {
     auto ptr = &mod;
     while (ptr->parent) {
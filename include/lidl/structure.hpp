@@ -37,19 +37,75 @@ struct structure : public wire_type {
      */
     std::optional<procedure_params_info> return_info;
 
+    /**
+     * If this member is true, members of this structure are laid out to minimize padding
+     * rather than in declaration order. Accessors and traits keep the declaration order.
+     */
+    bool reorder_members() const {
+        return m_reorder_members;
+    }
+
+    void set_reorder_members(bool reorder) {
+        m_reorder_members = reorder;
+        m_layout.reset();
+    }
+
+    /**
+     * If this member has a value, the structure is aligned to at least that many bytes,
+     * for instance to make it start at a cache line boundary.
+     */
+    std::optional<size_t> alignment() const {
+        return m_alignment;
+    }
+
+    void set_alignment(std::optional<size_t> alignment) {
+        m_alignment = alignment;
+        m_layout.reset();
+    }
+
     type_categories category(const module& mod) const override;
 
     raw_layout wire_layout(const module& mod) const override;
 
-    YAML::Node bin2yaml(const module& mod, ibinary_reader& span) const override;
+    YAML::Node bin2yaml(const module& mod, binary_reader& span) const override;
 
     int yaml2bin(const module& mod,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override;
+                 binary_writer& writer) const override;
 
-    compound_layout layout(const module& mod) const;
+    void bin2json(const module& mod,
+                  binary_reader& reader,
+                  json_writer& writer) const override;
+
+    int json2bin(const module& mod,
+                 const json_value& value,
+                 binary_writer& writer) const override;
+
+    /**
+     * Computes the layout of this structure on first use and caches it. Adding a member
+     * invalidates the cached layout.
+     */
+    const compound_layout& layout(const module& mod) const;
+
+    /**
+     * Computes the layout this structure would have with its members in declaration
+     * order, regardless of reordering.
+     */
+    compound_layout declaration_order_layout(const module& mod) const;
+
+    /**
+     * Members in the order they are placed in memory.
+     */
+    std::vector<std::pair<std::string_view, const member*>>
+    layout_order_members(const module& mod) const;
 
 private:
+    compound_layout compute_layout(const module& mod, bool reorder) const;
+
     std::deque<std::pair<std::string, member>> members;
+
+    bool m_reorder_members = false;
+    std::optional<size_t> m_alignment;
+    mutable std::optional<compound_layout> m_layout;
 };
 } // namespace lidl
\ No newline at end of file
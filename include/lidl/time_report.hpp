@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Timings and counters of a compilation, for finding out where the compiler spends its
+ * time. Reporting is disabled by default, in which case phases and counters cost a
+ * single branch.
+ *
+ * The compiler is single threaded, and so is the report.
+ */
+namespace lidl::time_report {
+void enable();
+bool enabled();
+
+/**
+ * Adds n to the counter with the given name.
+ */
+void count(std::string_view counter, int64_t n = 1);
+
+/**
+ * Times a phase of the compilation, from its construction to its destruction. Phases
+ * started while another phase is running are nested under it.
+ *
+ * The detail is shown in traces to tell apart the runs of a phase, such as the imports
+ * of different modules, but it isn't part of the phase's identity in tables.
+ */
+class phase {
+public:
+    explicit phase(std::string_view name, std::string_view detail = {});
+    ~phase();
+
+    phase(const phase&) = delete;
+    phase& operator=(const phase&) = delete;
+
+private:
+    int m_index = -1;
+};
+
+/**
+ * Formats the phases as a tree with the total and self times of every phase, followed
+ * by the counters.
+ */
+std::string format_table();
+
+/**
+ * Formats the phases and counters in the Chrome trace event format, which can be
+ * loaded in chrome://tracing or Perfetto.
+ */
+std::string format_chrome_trace();
+} // namespace lidl::time_report
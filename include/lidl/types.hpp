@@ -5,6 +5,7 @@
 #include <lidl/base.hpp>
 #include <lidl/basic.hpp>
 #include <lidl/binary_writer.hpp>
+#include <lidl/json.hpp>
 #include <lidl/layout.hpp>
 #include <lidl/scope.hpp>
 #include <lidl/source_info.hpp>
@@ -37,8 +38,15 @@ public:
         return category(mod) == type_categories::reference;
     }
     
-    virtual YAML::Node bin2yaml(const module&, ibinary_reader&) const                 = 0;
-    virtual int yaml2bin(const module& mod, const YAML::Node&, ibinary_writer&) const = 0;
+    virtual YAML::Node bin2yaml(const module&, binary_reader&) const                 = 0;
+    virtual int yaml2bin(const module& mod, const YAML::Node&, binary_writer&) const = 0;
+
+    /**
+     * Same as bin2yaml and yaml2bin, but for JSON. bin2json writes directly into the
+     * given writer rather than building a document.
+     */
+    virtual void bin2json(const module&, binary_reader&, json_writer&) const          = 0;
+    virtual int json2bin(const module& mod, const json_value&, binary_writer&) const = 0;
 
     name get_wire_type_name_impl(const module& mod, const name& your_name) const override = 0;
 };
@@ -31,6 +31,7 @@ struct union_type
         }
         members.emplace_back(std::move(name), std::move(mem));
         define(get_scope(), members.back().first, &members.back().second);
+        m_layout.reset();
     }
 
     std::vector<std::pair<std::string_view, const member*>> all_members() const {
@@ -78,18 +79,31 @@ struct union_type
 
     virtual raw_layout wire_layout(const module& mod) const override;
 
-    YAML::Node bin2yaml(const module& mod, ibinary_reader& reader) const override;
+    YAML::Node bin2yaml(const module& mod, binary_reader& reader) const override;
 
     int yaml2bin(const module& mod,
                  const YAML::Node& node,
-                 ibinary_writer& writer) const override;
+                 binary_writer& writer) const override;
 
-    compound_layout layout(const module& mod) const;
+    void bin2json(const module& mod,
+                  binary_reader& reader,
+                  json_writer& writer) const override;
+
+    int json2bin(const module& mod,
+                 const json_value& value,
+                 binary_writer& writer) const override;
+
+    /**
+     * Computes the layout of this union on first use and caches it. Adding a member
+     * invalidates the cached layout.
+     */
+    const compound_layout& layout(const module& mod) const;
 
 private:
     std::deque<std::pair<std::string, member>> members;
 
     mutable std::unique_ptr<enumeration> m_enumeration;
+    mutable std::optional<compound_layout> m_layout;
 };
 
 std::unique_ptr<enumeration> enum_for_union(const module& m, const union_type& u);
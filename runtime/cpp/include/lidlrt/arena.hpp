@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tos/span.hpp>
+#include <utility>
+#include <vector>
+
+namespace lidl {
+/**
+ * Hands out buffers to build messages in, and takes them back once the messages are
+ * done with, so that a server loop reuses the same warm storage instead of allocating
+ * a buffer per request.
+ *
+ * Buffers come in power of two size classes with a free list each. Message builders
+ * can't grow, so callers ask for a size that fits every message they may build.
+ *
+ * Builders skip alignment padding and struct padding without writing it, so buffers
+ * are cleared when they are returned, and every buffer handed out is all zeroes. Only
+ * the bytes in use are cleared, so trimming a buffer to its message keeps this cheap.
+ *
+ * An arena is not thread safe, use this_thread() to get one per thread. Buffers must be
+ * returned on the thread they came from, and must not outlive their arena.
+ */
+class message_arena {
+public:
+    static constexpr size_t min_buffer_size = 64;
+    // Offsets are 16 bit signed integers, so messages can't be larger than this.
+    static constexpr size_t max_buffer_size = 32768;
+    static constexpr size_t num_size_classes = 10;
+
+    static_assert(min_buffer_size << (num_size_classes - 1) == max_buffer_size);
+
+    /**
+     * A buffer leased from an arena. It goes back to the arena's free list when
+     * destroyed.
+     */
+    class buffer {
+    public:
+        buffer(buffer&& rhs) noexcept
+            : m_arena{std::exchange(rhs.m_arena, nullptr)}
+            , m_storage{std::move(rhs.m_storage)}
+            , m_size_class{rhs.m_size_class}
+            , m_size{rhs.m_size} {
+        }
+
+        buffer& operator=(buffer&& rhs) noexcept {
+            std::swap(m_arena, rhs.m_arena);
+            std::swap(m_storage, rhs.m_storage);
+            std::swap(m_size_class, rhs.m_size_class);
+            std::swap(m_size, rhs.m_size);
+            return *this;
+        }
+
+        ~buffer() {
+            if (m_arena) {
+                m_arena->release(*this);
+            }
+        }
+
+        [[nodiscard]] uint8_t* data() {
+            return m_storage.get();
+        }
+
+        [[nodiscard]] const uint8_t* data() const {
+            return m_storage.get();
+        }
+
+        [[nodiscard]] size_t size() const {
+            return m_size;
+        }
+
+        [[nodiscard]] size_t capacity() const {
+            return message_arena::class_size(m_size_class);
+        }
+
+        [[nodiscard]] tos::span<uint8_t> span() {
+            return tos::span<uint8_t>(data(), size());
+        }
+
+        [[nodiscard]] tos::span<const uint8_t> span() const {
+            return tos::span<const uint8_t>(data(), size());
+        }
+
+        operator tos::span<uint8_t>() {
+            return span();
+        }
+
+        operator tos::span<const uint8_t>() const {
+            return span();
+        }
+
+        /**
+         * Trims the buffer to the size of the message built in it. Only this many bytes
+         * are cleared when the buffer goes back to the arena, so it must cover every
+         * byte that was written.
+         */
+        void resize(size_t message_size) {
+            m_size = std::min(message_size, capacity());
+        }
+
+    private:
+        friend class message_arena;
+
+        buffer(message_arena& arena, std::unique_ptr<uint8_t[]> storage, int size_class)
+            : m_arena{&arena}
+            , m_storage{std::move(storage)}
+            , m_size_class{size_class}
+            , m_size{message_arena::class_size(size_class)} {
+        }
+
+        message_arena* m_arena;
+        std::unique_ptr<uint8_t[]> m_storage;
+        int m_size_class;
+        size_t m_size;
+    };
+
+    message_arena() = default;
+    message_arena(const message_arena&) = delete;
+    message_arena& operator=(const message_arena&) = delete;
+
+    /**
+     * Returns the arena of the calling thread.
+     */
+    static message_arena& this_thread() {
+        thread_local message_arena arena;
+        return arena;
+    }
+
+    /**
+     * Returns a zeroed buffer of at least the given size, which must not be larger than
+     * max_buffer_size.
+     */
+    [[nodiscard]] buffer get(size_t min_size) {
+        auto cls = class_for(min_size);
+        auto& stats = m_classes[cls];
+
+        ++stats.outstanding;
+        stats.peak = std::max(stats.peak, stats.outstanding);
+
+        if (stats.free.empty()) {
+            // Value initialized, so it starts out zeroed like the recycled ones.
+            return buffer(*this, std::make_unique<uint8_t[]>(class_size(cls)), cls);
+        }
+
+        auto storage = std::move(stats.free.back());
+        stats.free.pop_back();
+        return buffer(*this, std::move(storage), cls);
+    }
+
+    /**
+     * Starts a new epoch.
+     *
+     * Free lists are trimmed down to the number of buffers that were in use at the same
+     * time during the last epoch. A server calls this periodically so that the arena
+     * follows its load rather than holding on to its worst moment forever.
+     */
+    void reset() {
+        for (auto& stats : m_classes) {
+            if (stats.free.size() > stats.peak) {
+                stats.free.resize(stats.peak);
+            }
+            stats.peak = stats.outstanding;
+        }
+        ++m_epoch;
+    }
+
+    [[nodiscard]] uint64_t epoch() const {
+        return m_epoch;
+    }
+
+    /**
+     * Number of buffers in the free lists, waiting to be handed out again.
+     */
+    [[nodiscard]] size_t cached_buffers() const {
+        size_t res = 0;
+        for (auto& stats : m_classes) {
+            res += stats.free.size();
+        }
+        return res;
+    }
+
+private:
+    struct size_class_stats {
+        std::vector<std::unique_ptr<uint8_t[]>> free;
+        size_t outstanding = 0;
+        size_t peak        = 0;
+    };
+
+    static constexpr size_t class_size(int cls) {
+        return min_buffer_size << cls;
+    }
+
+    static int class_for(size_t size) {
+        int cls = 0;
+        while (cls < int(num_size_classes) - 1 && class_size(cls) < size) {
+            ++cls;
+        }
+        return cls;
+    }
+
+    void release(buffer& buf) {
+        auto& stats = m_classes[buf.m_size_class];
+        --stats.outstanding;
+        std::fill_n(buf.data(), buf.size(), uint8_t(0));
+        stats.free.push_back(std::move(buf.m_storage));
+    }
+
+    std::array<size_class_stats, num_size_classes> m_classes;
+    uint64_t m_epoch = 0;
+};
+
+inline tos::span<uint8_t> as_span(message_arena::buffer& buf) {
+    return buf.span();
+}
+} // namespace lidl
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <cstring>
 #include <lidlrt/buffer.hpp>
 #include <lidlrt/ptr.hpp>
+#include <lidlrt/structure.hpp>
 
 namespace lidl {
 struct message_builder {
@@ -50,6 +52,16 @@ private:
     uint8_t* m_cur_ptr;
 };
 
+/**
+ * Returns whether an object of the given size and alignment can still be allocated in
+ * the builder. The builder hangs when it runs out of space, so code building messages
+ * from untrusted input checks before every allocation instead.
+ */
+inline bool fits(const message_builder& builder, size_t size, size_t align) {
+    auto pos = (builder.size() + align - 1) / align * align;
+    return pos + size <= builder.capacity();
+}
+
 template<class T>
 T& append_raw(message_builder& builder, const T& t) {
     auto alloc = builder.allocate(sizeof(T), alignof(T));
@@ -77,6 +89,34 @@ T& create(message_builder& builder, Ts&&... args) {
     return emplace_raw<T>(builder, std::forward<Ts>(args)...);
 }
 
+/**
+ * Creates an object in the builder, or returns nullptr if it doesn't fit.
+ */
+template<class T, class... Ts>
+const T* try_create(message_builder& builder, Ts&&... args) {
+    if (!fits(builder, sizeof(T), alignof(T))) {
+        return nullptr;
+    }
+    return &create<T>(builder, std::forward<Ts>(args)...);
+}
+
+/**
+ * Creates an object of a structure whose members all have default values by copying
+ * the message the compiler prebuilt from those defaults into the builder.
+ */
+template<class T>
+T& create_default(message_builder& builder) {
+    constexpr auto& image = struct_traits<T>::default_message;
+    auto alloc =
+        builder.allocate(image.size(), struct_traits<T>::default_message_alignment);
+    if (!alloc) {
+        while (true)
+            ;
+    }
+    memcpy(alloc, image.data(), image.size());
+    return *reinterpret_cast<T*>(alloc + image.size() - sizeof(T));
+}
+
 template<class T>
 void finish(message_builder& builder, T& t) {
     emplace_raw<ptr<T>>(builder, t);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <lidlrt/fixed_string.hpp>
 #include <string_view>
 
 namespace lidl {
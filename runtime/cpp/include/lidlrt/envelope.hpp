@@ -0,0 +1,141 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/tracing.hpp>
+#include <lidlrt/trailer.hpp>
+#include <tos/cancellation.hpp>
+#include <tos/span.hpp>
+#include <tos/task.hpp>
+
+/**
+ * The envelope holds the optional fields that requests carry after their root. Fields
+ * are only present if they are enabled: LIDL_RPC_TRACING adds the trace context, and
+ * LIDL_RPC_DEADLINES adds the deadline of the call. With neither, the envelope is empty
+ * and requests are only their root.
+ *
+ * Fields are removed from the end of the request before its root is read, so the root
+ * is still at the end of the buffer the dispatch reads it from. Clients and servers must
+ * therefore agree on the enabled fields, and requests built by hand must call
+ * attach_envelope after creating their root.
+ */
+namespace lidl {
+struct call_envelope {
+    using clock = tos::cancellation_token::clock;
+
+    tracing::trace_context trace;
+    // The time the caller stops waiting for the response at.
+    clock::time_point deadline = clock::time_point::max();
+
+    bool expired() const {
+        return deadline != clock::time_point::max() && clock::now() >= deadline;
+    }
+};
+
+#if defined(LIDL_RPC_DEADLINES)
+namespace detail {
+/**
+ * The deadline is sent as the nanoseconds left until it, since clocks of different
+ * machines can't be compared, in little endian, in a trailer tagged "dl", see
+ * trailer.hpp.
+ */
+struct deadline_layout {
+    static constexpr trailer_tag tag{'d', 'l'};
+    static constexpr uint8_t version = 2;
+    static constexpr uint8_t size    = 8;
+    // Sent for calls without a deadline.
+    static constexpr uint64_t none = UINT64_MAX;
+};
+
+inline void attach_deadline(message_builder& builder,
+                            call_envelope::clock::time_point deadline) {
+    auto ptr = append_trailer(
+        builder, deadline_layout::tag, deadline_layout::size, deadline_layout::version);
+    if (!ptr) {
+        return;
+    }
+    uint64_t left = deadline_layout::none;
+    if (deadline != call_envelope::clock::time_point::max()) {
+        auto now = call_envelope::clock::now();
+        // Calls whose deadline already passed are still sent, and shed by the server.
+        left = 0;
+        if (deadline > now) {
+            left = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now)
+                       .count();
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        ptr[i] = static_cast<uint8_t>(left >> (i * 8));
+    }
+}
+
+inline call_envelope::clock::time_point extract_deadline(tos::span<uint8_t>& request) {
+    auto ptr = strip_trailer(
+        request, deadline_layout::tag, deadline_layout::size, deadline_layout::version);
+    if (!ptr) {
+        return call_envelope::clock::time_point::max();
+    }
+    uint64_t left = 0;
+    for (int i = 0; i < 8; ++i) {
+        left |= uint64_t(ptr[i]) << (i * 8);
+    }
+    if (left == deadline_layout::none) {
+        return call_envelope::clock::time_point::max();
+    }
+    return call_envelope::clock::now() + std::chrono::nanoseconds(left);
+}
+} // namespace detail
+#endif
+
+/**
+ * Appends the envelope of a call to a request whose root was just created. The deadline
+ * of the call is the one of the given token.
+ */
+inline void attach_envelope(message_builder& builder,
+                            [[maybe_unused]] const tos::cancellation_token& token = {}) {
+    tracing::attach(builder);
+#if defined(LIDL_RPC_DEADLINES)
+    detail::attach_deadline(builder, token.deadline());
+#endif
+}
+
+/**
+ * Removes the envelope from the end of the request and returns it.
+ */
+inline call_envelope extract_envelope(tos::span<uint8_t>& request) {
+    call_envelope res;
+#if defined(LIDL_RPC_DEADLINES)
+    res.deadline = detail::extract_deadline(request);
+#endif
+    res.trace = tracing::extract(request);
+    return res;
+}
+
+/**
+ * Returns the cancellation token asynchronous stubs send the deadline of, which is the
+ * one of the task making the call. Without LIDL_RPC_DEADLINES, the deadline isn't sent,
+ * and this returns an empty token without suspending.
+ */
+inline auto outgoing_token() {
+#if defined(LIDL_RPC_DEADLINES)
+    return tos::current_token();
+#else
+    struct awaiter {
+        bool await_ready() const noexcept {
+            return true;
+        }
+
+        void await_suspend(std::coroutine_handle<>) const noexcept {
+        }
+
+        tos::cancellation_token await_resume() const noexcept {
+            return {};
+        }
+    };
+
+    return awaiter{};
+#endif
+}
+} // namespace lidl
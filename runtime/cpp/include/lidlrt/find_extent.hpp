@@ -2,6 +2,8 @@
 
 #include <lidlrt/string.hpp>
 #include <lidlrt/vector.hpp>
+#include <tuple>
+#include <type_traits>
 
 namespace lidl::meta::detail {
 inline tos::span<const uint8_t> bounding_span(tos::span<const uint8_t> a) {
@@ -39,8 +41,11 @@ inline tos::span<const uint8_t> find_extent(const lidl::string& str) {
 template<class ObjT, class... Members>
 tos::span<const uint8_t> find_extents(const ObjT& obj,
                                       const std::tuple<Members...>& members) {
-    return bounding_span(
-        find_extent((obj.*std::get<Members>(members).const_function)())...);
+    return std::apply(
+        [&obj](const auto&... member) {
+            return bounding_span(find_extent((obj.*member.const_function)())...);
+        },
+        members);
 }
 
 template<class ObjT>
@@ -56,4 +61,68 @@ std::pair<tos::span<const uint8_t>, ptrdiff_t> find_extent_and_position(const Ob
     auto __ptr    = reinterpret_cast<const uint8_t*>(&obj);
     return {__extent, __ptr - __extent.begin()};
 }
+
+inline bool contains(tos::span<const uint8_t> buf, const void* data, size_t len) {
+    auto begin = reinterpret_cast<uintptr_t>(data);
+    auto end   = reinterpret_cast<uintptr_t>(buf.end());
+    return begin >= reinterpret_cast<uintptr_t>(buf.begin()) && begin <= end &&
+           len <= end - begin;
+}
+
+template<class ObjT>
+bool contains(tos::span<const uint8_t> buf, const ObjT& obj) {
+    return reinterpret_cast<uintptr_t>(&obj) % alignof(ObjT) == 0 &&
+           contains(buf, &obj, sizeof(ObjT));
+}
+
+/**
+ * Returns whether the object and everything it refers to lie in the buffer, for the
+ * types find_extent supports.
+ *
+ * Unlike find_extent, every object is checked to be in the buffer and aligned before
+ * its lengths and offsets are read, so this never reads outside of the buffer and can
+ * be used on messages that aren't trusted.
+ */
+template<class ObjT>
+bool within_bounds(const ObjT& obj, tos::span<const uint8_t> buf);
+
+template<class T>
+bool within_bounds(const lidl::vector<T>& vec, tos::span<const uint8_t> buf) {
+    if (!contains(buf, vec) || vec.size() > buf.size()) {
+        return false;
+    }
+    auto elems = vec.span();
+    return contains(buf, elems.data(), elems.size() * sizeof(T));
+}
+
+inline bool within_bounds(const lidl::string& str, tos::span<const uint8_t> buf) {
+    if (!contains(buf, str) || str.string_view().size() > buf.size()) {
+        return false;
+    }
+    auto sv = str.string_view();
+    return contains(buf, sv.data(), sv.size());
+}
+
+template<class ObjT, class... Members>
+bool members_within_bounds(const ObjT& obj,
+                           const std::tuple<Members...>& members,
+                           tos::span<const uint8_t> buf) {
+    return std::apply(
+        [&](const auto&... member) {
+            return (within_bounds((obj.*member.const_function)(), buf) && ...);
+        },
+        members);
+}
+
+template<class ObjT>
+bool within_bounds(const ObjT& obj, tos::span<const uint8_t> buf) {
+    if (!contains(buf, obj)) {
+        return false;
+    }
+    if constexpr (std::is_arithmetic_v<ObjT> || std::is_enum_v<ObjT>) {
+        return true;
+    } else {
+        return members_within_bounds(obj, struct_traits<ObjT>::members, buf);
+    }
+}
 } // namespace lidl::meta::detail
\ No newline at end of file
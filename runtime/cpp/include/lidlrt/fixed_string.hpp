@@ -0,0 +1,28 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+namespace lidl {
+/**
+ * A string literal that can be passed as a template argument. Generated code uses it
+ * to tag enum members and union alternatives with their names at compile time.
+ */
+template<size_t N>
+struct fixed_string {
+    constexpr fixed_string(const char (&str)[N]) {
+        std::copy_n(str, N, data);
+    }
+
+    [[nodiscard]] constexpr std::string_view string_view() const {
+        return {data, N - 1};
+    }
+
+    constexpr operator std::string_view() const {
+        return string_view();
+    }
+
+    char data[N];
+};
+} // namespace lidl
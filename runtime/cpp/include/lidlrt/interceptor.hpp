@@ -0,0 +1,360 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <lidlrt/builder.hpp>
+#include <optional>
+#include <string_view>
+#include <tos/task.hpp>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Interceptors run code around every call a server handles or a client makes, for
+ * things like authentication, logging or rate limiting.
+ *
+ * An interceptor is any class with one or both of these member functions:
+ *
+ *   state before(const Info& info);
+ *   void after(const Info& info, state& st, bool ok);
+ *
+ * before is called before the procedure runs. Whatever it returns is passed to after,
+ * which is called once the procedure finished, and must be contextually convertible to
+ * bool. On the server side, a false state rejects the call: the procedure isn't run and
+ * the call fails. Clients can't report failed calls, so they ignore it. before may also
+ * return nothing, and after may omit the state parameter.
+ *
+ * Every interceptor whose before was called gets its after called, in reverse order.
+ *
+ * Info describes the call: it has the service_type, and the service_name,
+ * procedure_name and procedure_index members. Interceptors are usually templates over
+ * it, since every procedure has its own type.
+ *
+ * Interceptors are composed statically in an interceptor_chain, and the calls to them
+ * are inlined. An empty chain compiles to a plain call.
+ */
+namespace lidl {
+template<class T>
+class service_descriptor;
+
+/**
+ * Describes a call to a procedure known at compile time. The server and the zerocopy
+ * clients use this.
+ */
+template<class ServiceT, int ProcId>
+struct call_info {
+    using service_type = ServiceT;
+    static constexpr int procedure_index = ProcId;
+    static constexpr std::string_view service_name = service_descriptor<ServiceT>::name;
+    static constexpr std::string_view procedure_name =
+        std::get<ProcId>(service_descriptor<ServiceT>::procedures).name;
+};
+
+/**
+ * Describes a call to a procedure that's only known at run time. Stub clients use this,
+ * as they find out which procedure is called from the request they serialized.
+ */
+template<class ServiceT>
+struct runtime_call_info {
+    using service_type = ServiceT;
+    static constexpr std::string_view service_name = service_descriptor<ServiceT>::name;
+
+    explicit runtime_call_info(int procedure)
+        : procedure_index{procedure}
+        , procedure_name{procedure_names()[procedure]} {
+    }
+
+    int procedure_index;
+    std::string_view procedure_name;
+
+private:
+    static constexpr auto procedure_names() {
+        return std::apply(
+            [](auto&... procs) {
+                return std::array<std::string_view, sizeof...(procs)>{procs.name...};
+            },
+            service_descriptor<ServiceT>::procedures);
+    }
+};
+
+namespace detail {
+template<class InterceptorT, class Info>
+auto call_before(InterceptorT& interceptor, const Info& info) {
+    if constexpr (requires { interceptor.before(info); }) {
+        if constexpr (std::is_void_v<decltype(interceptor.before(info))>) {
+            interceptor.before(info);
+            return true;
+        } else {
+            return interceptor.before(info);
+        }
+    } else {
+        return true;
+    }
+}
+
+template<class InterceptorT, class Info, class StateT>
+void call_after(InterceptorT& interceptor, const Info& info, StateT& state, bool ok) {
+    if constexpr (requires { interceptor.after(info, state, ok); }) {
+        interceptor.after(info, state, ok);
+    } else if constexpr (requires { interceptor.after(info, ok); }) {
+        interceptor.after(info, ok);
+    }
+}
+
+template<class InterceptorT, class Info>
+using before_result_t = decltype(call_before(std::declval<InterceptorT&>(),
+                                             std::declval<const Info&>()));
+
+template<class T>
+struct task_result;
+
+template<class T>
+struct task_result<tos::Task<T>> {
+    using type = T;
+};
+
+// The states the interceptors returned from before for a single call.
+template<class Info, class... Interceptors>
+class call_states {
+public:
+    using interceptors_type = std::tuple<Interceptors...>;
+
+    // Runs every before until one of them rejects the call.
+    bool enter(interceptors_type& interceptors, const Info& info) {
+        return enter(interceptors, info, std::index_sequence_for<Interceptors...>{});
+    }
+
+    // Runs every before, ignoring their results.
+    void enter_all(interceptors_type& interceptors, const Info& info) {
+        enter_all(interceptors, info, std::index_sequence_for<Interceptors...>{});
+    }
+
+    void leave(interceptors_type& interceptors, const Info& info, bool ok) {
+        leave(interceptors, info, ok, std::index_sequence_for<Interceptors...>{});
+    }
+
+private:
+    template<size_t I>
+    bool enter_one(interceptors_type& interceptors, const Info& info) {
+        auto& state =
+            std::get<I>(m_states).emplace(call_before(std::get<I>(interceptors), info));
+        return static_cast<bool>(state);
+    }
+
+    template<size_t... Is>
+    bool enter(interceptors_type& interceptors,
+               const Info& info,
+               std::index_sequence<Is...>) {
+        return (enter_one<Is>(interceptors, info) && ...);
+    }
+
+    template<size_t... Is>
+    void enter_all(interceptors_type& interceptors,
+                   const Info& info,
+                   std::index_sequence<Is...>) {
+        (enter_one<Is>(interceptors, info), ...);
+    }
+
+    template<size_t I>
+    void leave_one(interceptors_type& interceptors, const Info& info, bool ok) {
+        if (auto& state = std::get<I>(m_states)) {
+            call_after(std::get<I>(interceptors), info, *state, ok);
+        }
+    }
+
+    template<size_t... Is>
+    void leave(interceptors_type& interceptors,
+               const Info& info,
+               bool ok,
+               std::index_sequence<Is...>) {
+        (leave_one<sizeof...(Is) - 1 - Is>(interceptors, info, ok), ...);
+    }
+
+    std::tuple<std::optional<before_result_t<Interceptors, Info>>...> m_states;
+};
+
+template<class T>
+bool call_succeeded(const T& res) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return res;
+    } else {
+        return true;
+    }
+}
+} // namespace detail
+
+template<class... Interceptors>
+class interceptor_chain {
+public:
+    constexpr interceptor_chain() = default;
+
+    constexpr explicit interceptor_chain(Interceptors... interceptors)
+        requires(sizeof...(Interceptors) > 0)
+        : m_interceptors(std::move(interceptors)...) {
+    }
+
+    template<size_t I>
+    auto& get() {
+        return std::get<I>(m_interceptors);
+    }
+
+    /**
+     * Makes a call that returns whether it succeeded, unless an interceptor rejects it.
+     */
+    template<class Info, class CallT>
+    bool run(const Info& info, CallT&& call) {
+        if constexpr (sizeof...(Interceptors) == 0) {
+            return call();
+        } else {
+            detail::call_states<Info, Interceptors...> states;
+            bool ok = states.enter(m_interceptors, info) && call();
+            states.leave(m_interceptors, info, ok);
+            return ok;
+        }
+    }
+
+    /**
+     * Asynchronous version of run, the call returns a tos::Task<bool>.
+     */
+    template<class Info, class CallT>
+    tos::Task<bool> run_async(const Info& info, CallT&& call) {
+        if constexpr (sizeof...(Interceptors) == 0) {
+            return call();
+        } else {
+            return run_async_impl(info, std::decay_t<CallT>(std::forward<CallT>(call)));
+        }
+    }
+
+    /**
+     * Makes a call that can't be rejected, and returns its result. Calls that return a
+     * bool succeed if they return true, others always succeed.
+     */
+    template<class Info, class CallT>
+    decltype(auto) observe(const Info& info, CallT&& call) {
+        if constexpr (sizeof...(Interceptors) == 0) {
+            return call();
+        } else {
+            detail::call_states<Info, Interceptors...> states;
+            states.enter_all(m_interceptors, info);
+            decltype(auto) res = call();
+            states.leave(m_interceptors, info, detail::call_succeeded(res));
+            return res;
+        }
+    }
+
+    /**
+     * Asynchronous version of observe, the call returns a tos::Task.
+     */
+    template<class Info, class CallT>
+    auto observe_async(const Info& info, CallT&& call) -> decltype(call()) {
+        if constexpr (sizeof...(Interceptors) == 0) {
+            return call();
+        } else {
+            using result_type = typename detail::task_result<decltype(call())>::type;
+            return observe_async_impl<result_type>(
+                info, std::decay_t<CallT>(std::forward<CallT>(call)));
+        }
+    }
+
+private:
+    template<class Info, class CallT>
+    tos::Task<bool> run_async_impl(Info info, CallT call) {
+        detail::call_states<Info, Interceptors...> states;
+        bool ok = states.enter(m_interceptors, info);
+        if (ok) {
+            ok = co_await call();
+        }
+        states.leave(m_interceptors, info, ok);
+        co_return ok;
+    }
+
+    template<class ResultT, class Info, class CallT>
+    tos::Task<ResultT> observe_async_impl(Info info, CallT call) {
+        detail::call_states<Info, Interceptors...> states;
+        states.enter_all(m_interceptors, info);
+        auto res = co_await call();
+        states.leave(m_interceptors, info, detail::call_succeeded(res));
+        co_return res;
+    }
+
+    [[no_unique_address]] std::tuple<Interceptors...> m_interceptors;
+};
+
+template<class... Interceptors>
+interceptor_chain(Interceptors...) -> interceptor_chain<Interceptors...>;
+
+/**
+ * A layer for zerocopy clients that runs the interceptors around the calls of the next
+ * layer:
+ *
+ *   calculator::zerocopy_client<intercepted_layer<calculator, next_layer, logger>>
+ */
+template<class ServiceT, class NextLayer, class... Interceptors>
+class intercepted_layer : public NextLayer {
+public:
+    template<class... Args>
+    explicit intercepted_layer(interceptor_chain<Interceptors...> chain, Args&&... args)
+        : NextLayer(std::forward<Args>(args)...)
+        , m_chain(std::move(chain)) {
+    }
+
+    template<int ProcId>
+    auto execute(std::integral_constant<int, ProcId> proc, const void* params, void* ret) {
+        // Captured by value, as asynchronous calls outlive this function.
+        auto call = [this, proc, params, ret] {
+            return NextLayer::execute(proc, params, ret);
+        };
+        if constexpr (std::is_same_v<decltype(call()), bool>) {
+            return m_chain.observe(call_info<ServiceT, ProcId>{}, call);
+        } else {
+            return m_chain.observe_async(call_info<ServiceT, ProcId>{}, call);
+        }
+    }
+
+private:
+    interceptor_chain<Interceptors...> m_chain;
+};
+
+/**
+ * A transport for stub clients that runs the interceptors around the requests sent
+ * over the next transport:
+ *
+ *   calculator::stub_client<intercepted_transport<calculator, transport, logger>>
+ */
+template<class ServiceT, class ServBase, class... Interceptors>
+class intercepted_transport : public ServBase {
+public:
+    template<class... Args>
+    explicit intercepted_transport(interceptor_chain<Interceptors...> chain,
+                                   Args&&... args)
+        : ServBase(std::forward<Args>(args)...)
+        , m_chain(std::move(chain)) {
+    }
+
+    template<class FnT>
+    auto& transform_call(lidl::message_builder& mb, const FnT& create_call) {
+        return ServBase::transform_call(mb, [&]() -> auto& {
+            auto& call = create_call();
+            m_procedure = static_cast<int>(call.alternative());
+            return call;
+        });
+    }
+
+    template<class BufT>
+    auto send_receive(BufT&& buf) {
+        // Stubs send a request right after serializing it, before they can be
+        // suspended, so the procedure is the one of this request.
+        auto call = [this, &buf] { return ServBase::send_receive(buf); };
+        if constexpr (requires { typename detail::task_result<decltype(call())>::type; }) {
+            return m_chain.observe_async(runtime_call_info<ServiceT>(m_procedure), call);
+        } else {
+            return m_chain.observe(runtime_call_info<ServiceT>(m_procedure), call);
+        }
+    }
+
+private:
+    interceptor_chain<Interceptors...> m_chain;
+    int m_procedure = 0;
+};
+} // namespace lidl
@@ -0,0 +1,715 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/enumeration.hpp>
+#include <lidlrt/string.hpp>
+#include <lidlrt/vector.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace lidl::json {
+/**
+ * A reusable buffer JSON text is written into.
+ *
+ * Clearing the output keeps its storage around, so serializing many messages through
+ * the same output only allocates until the buffer is large enough for the biggest one.
+ */
+class output {
+public:
+    void clear() {
+        m_buf.clear();
+        m_need_comma = false;
+    }
+
+    [[nodiscard]] std::string_view str() const {
+        return m_buf;
+    }
+
+    void begin_object() {
+        separate();
+        m_buf.push_back('{');
+        m_need_comma = false;
+    }
+
+    void end_object() {
+        m_buf.push_back('}');
+        m_need_comma = true;
+    }
+
+    void begin_array() {
+        separate();
+        m_buf.push_back('[');
+        m_need_comma = false;
+    }
+
+    void end_array() {
+        m_buf.push_back(']');
+        m_need_comma = true;
+    }
+
+    void key(std::string_view key) {
+        separate();
+        write_string(key);
+        m_buf.push_back(':');
+        m_need_comma = false;
+    }
+
+    void value(std::string_view str) {
+        separate();
+        write_string(str);
+        m_need_comma = true;
+    }
+
+    void value(const char* str) {
+        value(std::string_view(str));
+    }
+
+    void value(bool b) {
+        separate();
+        m_buf.append(b ? "true" : "false");
+        m_need_comma = true;
+    }
+
+    template<class T,
+             std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>* =
+                 nullptr>
+    void value(T t) {
+        if constexpr (std::is_floating_point_v<T>) {
+            // JSON has no representation for infinities and NaNs.
+            if (!std::isfinite(t)) {
+                return null();
+            }
+        }
+        separate();
+        char buf[32];
+        auto res = std::to_chars(std::begin(buf), std::end(buf), t);
+        m_buf.append(buf, res.ptr);
+        m_need_comma = true;
+    }
+
+    void null() {
+        separate();
+        m_buf.append("null");
+        m_need_comma = true;
+    }
+
+private:
+    void separate() {
+        if (m_need_comma) {
+            m_buf.push_back(',');
+        }
+    }
+
+    void write_string(std::string_view str) {
+        constexpr char hex_digits[] = "0123456789abcdef";
+        m_buf.push_back('"');
+        auto begin = str.begin();
+        for (auto it = str.begin(); it != str.end(); ++it) {
+            auto c = static_cast<unsigned char>(*it);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+
+            m_buf.append(begin, it);
+            begin = it + 1;
+
+            m_buf.push_back('\\');
+            switch (c) {
+            case '"':
+            case '\\':
+                m_buf.push_back(c);
+                break;
+            case '\n':
+                m_buf.push_back('n');
+                break;
+            case '\r':
+                m_buf.push_back('r');
+                break;
+            case '\t':
+                m_buf.push_back('t');
+                break;
+            default:
+                m_buf.append("u00");
+                m_buf.push_back(hex_digits[c >> 4]);
+                m_buf.push_back(hex_digits[c & 0xF]);
+            }
+        }
+        m_buf.append(begin, str.end());
+        m_buf.push_back('"');
+    }
+
+    std::string m_buf;
+    bool m_need_comma = false;
+};
+
+/**
+ * An on-demand JSON parser.
+ *
+ * Rather than building a document, the input is a cursor that the generated from_json
+ * functions pull values out of in the order they appear in the text. Members that
+ * aren't needed are skipped over without being decoded.
+ *
+ * Errors don't throw. Once an error is encountered, the input stays failed and every
+ * further read returns false.
+ */
+class input {
+public:
+    explicit input(std::string_view text)
+        : m_text{text} {
+    }
+
+    [[nodiscard]] bool ok() const {
+        return !m_failed;
+    }
+
+    void fail() {
+        m_failed = true;
+    }
+
+    [[nodiscard]] size_t position() const {
+        return m_pos;
+    }
+
+    /**
+     * Returns the first character of the next value, or 0 at the end of the text.
+     */
+    char peek() {
+        skip_whitespace();
+        if (m_pos == m_text.size()) {
+            return 0;
+        }
+        return m_text[m_pos];
+    }
+
+    /**
+     * Checks that nothing but whitespace is left in the text.
+     */
+    [[nodiscard]] bool finish() {
+        if (peek() != 0) {
+            fail();
+        }
+        return ok();
+    }
+
+    [[nodiscard]] bool begin_object() {
+        return open('{');
+    }
+
+    /**
+     * Reads the key of the next member of the current object. Returns false once the
+     * object is over or the input is malformed, check ok() to tell the two apart.
+     *
+     * Keys are returned as they appear in the text, escape sequences aren't decoded.
+     */
+    [[nodiscard]] bool next_key(std::string_view& key) {
+        if (!next('}')) {
+            return false;
+        }
+
+        bool escaped;
+        if (!read_raw_string(key, escaped) || !expect(':')) {
+            return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool begin_array() {
+        return open('[');
+    }
+
+    /**
+     * Returns whether there's another element in the current array. Returns false once
+     * the array is over or the input is malformed.
+     */
+    [[nodiscard]] bool next_element() {
+        return next(']');
+    }
+
+    /**
+     * Counts the remaining elements of the current array without consuming them.
+     */
+    [[nodiscard]] size_t count_elements() const {
+        auto copy = *this;
+        size_t count = 0;
+        while (copy.next_element()) {
+            copy.skip();
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * Skips over the next value, including everything nested in it.
+     */
+    void skip() {
+        skip(0);
+    }
+
+    [[nodiscard]] bool read(bool& res) {
+        if (read_literal("true")) {
+            res = true;
+            return true;
+        }
+        if (read_literal("false")) {
+            res = false;
+            return true;
+        }
+        fail();
+        return false;
+    }
+
+    template<class T,
+             std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>* =
+                 nullptr>
+    [[nodiscard]] bool read(T& res) {
+        if constexpr (std::is_floating_point_v<T>) {
+            // Non-finite numbers are written as null.
+            if (peek() == 'n') {
+                if (!read_literal("null")) {
+                    fail();
+                    return false;
+                }
+                res = std::numeric_limits<T>::quiet_NaN();
+                return true;
+            }
+        }
+
+        skip_whitespace();
+        auto begin = m_pos;
+        while (m_pos < m_text.size() && is_number_char(m_text[m_pos])) {
+            ++m_pos;
+        }
+
+        auto first = m_text.data() + begin;
+        auto last  = m_text.data() + m_pos;
+        auto [ptr, ec] = std::from_chars(first, last, res);
+        if (begin == m_pos || ec != std::errc{} || ptr != last) {
+            fail();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Reads a string without decoding its escape sequences. If escaped is set, the
+     * string must go through unescape before use.
+     */
+    [[nodiscard]] bool read_raw_string(std::string_view& res, bool& escaped) {
+        if (peek() != '"') {
+            fail();
+            return false;
+        }
+
+        auto begin = ++m_pos;
+        escaped    = false;
+        while (true) {
+            auto end = m_text.find_first_of("\"\\", m_pos);
+            if (end == m_text.npos) {
+                fail();
+                return false;
+            }
+            m_pos = end + 1;
+            if (m_text[end] == '"') {
+                res = m_text.substr(begin, end - begin);
+                return true;
+            }
+            escaped = true;
+            ++m_pos;
+        }
+    }
+
+    /**
+     * Decodes the escape sequences in a string returned by read_raw_string.
+     */
+    [[nodiscard]] bool unescape(std::string_view raw, std::string& res) {
+        res.clear();
+        res.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] != '\\') {
+                res.push_back(raw[i]);
+                continue;
+            }
+
+            if (++i == raw.size()) {
+                fail();
+                return false;
+            }
+
+            switch (raw[i]) {
+            case '"':
+            case '\\':
+            case '/':
+                res.push_back(raw[i]);
+                break;
+            case 'b':
+                res.push_back('\b');
+                break;
+            case 'f':
+                res.push_back('\f');
+                break;
+            case 'n':
+                res.push_back('\n');
+                break;
+            case 'r':
+                res.push_back('\r');
+                break;
+            case 't':
+                res.push_back('\t');
+                break;
+            case 'u': {
+                uint32_t code_point;
+                if (!parse_hex4(raw.substr(i + 1), code_point)) {
+                    fail();
+                    return false;
+                }
+                i += 4;
+                uint32_t low;
+                if (code_point >= 0xD800 && code_point < 0xDC00 &&
+                    raw.substr(i + 1, 2) == "\\u" && parse_hex4(raw.substr(i + 3), low) &&
+                    low >= 0xDC00 && low < 0xE000) {
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                append_utf8(res, code_point);
+                break;
+            }
+            default:
+                fail();
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    // Bounds the recursion in skip so that malicious inputs can't overflow the stack.
+    static constexpr int max_depth = 256;
+
+    static bool is_number_char(char c) {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' ||
+               c == 'E';
+    }
+
+    static bool parse_hex4(std::string_view str, uint32_t& res) {
+        if (str.size() < 4) {
+            return false;
+        }
+        auto [ptr, ec] = std::from_chars(str.data(), str.data() + 4, res, 16);
+        return ec == std::errc{} && ptr == str.data() + 4;
+    }
+
+    static void append_utf8(std::string& out, uint32_t code_point) {
+        if (code_point < 0x80) {
+            out.push_back(static_cast<char>(code_point));
+        } else if (code_point < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else if (code_point < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+    }
+
+    void skip_whitespace() {
+        while (m_pos < m_text.size()) {
+            switch (m_text[m_pos]) {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                ++m_pos;
+                continue;
+            }
+            return;
+        }
+    }
+
+    bool expect(char c) {
+        if (peek() != c) {
+            fail();
+            return false;
+        }
+        ++m_pos;
+        return true;
+    }
+
+    bool open(char c) {
+        if (m_failed || !expect(c)) {
+            return false;
+        }
+        m_after_open = true;
+        return true;
+    }
+
+    // Moves past the separator before the next element of an object or array. Returns
+    // false if the closing character was found instead.
+    bool next(char close) {
+        if (m_failed) {
+            return false;
+        }
+
+        if (peek() == close) {
+            ++m_pos;
+            m_after_open = false;
+            return false;
+        }
+
+        if (!m_after_open && !expect(',')) {
+            return false;
+        }
+        m_after_open = false;
+        return true;
+    }
+
+    bool read_literal(std::string_view literal) {
+        skip_whitespace();
+        if (m_text.substr(m_pos, literal.size()) != literal) {
+            return false;
+        }
+        m_pos += literal.size();
+        return true;
+    }
+
+    void skip(int depth) {
+        if (depth > max_depth) {
+            return fail();
+        }
+
+        std::string_view str;
+        bool escaped;
+        switch (peek()) {
+        case '{':
+            (void)begin_object();
+            while (next_key(str)) {
+                skip(depth + 1);
+            }
+            return;
+        case '[':
+            (void)begin_array();
+            while (next_element()) {
+                skip(depth + 1);
+            }
+            return;
+        case '"':
+            (void)read_raw_string(str, escaped);
+            return;
+        case 't':
+        case 'f': {
+            bool b;
+            (void)read(b);
+            return;
+        }
+        case 'n':
+            if (!read_literal("null")) {
+                fail();
+            }
+            return;
+        default: {
+            double d;
+            (void)read(d);
+            return;
+        }
+        }
+    }
+
+    std::string_view m_text;
+    size_t m_pos      = 0;
+    bool m_after_open = false;
+    bool m_failed     = false;
+};
+
+inline void to_json(output& out, bool b) {
+    out.value(b);
+}
+
+template<class T,
+         std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>* = nullptr>
+void to_json(output& out, T t) {
+    out.value(t);
+}
+
+template<class T, std::enable_if_t<std::is_enum_v<T>>* = nullptr>
+void to_json(output& out, T t) {
+    auto index = static_cast<size_t>(t);
+    if (index < enum_traits<T>::names.size()) {
+        return out.value(nameof(t));
+    }
+    out.value(static_cast<std::underlying_type_t<T>>(t));
+}
+
+inline void to_json(output& out, const string& str) {
+    out.value(str.string_view());
+}
+
+template<class T, bool IsReference>
+void to_json(output& out, const vector<T, IsReference>& vec) {
+    out.begin_array();
+    for (auto& elem : vec) {
+        to_json(out, elem);
+    }
+    out.end_array();
+}
+
+template<class T, std::enable_if_t<std::is_arithmetic_v<T>>* = nullptr>
+[[nodiscard]] bool from_json(input& in, message_builder&, std::optional<T>& res) {
+    T t;
+    if (!in.read(t)) {
+        return false;
+    }
+    res = t;
+    return true;
+}
+
+/**
+ * Enumerations are accepted either by the name of a member or by their value.
+ */
+template<class T, std::enable_if_t<std::is_enum_v<T>>* = nullptr>
+[[nodiscard]] bool from_json(input& in, message_builder&, std::optional<T>& res) {
+    if (in.peek() != '"') {
+        std::underlying_type_t<T> val;
+        if (!in.read(val)) {
+            return false;
+        }
+        res = static_cast<T>(val);
+        return true;
+    }
+
+    std::string_view str;
+    bool escaped;
+    if (!in.read_raw_string(str, escaped)) {
+        return false;
+    }
+
+    auto& names = enum_traits<T>::names;
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == str) {
+            res = static_cast<T>(i);
+            return true;
+        }
+    }
+    in.fail();
+    return false;
+}
+
+[[nodiscard]] inline bool
+from_json(input& in, message_builder& builder, const string*& res) {
+    std::string_view str;
+    bool escaped;
+    if (!in.read_raw_string(str, escaped)) {
+        return false;
+    }
+
+    std::string unescaped;
+    if (escaped) {
+        if (!in.unescape(str, unescaped)) {
+            return false;
+        }
+        str = unescaped;
+    }
+
+    if (!fits(builder, sizeof(string) + str.size(), alignof(string))) {
+        return false;
+    }
+    res = &create_string(builder, str);
+    return true;
+}
+
+template<class T, bool IsReference>
+[[nodiscard]] bool
+from_json(input& in, message_builder& builder, const vector<T, IsReference>*& res) {
+    if (!in.begin_array()) {
+        return false;
+    }
+
+    if constexpr (is_ptr<T>{}) {
+        // Elements are allocated in the builder as they are parsed, so the vector can
+        // only be created once all of them are done.
+        using elem_type = typename T::element_type;
+        std::vector<const elem_type*> elems;
+        while (in.next_element()) {
+            const elem_type* elem = nullptr;
+            if (!from_json(in, builder, elem)) {
+                return false;
+            }
+            elems.push_back(elem);
+        }
+
+        if (!in.ok() || !fits_vector<T>(builder, elems.size())) {
+            return false;
+        }
+
+        auto& vec = create_vector_sized<T>(builder, elems.size());
+        for (size_t i = 0; i < elems.size(); ++i) {
+            vec.get_raw().span()[i] = *elems[i];
+        }
+        res = &vec;
+        return true;
+    } else {
+        // Value elements don't touch the builder, so they can be parsed straight into a
+        // vector of the right size.
+        auto count = in.count_elements();
+        if (!fits_vector<T>(builder, count)) {
+            return false;
+        }
+
+        auto& vec = create_vector_sized<T>(builder, count);
+        size_t i  = 0;
+        while (in.next_element()) {
+            std::optional<T> elem;
+            if (i == count || !from_json(in, builder, elem)) {
+                return false;
+            }
+            new (&vec.span()[i++]) T(*elem);
+        }
+        res = &vec;
+        return in.ok();
+    }
+}
+
+/**
+ * Serializes a message into the output, replacing its previous contents.
+ */
+template<class T>
+std::string_view write(output& out, const T& val) {
+    out.clear();
+    to_json(out, val);
+    return out.str();
+}
+
+/**
+ * Parses a message from the given text into the builder. The root object is placed at
+ * the end of the buffer, as every message's is. Returns nullptr if the text is malformed
+ * or the message doesn't fit in the builder.
+ */
+template<class T>
+const T* parse(std::string_view text, message_builder& builder) {
+    input in(text);
+    if constexpr (is_reference_type<T>{}) {
+        const T* res = nullptr;
+        if (!from_json(in, builder, res) || !in.finish()) {
+            return nullptr;
+        }
+        return res;
+    } else {
+        std::optional<T> res;
+        if (!from_json(in, builder, res) || !in.finish() ||
+            !fits(builder, sizeof(T), alignof(T))) {
+            return nullptr;
+        }
+        return &append_raw(builder, *res);
+    }
+}
+} // namespace lidl::json
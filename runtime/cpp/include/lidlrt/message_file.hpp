@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <lidlrt/find_extent.hpp>
+#include <lidlrt/status.hpp>
+#include <tos/span.hpp>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LIDL_HAVE_MMAP
+#endif
+
+namespace lidl {
+/**
+ * Files of lidl messages are a sequence of frames, each being a 4 byte little endian
+ * length followed by that many bytes of a single message. This is the same format
+ * `lidl2yaml --frames` reads.
+ *
+ * Since the root of a message is at its end and all offsets are relative, leading bytes
+ * of a frame are never read. The writer uses this to pad messages with zeroes in front
+ * so that every message starts at a multiple of this alignment, which keeps the members
+ * of a memory mapped message aligned just like they were in the builder.
+ */
+inline constexpr size_t message_file_alignment = 8;
+
+/**
+ * Appends messages to a message file.
+ */
+class message_file_writer {
+public:
+    static status<message_file_writer> open(const char* path) {
+        auto file = std::fopen(path, "ab");
+        if (!file) {
+            return {};
+        }
+
+        if (std::fseek(file, 0, SEEK_END) != 0) {
+            std::fclose(file);
+            return {};
+        }
+
+        auto offset = std::ftell(file);
+        if (offset < 0) {
+            std::fclose(file);
+            return {};
+        }
+
+        return message_file_writer(file, offset);
+    }
+
+    message_file_writer(message_file_writer&& rhs) noexcept
+        : m_file{std::exchange(rhs.m_file, nullptr)}
+        , m_offset{rhs.m_offset} {
+    }
+
+    message_file_writer& operator=(message_file_writer&& rhs) noexcept {
+        std::swap(m_file, rhs.m_file);
+        std::swap(m_offset, rhs.m_offset);
+        return *this;
+    }
+
+    ~message_file_writer() {
+        if (m_file) {
+            std::fclose(m_file);
+        }
+    }
+
+    /**
+     * Appends a single message, as found in the buffer of a message builder.
+     */
+    [[nodiscard]] bool append(tos::span<const uint8_t> message) {
+        constexpr uint8_t zeroes[message_file_alignment]{};
+
+        auto padding = (message_file_alignment -
+                        (m_offset + sizeof(uint32_t)) % message_file_alignment) %
+                       message_file_alignment;
+
+        auto len = static_cast<uint32_t>(padding + message.size());
+        uint8_t header[sizeof len]{uint8_t(len),
+                                   uint8_t(len >> 8),
+                                   uint8_t(len >> 16),
+                                   uint8_t(len >> 24)};
+
+        if (std::fwrite(header, 1, sizeof header, m_file) != sizeof header ||
+            std::fwrite(zeroes, 1, padding, m_file) != padding ||
+            std::fwrite(message.data(), 1, message.size(), m_file) != message.size()) {
+            return false;
+        }
+
+        m_offset += sizeof header + len;
+        return true;
+    }
+
+    [[nodiscard]] bool flush() {
+        return std::fflush(m_file) == 0;
+    }
+
+private:
+    message_file_writer(std::FILE* file, uint64_t offset)
+        : m_file{file}
+        , m_offset{offset} {
+    }
+
+    std::FILE* m_file;
+    uint64_t m_offset;
+};
+
+/**
+ * A read only view of a message file.
+ *
+ * The file is memory mapped where possible, and messages are used right where they are
+ * in the mapping: self relative offsets need no fixups, so there is no parse step.
+ * Opening the file only walks the frame headers to build an index for random access.
+ *
+ * Messages appended after the file is opened are not visible, open the file again to
+ * see them.
+ */
+class message_file {
+public:
+    static status<message_file> open(const char* path) {
+        message_file res;
+        if (!res.load(path)) {
+            return {};
+        }
+        res.build_index();
+        return res;
+    }
+
+    message_file(message_file&& rhs) noexcept
+        : m_map{std::exchange(rhs.m_map, tos::span<const uint8_t>(nullptr))}
+        , m_fallback{std::move(rhs.m_fallback)}
+        , m_index{std::move(rhs.m_index)}
+        , m_truncated{rhs.m_truncated} {
+    }
+
+    message_file& operator=(message_file&& rhs) noexcept {
+        std::swap(m_map, rhs.m_map);
+        std::swap(m_fallback, rhs.m_fallback);
+        std::swap(m_index, rhs.m_index);
+        std::swap(m_truncated, rhs.m_truncated);
+        return *this;
+    }
+
+    ~message_file() {
+#if defined(LIDL_HAVE_MMAP)
+        if (!m_map.empty()) {
+            ::munmap(const_cast<uint8_t*>(m_map.data()), m_map.size());
+        }
+#endif
+    }
+
+    /**
+     * Number of complete messages in the file.
+     */
+    [[nodiscard]] size_t size() const {
+        return m_index.size();
+    }
+
+    [[nodiscard]] tos::span<const uint8_t> operator[](size_t index) const {
+        return m_index[index];
+    }
+
+    /**
+     * Returns the root object of the message at the given index, or nullptr if the
+     * message is too small to hold a T or the root would be misaligned.
+     *
+     * Only the frame is validated, the offsets in the message are trusted. Use
+     * get_verified_root for files that may be corrupted or come from untrusted writers.
+     */
+    template<class T>
+    [[nodiscard]] const T* get_root(size_t index) const {
+        auto message = m_index[index];
+        if (message.size() < sizeof(T)) {
+            return nullptr;
+        }
+
+        auto root = message.data() + message.size() - sizeof(T);
+        if (reinterpret_cast<uintptr_t>(root) % alignof(T) != 0) {
+            return nullptr;
+        }
+        return reinterpret_cast<const T*>(root);
+    }
+
+    /**
+     * Like get_root, but also returns nullptr unless everything the root refers to lies
+     * in the message. This walks the whole message, so it costs as much as reading it.
+     */
+    template<class T>
+    [[nodiscard]] const T* get_verified_root(size_t index) const {
+        auto root = get_root<T>(index);
+        if (!root || !meta::detail::within_bounds(*root, m_index[index])) {
+            return nullptr;
+        }
+        return root;
+    }
+
+    /**
+     * Whether the file ends with a partially written frame, for instance because the
+     * writer crashed. The partial frame is not part of the index.
+     */
+    [[nodiscard]] bool truncated() const {
+        return m_truncated;
+    }
+
+private:
+    message_file() = default;
+
+    tos::span<const uint8_t> data() const {
+        if (!m_map.empty()) {
+            return m_map;
+        }
+        return tos::span<const uint8_t>(m_fallback.data(), m_fallback.size());
+    }
+
+    bool load(const char* path) {
+#if defined(LIDL_HAVE_MMAP)
+        auto fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            auto ptr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED) {
+                m_map = tos::span<const uint8_t>(static_cast<const uint8_t*>(ptr),
+                                                 size_t(st.st_size));
+            }
+        }
+        ::close(fd);
+
+        if (!m_map.empty() || st.st_size == 0) {
+            return true;
+        }
+#endif
+        auto file = std::fopen(path, "rb");
+        if (!file) {
+            return false;
+        }
+
+        uint8_t buf[4096];
+        size_t len;
+        while ((len = std::fread(buf, 1, sizeof buf, file)) > 0) {
+            m_fallback.insert(m_fallback.end(), buf, buf + len);
+        }
+        std::fclose(file);
+        return true;
+    }
+
+    void build_index() {
+        auto all = data();
+        size_t pos = 0;
+        while (pos < all.size()) {
+            if (all.size() - pos < sizeof(uint32_t)) {
+                m_truncated = true;
+                return;
+            }
+
+            auto header = all.data() + pos;
+            uint32_t len = uint32_t(header[0]) | uint32_t(header[1]) << 8 |
+                           uint32_t(header[2]) << 16 | uint32_t(header[3]) << 24;
+            pos += sizeof len;
+
+            if (len > all.size() - pos) {
+                m_truncated = true;
+                return;
+            }
+
+            m_index.push_back(all.slice(pos, len));
+            pos += len;
+        }
+    }
+
+    tos::span<const uint8_t> m_map{nullptr};
+    std::vector<uint8_t> m_fallback;
+    std::vector<tos::span<const uint8_t>> m_index;
+    bool m_truncated = false;
+};
+} // namespace lidl
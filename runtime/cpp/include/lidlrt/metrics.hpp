@@ -0,0 +1,389 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <lidlrt/builder.hpp>
+
+#if defined(LIDL_RPC_METRICS)
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#endif
+
+/**
+ * Per-procedure metrics of the service dispatch: call and error counts, request and
+ * response sizes and latency histograms.
+ *
+ * Metrics are only recorded if LIDL_RPC_METRICS is defined. Otherwise, the recording
+ * functions are empty and compile away.
+ */
+namespace lidl {
+template<class T>
+class service_descriptor;
+
+namespace metrics {
+#if defined(LIDL_RPC_METRICS)
+inline constexpr bool enabled = true;
+
+/**
+ * A histogram of latencies in nanoseconds, with logarithmic buckets that are each
+ * split into linear sub buckets, like HDR histograms. Every value is recorded with a
+ * relative error of at most 1/sub_buckets.
+ */
+struct histogram_layout {
+    static constexpr int sub_bucket_bits = 3;
+    static constexpr uint64_t sub_buckets = 1 << sub_bucket_bits;
+    // Values are clamped to 2^max_value_bits - 1 nanoseconds, about 18 minutes.
+    static constexpr int max_value_bits = 40;
+    static constexpr size_t bucket_count =
+        (max_value_bits - sub_bucket_bits + 1) * sub_buckets;
+
+    static constexpr size_t bucket_of(uint64_t value) {
+        if (value >= (uint64_t(1) << max_value_bits)) {
+            value = (uint64_t(1) << max_value_bits) - 1;
+        }
+        if (value < sub_buckets) {
+            return value;
+        }
+        auto shift = std::bit_width(value) - 1 - sub_bucket_bits;
+        return (shift + 1) * sub_buckets + ((value >> shift) & (sub_buckets - 1));
+    }
+
+    // Smallest value that goes in the bucket after the given one.
+    static constexpr uint64_t upper_bound(size_t bucket) {
+        if (bucket < sub_buckets) {
+            return bucket + 1;
+        }
+        auto shift = bucket / sub_buckets - 1;
+        return (sub_buckets + bucket % sub_buckets + 1) << shift;
+    }
+};
+
+struct histogram_snapshot {
+    std::array<uint64_t, histogram_layout::bucket_count> buckets{};
+
+    uint64_t count() const {
+        uint64_t res = 0;
+        for (auto n : buckets) {
+            res += n;
+        }
+        return res;
+    }
+
+    /**
+     * Returns an upper bound of the value at the given quantile, which is between 0
+     * and 1. Returns 0 for an empty histogram.
+     */
+    uint64_t value_at_quantile(double quantile) const {
+        auto total = count();
+        if (total == 0) {
+            return 0;
+        }
+        auto rank = static_cast<uint64_t>(quantile * (total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return histogram_layout::upper_bound(i);
+            }
+        }
+        return histogram_layout::upper_bound(buckets.size() - 1);
+    }
+};
+
+struct procedure_snapshot {
+    std::string_view service;
+    std::string_view procedure;
+    uint64_t calls          = 0;
+    uint64_t errors         = 0;
+    uint64_t request_bytes  = 0;
+    uint64_t response_bytes = 0;
+    uint64_t latency_sum_ns = 0;
+    histogram_snapshot latency;
+};
+
+namespace detail {
+/**
+ * A counter that only its own thread writes to. Readers on other threads may see a
+ * slightly stale value, but never a torn one, and writers don't need atomic
+ * read-modify-write instructions.
+ */
+class local_counter {
+public:
+    void add(uint64_t n) {
+        m_val.store(m_val.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    uint64_t get() const {
+        return m_val.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> m_val{0};
+};
+
+struct procedure_counters {
+    local_counter calls;
+    local_counter errors;
+    local_counter request_bytes;
+    local_counter response_bytes;
+    local_counter latency_sum_ns;
+    std::array<local_counter, histogram_layout::bucket_count> latency;
+
+    void add_to(procedure_snapshot& snap) const {
+        snap.calls += calls.get();
+        snap.errors += errors.get();
+        snap.request_bytes += request_bytes.get();
+        snap.response_bytes += response_bytes.get();
+        snap.latency_sum_ns += latency_sum_ns.get();
+        for (size_t i = 0; i < latency.size(); ++i) {
+            snap.latency.buckets[i] += latency[i].get();
+        }
+    }
+};
+
+// The counters of the procedures of a service on one thread.
+struct thread_counters {
+    explicit thread_counters(size_t procedures)
+        : procs(std::make_unique<procedure_counters[]>(procedures)) {
+    }
+
+    std::unique_ptr<procedure_counters[]> procs;
+};
+
+struct service_entry {
+    std::string_view name;
+    std::vector<std::string_view> procedures;
+    // Counters of threads that have exited are kept, so that totals don't go backwards.
+    std::vector<std::shared_ptr<thread_counters>> threads;
+};
+
+/**
+ * Every service that recorded a call, and the counters of every thread that made
+ * one. The lock is only taken when a thread makes its first call to a service, and
+ * when the metrics are collected.
+ */
+class registry {
+public:
+    static registry& instance() {
+        static registry reg;
+        return reg;
+    }
+
+    template<class ServiceT>
+    std::shared_ptr<thread_counters> add_thread() {
+        static service_entry& entry = add_service<ServiceT>();
+        auto res = std::make_shared<thread_counters>(entry.procedures.size());
+        std::lock_guard lock(m_mutex);
+        entry.threads.push_back(res);
+        return res;
+    }
+
+    std::vector<procedure_snapshot> collect() {
+        std::vector<procedure_snapshot> res;
+        std::lock_guard lock(m_mutex);
+        for (auto& serv : m_services) {
+            for (size_t i = 0; i < serv.procedures.size(); ++i) {
+                procedure_snapshot snap;
+                snap.service   = serv.name;
+                snap.procedure = serv.procedures[i];
+                for (auto& thread : serv.threads) {
+                    thread->procs[i].add_to(snap);
+                }
+                res.push_back(snap);
+            }
+        }
+        return res;
+    }
+
+private:
+    template<class ServiceT>
+    service_entry& add_service() {
+        using descriptor = service_descriptor<ServiceT>;
+        std::lock_guard lock(m_mutex);
+        auto& entry = m_services.emplace_back();
+        entry.name  = descriptor::name;
+        std::apply(
+            [&](auto&... procs) { (entry.procedures.push_back(procs.name), ...); },
+            descriptor::procedures);
+        return entry;
+    }
+
+    std::mutex m_mutex;
+    std::deque<service_entry> m_services;
+};
+
+template<class ServiceT>
+procedure_counters& local_counters(int procedure) {
+    thread_local auto counters = registry::instance().add_thread<ServiceT>();
+    return counters->procs[procedure];
+}
+} // namespace detail
+
+/**
+ * Returns the totals of every procedure of every service that has been called so far,
+ * over all threads.
+ */
+inline std::vector<procedure_snapshot> collect() {
+    return detail::registry::instance().collect();
+}
+
+/**
+ * Formats the given metrics in the Prometheus text exposition format.
+ *
+ * Latency histograms are reported in seconds, with a bucket for every power of two
+ * nanoseconds between 64 nanoseconds and 17 seconds.
+ */
+inline std::string format_prometheus(const std::vector<procedure_snapshot>& procs) {
+    std::string res;
+
+    auto labels = [](const procedure_snapshot& proc) {
+        std::string res = "service=\"";
+        res += proc.service;
+        res += "\",procedure=\"";
+        res += proc.procedure;
+        res += '"';
+        return res;
+    };
+
+    auto seconds = [](uint64_t ns) {
+        char buf[32];
+        std::snprintf(buf, sizeof buf, "%.9g", ns / 1e9);
+        return std::string(buf);
+    };
+
+    auto counter = [&](std::string_view name,
+                       std::string_view help,
+                       uint64_t procedure_snapshot::*field) {
+        res += "# HELP ";
+        res += name;
+        res += ' ';
+        res += help;
+        res += "\n# TYPE ";
+        res += name;
+        res += " counter\n";
+        for (auto& proc : procs) {
+            res += name;
+            res += '{' + labels(proc) + "} " + std::to_string(proc.*field) + '\n';
+        }
+    };
+
+    counter("lidl_rpc_calls_total", "Calls to the procedure.", &procedure_snapshot::calls);
+    counter("lidl_rpc_errors_total",
+            "Calls to the procedure that failed.",
+            &procedure_snapshot::errors);
+    counter("lidl_rpc_request_bytes_total",
+            "Bytes of the requests to the procedure.",
+            &procedure_snapshot::request_bytes);
+    counter("lidl_rpc_response_bytes_total",
+            "Bytes of the responses of the procedure.",
+            &procedure_snapshot::response_bytes);
+
+    res += "# HELP lidl_rpc_latency_seconds Time spent running the procedure.\n";
+    res += "# TYPE lidl_rpc_latency_seconds histogram\n";
+    for (auto& proc : procs) {
+        // Powers of two are bucket boundaries, so these counts are exact.
+        constexpr int first_bound = 6;
+        constexpr int last_bound  = 34;
+        uint64_t cumulative       = 0;
+        size_t bucket             = 0;
+        for (int bound = first_bound; bound <= last_bound; ++bound) {
+            auto limit = uint64_t(1) << bound;
+            for (; bucket < proc.latency.buckets.size() &&
+                   histogram_layout::upper_bound(bucket) <= limit;
+                 ++bucket) {
+                cumulative += proc.latency.buckets[bucket];
+            }
+            res += "lidl_rpc_latency_seconds_bucket{" + labels(proc) + ",le=\"" +
+                   seconds(limit) + "\"} " + std::to_string(cumulative) + '\n';
+        }
+        res += "lidl_rpc_latency_seconds_bucket{" + labels(proc) + ",le=\"+Inf\"} " +
+               std::to_string(proc.latency.count()) + '\n';
+        res += "lidl_rpc_latency_seconds_sum{" + labels(proc) + "} " +
+               seconds(proc.latency_sum_ns) + '\n';
+        res += "lidl_rpc_latency_seconds_count{" + labels(proc) + "} " +
+               std::to_string(proc.latency.count()) + '\n';
+    }
+
+    return res;
+}
+
+/**
+ * Records a call to a procedure of ServiceT, from its construction to its
+ * destruction. Calls that aren't marked as succeeded by then are counted as errors,
+ * including the ones that end with an exception.
+ */
+template<class ServiceT>
+class call_scope {
+public:
+    call_scope(int procedure, const message_builder& response)
+        : m_procedure{procedure}
+        , m_response{&response}
+        , m_response_begin{response.size()}
+        , m_begin{std::chrono::steady_clock::now()} {
+    }
+
+    call_scope(const call_scope&) = delete;
+    call_scope& operator=(const call_scope&) = delete;
+
+    void succeeded(bool ok = true) {
+        m_ok = ok;
+    }
+
+    ~call_scope() {
+        auto end = std::chrono::steady_clock::now();
+        auto ns  = std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_begin);
+
+        auto& counters = detail::local_counters<ServiceT>(m_procedure);
+        counters.calls.add(1);
+        if (!m_ok) {
+            counters.errors.add(1);
+        }
+        counters.response_bytes.add(m_response->size() - m_response_begin);
+        counters.latency_sum_ns.add(ns.count());
+        counters.latency[histogram_layout::bucket_of(ns.count())].add(1);
+    }
+
+private:
+    int m_procedure;
+    bool m_ok = false;
+    const message_builder* m_response;
+    size_t m_response_begin;
+    std::chrono::steady_clock::time_point m_begin;
+};
+
+/**
+ * Records the size of a request to a procedure of ServiceT.
+ */
+template<class ServiceT>
+void record_request(int procedure, size_t bytes) {
+    detail::local_counters<ServiceT>(procedure).request_bytes.add(bytes);
+}
+#else
+inline constexpr bool enabled = false;
+
+template<class ServiceT>
+class call_scope {
+public:
+    call_scope(int, const message_builder&) {
+    }
+
+    void succeeded(bool = true) {
+    }
+};
+
+template<class ServiceT>
+void record_request(int, size_t) {
+}
+#endif
+} // namespace metrics
+} // namespace lidl
@@ -0,0 +1,577 @@
+#pragma once
+
+#include <cstring>
+#include <lidlrt/arena.hpp>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/lidl.hpp>
+#include <optional>
+#include <pybind11/pybind11.h>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Python bindings for generated lidl types, used by the code the pybind backend of lidlc
+ * generates.
+ *
+ * Messages are read in place: decoding a buffer returns objects that point into the
+ * buffer, and members are only converted to python values when they are accessed.
+ * Vectors and arrays of numbers are returned as zero copy memoryviews.
+ *
+ * Messages are built straight into a message builder from python values, dictionaries
+ * for structures and unions, without going through the pure python runtime.
+ */
+namespace lidl::python {
+namespace py = pybind11;
+
+namespace detail {
+template<class T>
+struct is_vector : std::false_type {};
+
+template<class T, bool IsReference>
+struct is_vector<vector<T, IsReference>> : std::true_type {};
+
+template<class T>
+struct is_array : std::false_type {};
+
+template<class T, std::size_t N, bool IsReference>
+struct is_array<array<T, N, IsReference>> : std::true_type {};
+
+// Arrays are stored inline in their parent. Arrays of pointers can't be built outside of
+// their parent as the offsets are relative to the array itself, and arrays of other
+// objects would need to construct their elements separately.
+template<class T>
+struct is_buildable : std::true_type {};
+
+template<class T, std::size_t N, bool IsReference>
+struct is_buildable<array<T, N, IsReference>>
+    : std::bool_constant<std::is_arithmetic_v<T> || std::is_enum_v<T>> {};
+
+// Builder objects are stored in slots until their parent can be constructed. Reference
+// types are created in the builder right away, so their slots are pointers. Value
+// types are kept in an optional.
+template<class T>
+using slot_t =
+    std::conditional_t<is_reference_type<T>{}, const T*, std::optional<T>>;
+
+[[noreturn]] inline void does_not_fit() {
+    throw py::value_error("message does not fit in the builder");
+}
+
+template<class T>
+bool compatible_format(const py::buffer_info& info) {
+    if (info.ndim != 1 || info.itemsize != sizeof(T) ||
+        (info.shape[0] > 1 && info.strides[0] != info.itemsize)) {
+        return false;
+    }
+
+    std::string_view format = info.format;
+    if (format.size() == 2 && (format[0] == '<' || format[0] == '=' || format[0] == '@')) {
+        format.remove_prefix(1);
+    }
+    if (format.size() != 1) {
+        return false;
+    }
+
+    auto c = format[0];
+    if constexpr (std::is_same_v<T, bool>) {
+        return c == '?';
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return c == 'f' || c == 'd';
+    } else if constexpr (std::is_signed_v<T>) {
+        return std::string_view("bhilq").find(c) != std::string_view::npos;
+    } else {
+        return std::string_view("BHILQ").find(c) != std::string_view::npos;
+    }
+}
+
+inline py::object get_member(py::handle obj, const char* name) {
+    if (py::isinstance<py::dict>(obj)) {
+        return py::reinterpret_borrow<py::dict>(obj)[name];
+    }
+    return obj.attr(name);
+}
+} // namespace detail
+
+/**
+ * Exposes memory owned by another python object through the buffer protocol, and keeps
+ * that object alive for as long as the memory is in use.
+ */
+struct memory_view {
+    py::object owner;
+    const void* data;
+    py::ssize_t count;
+    py::ssize_t item_size;
+    std::string format;
+};
+
+template<class T>
+py::object make_view(py::handle owner, const T* data, size_t count) {
+    return py::memoryview(py::cast(memory_view{py::reinterpret_borrow<py::object>(owner),
+                                               data,
+                                               py::ssize_t(count),
+                                               sizeof(T),
+                                               py::format_descriptor<T>::format()}));
+}
+
+/**
+ * A message builder over storage owned by the python object.
+ */
+class builder {
+public:
+    explicit builder(size_t capacity)
+        : m_storage(std::min(capacity, message_arena::max_buffer_size))
+        , m_builder(tos::span<uint8_t>(m_storage.data(), m_storage.size())) {
+    }
+
+    // The message builder points into the storage.
+    builder(const builder&) = delete;
+    builder& operator=(const builder&) = delete;
+
+    void reset() {
+        m_builder = message_builder(tos::span<uint8_t>(m_storage.data(), m_storage.size()));
+    }
+
+    message_builder& get() {
+        return m_builder;
+    }
+
+    tos::span<const uint8_t> message() const {
+        return m_builder.get_buffer();
+    }
+
+private:
+    std::vector<uint8_t> m_storage;
+    message_builder m_builder;
+};
+
+template<class T>
+py::object to_python(const T& val, py::handle owner);
+
+template<class Elems>
+py::object elements_to_python(const Elems& elems, py::handle owner) {
+    py::list res(elems.size());
+    size_t i = 0;
+    for (auto& elem : elems) {
+        res[i++] = to_python(elem, owner);
+    }
+    return res;
+}
+
+/**
+ * Converts a member of a message to a python object. Numbers and strings are copied,
+ * anything else refers to the message, and keeps the owner of the message alive.
+ */
+template<class T>
+py::object to_python(const T& val, py::handle owner) {
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+        return py::cast(val);
+    } else if constexpr (std::is_same_v<T, string>) {
+        auto sv = val.string_view();
+        return py::str(sv.data(), sv.size());
+    } else if constexpr (is_ptr<T>{}) {
+        return to_python(val.unsafe().get(), owner);
+    } else if constexpr (detail::is_vector<T>{} || detail::is_array<T>{}) {
+        using elem_type = meta::remove_cref<decltype(*val.begin())>;
+        if constexpr (std::is_arithmetic_v<elem_type> && detail::is_vector<T>{}) {
+            return make_view(owner, val.span().data(), val.size());
+        } else if constexpr (std::is_arithmetic_v<elem_type>) {
+            return make_view(owner, val.data(), val.size());
+        } else {
+            return elements_to_python(val, owner);
+        }
+    } else {
+        return py::cast(&val, py::return_value_policy::reference_internal, owner);
+    }
+}
+
+template<class T>
+py::object to_python(const T* val, py::handle owner) {
+    if (!val) {
+        return py::none();
+    }
+    return to_python(*val, owner);
+}
+
+template<class T>
+void from_python(py::handle obj, message_builder& builder, detail::slot_t<T>& res);
+
+template<class T, class... Ms, std::size_t... Is>
+void struct_from_python(py::handle obj,
+                        message_builder& builder,
+                        detail::slot_t<T>& res,
+                        meta::list<Ms...>,
+                        std::index_sequence<Is...>) {
+    if constexpr (!(detail::is_buildable<Ms>{} && ...)) {
+        throw py::type_error(std::string(struct_traits<T>::name) +
+                             " can't be built from python");
+    } else {
+        std::tuple<detail::slot_t<Ms>...> slots;
+        (from_python<Ms>(
+             detail::get_member(obj, std::get<Is>(struct_traits<T>::members).name),
+             builder,
+             std::get<Is>(slots)),
+         ...);
+
+        if constexpr (is_reference_type<T>{}) {
+            res = try_create<T>(builder, *std::get<Is>(slots)...);
+            if (!res) {
+                detail::does_not_fit();
+            }
+        } else {
+            res.emplace(*std::get<Is>(slots)...);
+        }
+    }
+}
+
+template<class T, std::size_t I, class... Ms>
+bool alternative_from_python(std::string_view key,
+                             py::handle val,
+                             message_builder& builder,
+                             detail::slot_t<T>& res,
+                             meta::list<Ms...>) {
+    if (key != std::get<I>(union_traits<T>::members).name) {
+        return false;
+    }
+
+    using member_type = std::tuple_element_t<I, std::tuple<Ms...>>;
+    detail::slot_t<member_type> slot;
+    from_python<member_type>(val, builder, slot);
+
+    if constexpr (is_reference_type<T>{}) {
+        if (!fits(builder, sizeof(T), alignof(T))) {
+            detail::does_not_fit();
+        }
+        res = &std::get<I>(union_traits<T>::ctors)(builder, *slot);
+    } else {
+        res.emplace(*slot);
+    }
+    return true;
+}
+
+template<class T, std::size_t... Is>
+void union_from_python(py::handle obj,
+                       message_builder& builder,
+                       detail::slot_t<T>& res,
+                       std::index_sequence<Is...>) {
+    auto dict = obj.cast<py::dict>();
+    if (dict.size() != 1) {
+        throw py::value_error("a union must have exactly one alternative");
+    }
+
+    auto [key, val] = *dict.begin();
+    auto name       = key.cast<std::string_view>();
+    if (!(alternative_from_python<T, Is>(
+              name, val, builder, res, typename union_traits<T>::types{}) ||
+          ...)) {
+        throw py::key_error(std::string(name));
+    }
+}
+
+template<class T>
+void enum_from_python(py::handle obj, std::optional<T>& res) {
+    if (py::isinstance<py::str>(obj)) {
+        auto name   = obj.cast<std::string_view>();
+        auto& names = enum_traits<T>::names;
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == name) {
+                res = static_cast<T>(i);
+                return;
+            }
+        }
+        throw py::value_error(std::string(name) + " is not a member of " +
+                              std::string(enum_traits<T>::name));
+    }
+
+    if (py::isinstance<py::int_>(obj)) {
+        res = static_cast<T>(obj.cast<std::underlying_type_t<T>>());
+        return;
+    }
+
+    res = obj.cast<T>();
+}
+
+template<class T, std::size_t N>
+void array_from_python(py::handle obj,
+                       message_builder& builder,
+                       std::optional<array<T, N, false>>& res) {
+    if (py::len(obj) != N) {
+        throw py::value_error("expected a sequence of " + std::to_string(N) + " elements");
+    }
+
+    auto& arr = res.emplace();
+    size_t i  = 0;
+    for (auto item : obj) {
+        std::optional<T> elem;
+        from_python<T>(item, builder, elem);
+        arr[i++] = *elem;
+    }
+}
+
+template<class T, bool IsReference>
+void vector_from_python(py::handle obj,
+                        message_builder& builder,
+                        const vector<T, IsReference>*& res) {
+    if constexpr (std::is_arithmetic_v<T>) {
+        // Buffers of the right format, such as numpy arrays, are copied in one go.
+        if (PyObject_CheckBuffer(obj.ptr())) {
+            auto info = py::reinterpret_borrow<py::buffer>(obj).request();
+            if (detail::compatible_format<T>(info)) {
+                if (!fits_vector<T>(builder, info.size)) {
+                    detail::does_not_fit();
+                }
+                auto& vec = create_vector_sized<T>(builder, info.size);
+                std::memcpy(vec.span().data(), info.ptr, info.size * sizeof(T));
+                res = &vec;
+                return;
+            }
+        }
+    }
+
+    if constexpr (is_ptr<T>{}) {
+        // Elements are created in the builder one by one, so the vector can only be
+        // created once all of them are done.
+        using elem_type = typename T::element_type;
+        std::vector<const elem_type*> elems;
+        for (auto item : obj) {
+            const elem_type* elem = nullptr;
+            from_python<elem_type>(item, builder, elem);
+            elems.push_back(elem);
+        }
+
+        if (!fits_vector<T>(builder, elems.size())) {
+            detail::does_not_fit();
+        }
+        auto& vec = create_vector_sized<T>(builder, elems.size());
+        for (size_t i = 0; i < elems.size(); ++i) {
+            vec.get_raw().span()[i] = *elems[i];
+        }
+        res = &vec;
+    } else {
+        // Value elements don't touch the builder, so they can be converted straight into
+        // a vector of the right size.
+        auto count = py::len(obj);
+        if (!fits_vector<T>(builder, count)) {
+            detail::does_not_fit();
+        }
+        auto& vec = create_vector_sized<T>(builder, count);
+        size_t i  = 0;
+        for (auto item : obj) {
+            if (i == count) {
+                throw py::value_error("sequence changed size while building a vector");
+            }
+            std::optional<T> elem;
+            from_python<T>(item, builder, elem);
+            new (&vec.span()[i++]) T(*elem);
+        }
+        res = &vec;
+    }
+}
+
+/**
+ * Converts a python object to a lidl object of type T in the builder. Structures are
+ * read from dictionaries or objects with attributes named after their members, and
+ * unions from dictionaries with a single key naming the alternative.
+ *
+ * Throws a python exception if the object can't be converted or the message doesn't
+ * fit in the builder.
+ */
+template<class T>
+void from_python(py::handle obj, message_builder& builder, detail::slot_t<T>& res) {
+    if constexpr (std::is_enum_v<T>) {
+        enum_from_python(obj, res);
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        res = obj.cast<T>();
+    } else if constexpr (std::is_same_v<T, string>) {
+        auto str = obj.cast<std::string_view>();
+        if (!fits(builder, sizeof(string) + str.size(), alignof(string))) {
+            detail::does_not_fit();
+        }
+        res = &create_string(builder, str);
+    } else if constexpr (detail::is_vector<T>{}) {
+        vector_from_python(obj, builder, res);
+    } else if constexpr (detail::is_array<T>{} && detail::is_buildable<T>{}) {
+        array_from_python(obj, builder, res);
+    } else if constexpr (is_struct<T>{}) {
+        using traits = struct_traits<T>;
+        struct_from_python<T>(obj,
+                              builder,
+                              res,
+                              typename traits::raw_members{},
+                              std::make_index_sequence<traits::arity>{});
+    } else if constexpr (is_union<T>{}) {
+        union_from_python<T>(
+            obj,
+            builder,
+            res,
+            std::make_index_sequence<
+                std::tuple_size_v<decltype(union_traits<T>::members)>>{});
+    } else {
+        res = obj.cast<T>();
+    }
+}
+
+/**
+ * Builds a message with a root object of type T in the builder, and returns the root.
+ */
+template<class T>
+const T& build(message_builder& builder, py::handle obj) {
+    detail::slot_t<T> res;
+    from_python<T>(obj, builder, res);
+
+    if constexpr (is_reference_type<T>{}) {
+        return *res;
+    } else {
+        auto root = try_create<T>(builder, *res);
+        if (!root) {
+            detail::does_not_fit();
+        }
+        return *root;
+    }
+}
+
+/**
+ * Returns the root object of type T of the message in the given python buffer.
+ *
+ * The buffer is exported for as long as the root is alive, so a bytearray can't be
+ * resized underneath it. Only the size and alignment of the root are validated, the
+ * offsets in the message are trusted.
+ */
+template<class T>
+py::object get_root(py::handle buf) {
+    py::memoryview view(py::reinterpret_borrow<py::object>(buf));
+    auto info = PyMemoryView_GET_BUFFER(view.ptr());
+    if (!PyBuffer_IsContiguous(info, 'C')) {
+        throw py::value_error("message buffer must be contiguous");
+    }
+
+    if (size_t(info->len) < sizeof(T)) {
+        throw py::value_error("message buffer is too small");
+    }
+
+    auto root = static_cast<const uint8_t*>(info->buf) + info->len - sizeof(T);
+    if (reinterpret_cast<uintptr_t>(root) % alignof(T) != 0) {
+        throw py::value_error("message root is misaligned");
+    }
+
+    return py::cast(reinterpret_cast<const T*>(root),
+                    py::return_value_policy::reference_internal,
+                    view);
+}
+
+/**
+ * Builds a message from the python object in a buffer of this thread's arena, and
+ * returns a copy of it.
+ */
+template<class T>
+py::bytes encode(py::handle obj) {
+    auto buf = message_arena::this_thread().get(message_arena::max_buffer_size);
+    message_builder mb(buf);
+    build<T>(mb, obj);
+    buf.resize(mb.size());
+    return py::bytes(reinterpret_cast<const char*>(buf.data()), buf.size());
+}
+
+/**
+ * Registers the classes every module of bindings uses. Bindings of different lidl
+ * modules can be loaded in the same interpreter, so these are local to the module.
+ */
+inline void bind_runtime(py::module& m) {
+    py::class_<memory_view>(m, "view", py::buffer_protocol(), py::module_local())
+        .def_buffer([](memory_view& view) {
+            return py::buffer_info(const_cast<void*>(view.data),
+                                   view.item_size,
+                                   view.format,
+                                   1,
+                                   {view.count},
+                                   {view.item_size},
+                                   /*readonly=*/true);
+        });
+
+    py::class_<builder>(m, "Builder", py::module_local())
+        .def(py::init<size_t>(), py::arg("capacity") = message_arena::max_buffer_size)
+        .def("reset", &builder::reset)
+        .def_property_readonly("size",
+                               [](const builder& b) { return b.message().size(); })
+        .def("view",
+             [](py::object self) {
+                 auto message = self.cast<const builder&>().message();
+                 return make_view(self, message.data(), message.size());
+             })
+        .def("bytes", [](const builder& b) {
+            auto message = b.message();
+            return py::bytes(reinterpret_cast<const char*>(message.data()),
+                             message.size());
+        });
+}
+
+template<class T>
+void bind_enum(py::handle scope, const char* name) {
+    py::enum_<T> bind(scope, name, py::module_local());
+    auto& names = enum_traits<T>::names;
+    for (size_t i = 0; i < names.size(); ++i) {
+        bind.value(std::string(names[i]).c_str(), static_cast<T>(i));
+    }
+}
+
+template<class T>
+void bind_codec(py::class_<T>& cls) {
+    cls.def_static("from_buffer", &get_root<T>, py::arg("buffer"))
+        .def_static(
+            "build",
+            [](builder& b, py::handle obj) -> const T& { return build<T>(b.get(), obj); },
+            py::arg("builder"),
+            py::arg("value"),
+            py::return_value_policy::reference_internal)
+        .def_static("encode", &encode<T>, py::arg("value"));
+}
+
+template<class T>
+void bind_struct(py::module& m, const char* name) {
+    py::class_<T> cls(m, name, py::module_local());
+    bind_codec(cls);
+
+    std::apply(
+        [&cls](const auto&... members) {
+            (cls.def_property_readonly(members.name,
+                                       [fn = members.const_function](py::object self) {
+                                           auto& val = self.cast<const T&>();
+                                           return to_python((val.*fn)(), self);
+                                       }),
+             ...);
+        },
+        struct_traits<T>::members);
+}
+
+template<class T, std::size_t... Is>
+void bind_alternatives(py::class_<T>& cls, std::index_sequence<Is...>) {
+    // Members that are not the active alternative read as None.
+    (cls.def_property_readonly(
+         std::get<Is>(union_traits<T>::members).name,
+         [](py::object self) -> py::object {
+             auto& val = self.cast<const T&>();
+             if (val.alternative() != static_cast<typename T::alternatives>(Is)) {
+                 return py::none();
+             }
+             auto fn = std::get<Is>(union_traits<T>::members).const_function;
+             return to_python((val.*fn)(), self);
+         }),
+     ...);
+}
+
+template<class T>
+void bind_union(py::module& m, const char* name) {
+    py::class_<T> cls(m, name, py::module_local());
+    bind_enum<typename T::alternatives>(cls, "alternatives");
+    bind_codec(cls);
+
+    cls.def_property_readonly("alternative",
+                              [](const T& val) { return val.alternative(); });
+    bind_alternatives(
+        cls,
+        std::make_index_sequence<std::tuple_size_v<decltype(union_traits<T>::members)>>{});
+}
+} // namespace lidl::python
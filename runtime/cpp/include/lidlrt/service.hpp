@@ -6,7 +6,10 @@
 
 #include <cstring>
 #include <lidlrt/builder.hpp>
+#include <lidlrt/envelope.hpp>
+#include <lidlrt/interceptor.hpp>
 #include <lidlrt/meta.hpp>
+#include <lidlrt/metrics.hpp>
 #include <lidlrt/status.hpp>
 #include <string_view>
 #include <tos/task.hpp>
@@ -63,6 +66,15 @@ class async_service_base : public service_base {};
 template<class T>
 tos::span<uint8_t> as_span(T&);
 
+/**
+ * Packs the parameters of a call as pointers to them, which is how zerocopy clients
+ * pass parameters to the procedures of a zerocopy vtable.
+ */
+template<class... Ts>
+std::tuple<Ts*...> make_params_tuple(Ts&... params) {
+    return std::tuple<Ts*...>(&params...);
+}
+
 namespace meta {
 template<class... ParamsT>
 struct get_result_type_impl;
@@ -104,11 +116,13 @@ template<class>
 class print;
 
 namespace detail {
-template<class ServiceT, class BaseServT = ServiceT>
-tos::Task<bool>
-async_union_caller(BaseServT& base_service,
-                   typename ServiceT::service_type::wire_types::call_union& call_union,
-                   lidl::message_builder& response) {
+template<class ServiceT, class BaseServT = ServiceT, class ChainT>
+tos::Task<bool> intercepted_async_union_caller(
+    ChainT& chain,
+    BaseServT& base_service,
+    typename ServiceT::service_type::wire_types::call_union& call_union,
+    lidl::message_builder& response,
+    call_envelope envelope = {}) {
     /**
      * Don't panic!
      *
@@ -126,9 +140,13 @@ async_union_caller(BaseServT& base_service,
     using all_results =
         typename meta::get_result_type_impl<decltype(descriptor::procedures)>::results;
 
+    // The procedure inherits the token of this task, and stops at the caller's deadline.
+    tos::cancellation_token token = co_await tos::current_token();
+    token = token.with_deadline(envelope.deadline);
+
     co_return co_await visit(
-        [&service = static_cast<ServiceT&>(base_service),
-         &response](auto& call_params) -> tos::Task<bool> {
+        [&service = static_cast<ServiceT&>(base_service), &response, &chain, &envelope,
+         &token](auto& call_params) -> tos::Task<bool> {
             constexpr auto idx = meta::tuple_index_of<
                 std::remove_const_t<std::remove_reference_t<decltype(call_params)>>,
                 all_params>::value;
@@ -199,15 +217,43 @@ async_union_caller(BaseServT& base_service,
                 co_return true;
             };
 
-            co_return co_await apply(make_service_call, call_params);
+            metrics::call_scope<typename ServiceT::service_type> call(idx, response);
+            tracing::server_span<typename ServiceT::service_type> span(
+                idx, envelope.trace, false);
+            // Nobody would read the response of a cancelled call, so it isn't computed.
+            if (token.cancelled()) {
+                co_return false;
+            }
+            auto task = chain.run_async(
+                call_info<typename ServiceT::service_type, idx>{},
+                [&] { return apply(make_service_call, call_params); });
+            task.set_token(token);
+            auto res = co_await task && !token.cancelled();
+            call.succeeded(res);
+            span.succeeded(res);
+            co_return res;
         },
         call_union);
 }
 
 template<class ServiceT, class BaseServT = ServiceT>
-bool union_caller(BaseServT& base_service,
-                  typename ServiceT::service_type::wire_types::call_union& call_union,
-                  lidl::message_builder& response) {
+tos::Task<bool>
+async_union_caller(BaseServT& base_service,
+                   typename ServiceT::service_type::wire_types::call_union& call_union,
+                   lidl::message_builder& response) {
+    // The task refers to the chain until it's done, which this one outlives.
+    static interceptor_chain<> chain;
+    return intercepted_async_union_caller<ServiceT, BaseServT>(
+        chain, base_service, call_union, response);
+}
+
+template<class ServiceT, class BaseServT = ServiceT, class ChainT>
+bool intercepted_union_caller(
+    ChainT& chain,
+    BaseServT& base_service,
+    typename ServiceT::service_type::wire_types::call_union& call_union,
+    lidl::message_builder& response,
+    const call_envelope& envelope = {}) {
     /**
      * Don't panic!
      *
@@ -226,8 +272,8 @@ bool union_caller(BaseServT& base_service,
         typename meta::get_result_type_impl<decltype(descriptor::procedures)>::results;
 
     return visit(
-        [&service = static_cast<ServiceT&>(base_service),
-         &response](auto& call_params) -> decltype(auto) {
+        [&service = static_cast<ServiceT&>(base_service), &response, &chain, &envelope](
+            auto& call_params) -> decltype(auto) {
             constexpr auto idx = meta::tuple_index_of<
                 std::remove_const_t<std::remove_reference_t<decltype(call_params)>>,
                 all_params>::value;
@@ -296,43 +342,156 @@ bool union_caller(BaseServT& base_service,
                 return true;
             };
 
-            return apply(make_service_call, call_params);
+            metrics::call_scope<typename ServiceT::service_type> call(idx, response);
+            tracing::server_span<typename ServiceT::service_type> span(
+                idx, envelope.trace, true);
+            if (envelope.expired()) {
+                return false;
+            }
+            auto res = chain.run(call_info<typename ServiceT::service_type, idx>{},
+                                 [&] { return apply(make_service_call, call_params); });
+            call.succeeded(res);
+            span.succeeded(res);
+            return res;
         },
         call_union);
 }
 
+template<class ServiceT, class BaseServT = ServiceT>
+bool union_caller(BaseServT& base_service,
+                  typename ServiceT::service_type::wire_types::call_union& call_union,
+                  lidl::message_builder& response) {
+    interceptor_chain<> chain;
+    return intercepted_union_caller<ServiceT, BaseServT>(
+        chain, base_service, call_union, response);
+}
+
+template<class ServiceT, class BaseServT = ServiceT, class ChainT>
+tos::Task<bool> intercepted_async_request_handler(ChainT& chain,
+                                                  BaseServT& base_service,
+                                                  tos::span<uint8_t> buffer,
+                                                  lidl::message_builder& response) {
+    static_assert(std::is_base_of_v<BaseServT, ServiceT>);
+    using descriptor = service_descriptor<typename ServiceT::service_type>;
+
+    using params_union = typename descriptor::params_union;
+
+    auto envelope = extract_envelope(buffer);
+    auto& call    = get_root<params_union>(buffer);
+    metrics::record_request<typename ServiceT::service_type>(
+        static_cast<int>(call.alternative()), buffer.size());
+    return intercepted_async_union_caller<ServiceT, BaseServT>(
+        chain, base_service, call, response, envelope);
+}
+
 template<class ServiceT, class BaseServT = ServiceT>
 tos::Task<bool> async_request_handler(BaseServT& base_service,
                                       tos::span<uint8_t> buffer,
                                       lidl::message_builder& response) {
+    static interceptor_chain<> chain;
+    return intercepted_async_request_handler<ServiceT, BaseServT>(
+        chain, base_service, buffer, response);
+}
+
+template<class ServiceT, class BaseServT = ServiceT, class ChainT>
+bool intercepted_request_handler(ChainT& chain,
+                                 BaseServT& base_service,
+                                 tos::span<uint8_t> buffer,
+                                 lidl::message_builder& response) {
     static_assert(std::is_base_of_v<BaseServT, ServiceT>);
     using descriptor = service_descriptor<typename ServiceT::service_type>;
 
     using params_union = typename descriptor::params_union;
 
-    return async_union_caller<ServiceT, BaseServT>(
-        base_service, get_root<params_union>(buffer), response);
+    auto envelope = extract_envelope(buffer);
+    auto& call    = get_root<params_union>(buffer);
+    metrics::record_request<typename ServiceT::service_type>(
+        static_cast<int>(call.alternative()), buffer.size());
+    return intercepted_union_caller<ServiceT, BaseServT>(
+        chain, base_service, call, response, envelope);
 }
 
 template<class ServiceT, class BaseServT = ServiceT>
 bool request_handler(BaseServT& base_service,
                      tos::span<uint8_t> buffer,
                      lidl::message_builder& response) {
-    static_assert(std::is_base_of_v<BaseServT, ServiceT>);
-    using descriptor = service_descriptor<typename ServiceT::service_type>;
-
-    using params_union = typename descriptor::params_union;
-
-    return union_caller<ServiceT, BaseServT>(
-        base_service, get_root<params_union>(buffer), response);
+    interceptor_chain<> chain;
+    return intercepted_request_handler<ServiceT, BaseServT>(
+        chain, base_service, buffer, response);
 }
 } // namespace detail
 
+/**
+ * Runs requests for a service like the runners make_procedure_runner returns, with
+ * the given interceptors around every call.
+ */
+template<class ServiceT, class BaseServiceT, class... Interceptors>
+class intercepted_procedure_runner {
+public:
+    explicit intercepted_procedure_runner(interceptor_chain<Interceptors...> chain)
+        : m_chain(std::move(chain)) {
+    }
+
+    bool operator()(BaseServiceT& service,
+                    tos::span<uint8_t> buffer,
+                    lidl::message_builder& response) {
+        return detail::intercepted_request_handler<ServiceT, BaseServiceT>(
+            m_chain, service, buffer, response);
+    }
+
+    interceptor_chain<Interceptors...>& interceptors() {
+        return m_chain;
+    }
+
+private:
+    interceptor_chain<Interceptors...> m_chain;
+};
+
+/**
+ * Asynchronous version of intercepted_procedure_runner. The runner must outlive the
+ * tasks it returns.
+ */
+template<class ServiceT, class BaseServiceT, class... Interceptors>
+class intercepted_async_procedure_runner {
+public:
+    explicit intercepted_async_procedure_runner(interceptor_chain<Interceptors...> chain)
+        : m_chain(std::move(chain)) {
+    }
+
+    tos::Task<bool> operator()(BaseServiceT& service,
+                               tos::span<uint8_t> buffer,
+                               lidl::message_builder& response) {
+        return detail::intercepted_async_request_handler<ServiceT, BaseServiceT>(
+            m_chain, service, buffer, response);
+    }
+
+    interceptor_chain<Interceptors...>& interceptors() {
+        return m_chain;
+    }
+
+private:
+    interceptor_chain<Interceptors...> m_chain;
+};
+
 template<class ServiceT, class BaseServiceT = ServiceT>
 typed_procedure_runner_t<BaseServiceT> make_procedure_runner() {
     return &detail::request_handler<ServiceT, BaseServiceT>;
 }
 
+template<class ServiceT, class BaseServiceT = ServiceT, class... Interceptors>
+intercepted_procedure_runner<ServiceT, BaseServiceT, Interceptors...>
+make_procedure_runner(interceptor_chain<Interceptors...> chain) {
+    return intercepted_procedure_runner<ServiceT, BaseServiceT, Interceptors...>(
+        std::move(chain));
+}
+
+template<class ServiceT, class BaseServiceT = ServiceT, class... Interceptors>
+intercepted_async_procedure_runner<ServiceT, BaseServiceT, Interceptors...>
+make_async_procedure_runner(interceptor_chain<Interceptors...> chain) {
+    return intercepted_async_procedure_runner<ServiceT, BaseServiceT, Interceptors...>(
+        std::move(chain));
+}
+
 template<class ServiceT>
 erased_procedure_runner_t make_erased_procedure_runner() {
     return &detail::request_handler<ServiceT, service_base>;
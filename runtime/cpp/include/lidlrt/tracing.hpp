@@ -0,0 +1,387 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/trailer.hpp>
+#include <tos/span.hpp>
+
+#if defined(LIDL_RPC_TRACING)
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#endif
+
+/**
+ * Distributed tracing of the service dispatch. Client stubs attach the trace context
+ * of the call they are making to every request, and the dispatch records a span for
+ * every call it handles and makes it the current context while the procedure runs.
+ * Calls made from a procedure then carry its context, so traces span several hops.
+ *
+ * Spans are only recorded if LIDL_RPC_TRACING is defined. Otherwise, requests don't
+ * carry a trace context and the tracing functions are empty and compile away.
+ *
+ * The context is part of the envelope of requests, see envelope.hpp.
+ */
+namespace lidl {
+template<class T>
+class service_descriptor;
+
+namespace tracing {
+#if defined(LIDL_RPC_TRACING)
+inline constexpr bool enabled = true;
+
+using trace_id = std::array<uint8_t, 16>;
+
+enum class trace_flags : uint8_t
+{
+    none = 0,
+    // Spans of sampled traces are exported, others are only propagated.
+    sampled = 1,
+};
+
+struct trace_context {
+    trace_id trace{};
+    // Zero if the caller isn't part of a trace.
+    uint64_t span = 0;
+    trace_flags flags = trace_flags::none;
+
+    bool valid() const {
+        return span != 0;
+    }
+
+    bool sampled() const {
+        auto bits = static_cast<uint8_t>(flags);
+        return (bits & static_cast<uint8_t>(trace_flags::sampled)) != 0;
+    }
+};
+
+/**
+ * The context as it's appended to requests: the trace id, the span id in little
+ * endian and the flags, in a trailer tagged "tc", see trailer.hpp.
+ */
+struct wire_layout {
+    static constexpr detail::trailer_tag tag{'t', 'c'};
+    static constexpr uint8_t version = 2;
+    static constexpr uint8_t size    = 16 + 8 + 1;
+};
+
+struct span_record {
+    trace_id trace;
+    uint64_t span;
+    // Zero for the root span of a trace.
+    uint64_t parent;
+    std::string_view service;
+    std::string_view procedure;
+    std::chrono::system_clock::time_point start;
+    std::chrono::nanoseconds duration;
+    bool ok;
+};
+
+/**
+ * Receives the spans of sampled traces when they end. Exporters are called from the
+ * threads that handled the calls, and must be thread safe.
+ */
+class exporter {
+public:
+    virtual void export_span(const span_record& span) = 0;
+    virtual ~exporter() = default;
+};
+
+/**
+ * Keeps the last spans in memory, overwriting the oldest ones once it's full.
+ */
+class ring_buffer_exporter : public exporter {
+public:
+    explicit ring_buffer_exporter(size_t capacity)
+        : m_spans(capacity) {
+    }
+
+    void export_span(const span_record& span) override {
+        std::lock_guard lock(m_mutex);
+        m_spans[m_next % m_spans.size()] = span;
+        ++m_next;
+    }
+
+    // Returns the spans it holds, from the oldest to the newest.
+    std::vector<span_record> spans() const {
+        std::lock_guard lock(m_mutex);
+        std::vector<span_record> res;
+        auto count = std::min(m_next, m_spans.size());
+        for (size_t i = m_next - count; i < m_next; ++i) {
+            res.push_back(m_spans[i % m_spans.size()]);
+        }
+        return res;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<span_record> m_spans;
+    size_t m_next = 0;
+};
+
+/**
+ * Writes every span to a file as a line of JSON. The file isn't closed by the exporter.
+ */
+class file_exporter : public exporter {
+public:
+    explicit file_exporter(std::FILE* file)
+        : m_file{file} {
+    }
+
+    void export_span(const span_record& span) override {
+        char trace[33];
+        for (size_t i = 0; i < span.trace.size(); ++i) {
+            std::snprintf(trace + i * 2, 3, "%02x", span.trace[i]);
+        }
+        auto start_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                            span.start.time_since_epoch())
+                            .count();
+
+        char line[512];
+        std::snprintf(line,
+                      sizeof line,
+                      "{\"trace_id\":\"%s\",\"span_id\":\"%016llx\",\"parent_id\":\"%016llx\","
+                      "\"service\":\"%.*s\",\"procedure\":\"%.*s\",\"start_us\":%lld,"
+                      "\"duration_ns\":%lld,\"ok\":%s}\n",
+                      trace,
+                      static_cast<unsigned long long>(span.span),
+                      static_cast<unsigned long long>(span.parent),
+                      static_cast<int>(span.service.size()),
+                      span.service.data(),
+                      static_cast<int>(span.procedure.size()),
+                      span.procedure.data(),
+                      static_cast<long long>(start_us),
+                      static_cast<long long>(span.duration.count()),
+                      span.ok ? "true" : "false");
+
+        std::lock_guard lock(m_mutex);
+        std::fputs(line, m_file);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::FILE* m_file;
+};
+
+namespace detail {
+inline std::atomic<exporter*>& exporter_slot() {
+    static std::atomic<exporter*> slot{nullptr};
+    return slot;
+}
+
+inline trace_context& current_context() {
+    thread_local trace_context ctx;
+    return ctx;
+}
+
+inline uint64_t random_id() {
+    thread_local std::mt19937_64 gen{std::random_device{}()};
+    uint64_t res;
+    // Zero means there is no span.
+    while ((res = gen()) == 0) {
+    }
+    return res;
+}
+} // namespace detail
+
+/**
+ * Sets the exporter spans are sent to, or disables exporting if it's null. The exporter
+ * must outlive the calls that may use it. Traces started while there is no exporter
+ * aren't sampled.
+ */
+inline void set_exporter(exporter* exp) {
+    detail::exporter_slot().store(exp, std::memory_order_release);
+}
+
+/**
+ * Returns the context of the call the current thread is handling, which is invalid if
+ * it isn't handling one.
+ */
+inline const trace_context& current() {
+    return detail::current_context();
+}
+
+/**
+ * Makes the given context the current one until its destruction, for propagating a
+ * context to calls made outside of a procedure, such as on another thread.
+ */
+class scoped_context {
+public:
+    explicit scoped_context(const trace_context& ctx)
+        : m_previous{std::exchange(detail::current_context(), ctx)} {
+    }
+
+    scoped_context(const scoped_context&) = delete;
+    scoped_context& operator=(const scoped_context&) = delete;
+
+    ~scoped_context() {
+        detail::current_context() = m_previous;
+    }
+
+private:
+    trace_context m_previous;
+};
+
+/**
+ * Appends the current context to a request whose root was just created.
+ */
+inline void attach(message_builder& builder) {
+    auto& ctx = current();
+    auto ptr  = lidl::detail::append_trailer(
+        builder, wire_layout::tag, wire_layout::size, wire_layout::version);
+    if (!ptr) {
+        return;
+    }
+    std::memcpy(ptr, ctx.trace.data(), ctx.trace.size());
+    for (int i = 0; i < 8; ++i) {
+        ptr[16 + i] = static_cast<uint8_t>(ctx.span >> (i * 8));
+    }
+    ptr[24] = static_cast<uint8_t>(ctx.flags);
+}
+
+/**
+ * Removes the context from the end of the request and returns it. Requests without a
+ * context of a known version are left as is, and an invalid context is returned.
+ */
+inline trace_context extract(tos::span<uint8_t>& request) {
+    trace_context res;
+    auto ptr = lidl::detail::strip_trailer(
+        request, wire_layout::tag, wire_layout::size, wire_layout::version);
+    if (!ptr) {
+        return res;
+    }
+    std::memcpy(res.trace.data(), ptr, res.trace.size());
+    for (int i = 0; i < 8; ++i) {
+        res.span |= uint64_t(ptr[16 + i]) << (i * 8);
+    }
+    res.flags = static_cast<trace_flags>(ptr[24]);
+    return res;
+}
+
+/**
+ * Records a call to a procedure of ServiceT as a child of the caller's span, from its
+ * construction to its destruction. If the caller isn't part of a trace, the span starts
+ * a new one.
+ *
+ * Synchronous calls make the span the current context while they run. Asynchronous
+ * ones don't, as their tasks may be suspended and resumed on other threads, and calls
+ * made from them start new traces.
+ */
+template<class ServiceT>
+class server_span {
+public:
+    server_span(int procedure, const trace_context& parent, bool make_current)
+        : m_procedure{procedure}
+        , m_parent{parent.span}
+        , m_make_current{make_current} {
+        if (parent.valid()) {
+            m_context.trace = parent.trace;
+            m_context.flags = parent.flags;
+        } else {
+            auto hi = detail::random_id();
+            auto lo = detail::random_id();
+            std::memcpy(m_context.trace.data(), &hi, 8);
+            std::memcpy(m_context.trace.data() + 8, &lo, 8);
+            m_context.flags =
+                detail::exporter_slot().load(std::memory_order_acquire) != nullptr
+                    ? trace_flags::sampled
+                    : trace_flags::none;
+        }
+        m_context.span = detail::random_id();
+
+        if (m_make_current) {
+            m_previous = std::exchange(detail::current_context(), m_context);
+        }
+        if (m_context.sampled()) {
+            m_start        = std::chrono::system_clock::now();
+            m_steady_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    server_span(const server_span&) = delete;
+    server_span& operator=(const server_span&) = delete;
+
+    void succeeded(bool ok = true) {
+        m_ok = ok;
+    }
+
+    const trace_context& context() const {
+        return m_context;
+    }
+
+    ~server_span() {
+        if (m_make_current) {
+            detail::current_context() = m_previous;
+        }
+        if (!m_context.sampled()) {
+            return;
+        }
+        auto exp = detail::exporter_slot().load(std::memory_order_acquire);
+        if (!exp) {
+            return;
+        }
+
+        using descriptor = service_descriptor<ServiceT>;
+        static constexpr auto procedure_names = std::apply(
+            [](auto&... procs) {
+                return std::array<std::string_view, sizeof...(procs)>{procs.name...};
+            },
+            descriptor::procedures);
+
+        span_record rec;
+        rec.trace     = m_context.trace;
+        rec.span      = m_context.span;
+        rec.parent    = m_parent;
+        rec.service   = descriptor::name;
+        rec.procedure = procedure_names[m_procedure];
+        rec.start     = m_start;
+        rec.duration  = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_steady_start);
+        rec.ok = m_ok;
+        exp->export_span(rec);
+    }
+
+private:
+    int m_procedure;
+    uint64_t m_parent;
+    bool m_make_current;
+    bool m_ok = false;
+    trace_context m_context;
+    trace_context m_previous;
+    std::chrono::system_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_steady_start;
+};
+#else
+inline constexpr bool enabled = false;
+
+struct trace_context {};
+
+inline void attach(message_builder&) {
+}
+
+inline trace_context extract(tos::span<uint8_t>&) {
+    return {};
+}
+
+template<class ServiceT>
+class server_span {
+public:
+    server_span(int, const trace_context&, bool) {
+    }
+
+    void succeeded(bool = true) {
+    }
+};
+#endif
+} // namespace tracing
+} // namespace lidl
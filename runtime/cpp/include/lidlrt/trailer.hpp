@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <lidlrt/builder.hpp>
+#include <tos/span.hpp>
+
+namespace lidl::detail {
+/**
+ * Fields of the envelope are appended to requests as trailers: the bytes of the field,
+ * followed by a footer of a two byte tag naming the field, the number of bytes of the
+ * field and the version of its layout.
+ *
+ * A trailer is only removed if all of its footer matches, so that a request without one
+ * whose root happens to end in the same bytes as a version isn't cut short.
+ */
+struct trailer_tag {
+    uint8_t first;
+    uint8_t second;
+};
+
+inline constexpr size_t trailer_footer_size = 4;
+
+/**
+ * Allocates a trailer with the given footer and returns where its size bytes of data go,
+ * or null if it doesn't fit in the builder.
+ */
+inline uint8_t* append_trailer(message_builder& builder,
+                               trailer_tag tag,
+                               uint8_t size,
+                               uint8_t version) {
+    auto ptr = builder.allocate(size + trailer_footer_size, 1);
+    if (!ptr) {
+        return nullptr;
+    }
+    ptr[size]     = tag.first;
+    ptr[size + 1] = tag.second;
+    ptr[size + 2] = size;
+    ptr[size + 3] = version;
+    return ptr;
+}
+
+/**
+ * Removes the trailer with the given footer from the end of the request, and returns
+ * where its data is. Requests that don't end in that footer are left as is, and null is
+ * returned.
+ */
+inline const uint8_t* strip_trailer(tos::span<uint8_t>& request,
+                                    trailer_tag tag,
+                                    uint8_t size,
+                                    uint8_t version) {
+    auto total = size + trailer_footer_size;
+    if (request.size() < total) {
+        return nullptr;
+    }
+    auto ptr = request.data() + request.size() - total;
+    if (ptr[size] != tag.first || ptr[size + 1] != tag.second || ptr[size + 2] != size ||
+        ptr[size + 3] != version) {
+        return nullptr;
+    }
+    request = request.slice(0, request.size() - total);
+    return ptr;
+}
+} // namespace lidl::detail
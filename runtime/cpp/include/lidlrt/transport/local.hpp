@@ -1,6 +1,7 @@
 #pragma once
 
-#include <vector>
+#include <lidlrt/arena.hpp>
+#include <lidlrt/builder.hpp>
 
 namespace lidl {
 template<class ServerType>
@@ -10,13 +11,18 @@ struct local_transport {
         : m_serv{std::forward<Args>(t)...} {
     }
 
-    std::vector<uint8_t> get_buffer() {
-        return std::vector<uint8_t>(1024);
+    /**
+     * Requests and responses are built right in these buffers, and builders can't grow,
+     * so they must fit the largest message. The arena keeps them around, so they are
+     * only allocated once per thread.
+     */
+    message_arena::buffer get_buffer() {
+        return message_arena::this_thread().get(message_arena::max_buffer_size);
     }
 
-    std::vector<uint8_t> send_receive(tos::span<uint8_t> data) {
+    message_arena::buffer send_receive(tos::span<uint8_t> data) {
         //        tos::debug::log(data);
-        std::vector<uint8_t> buf(1024);
+        auto buf = get_buffer();
         lidl::message_builder mb(buf);
         m_serv.run_message(data, mb);
         buf.resize(mb.size());
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <lidlrt/fixed_string.hpp>
 #include <lidlrt/meta.hpp>
 #include <lidlrt/traits.hpp>
 
@@ -15,6 +16,15 @@ constexpr auto index_of() -> typename UnionType::alternatives {
     return static_cast<typename UnionType::alternatives>(
         meta::list_index_of<Type, types>::value);
 }
+
+/**
+ * Calls the visitor of a union with its active alternative. Generated visit functions
+ * dispatch on the alternative and call this with its name.
+ */
+template<fixed_string Name, class T, class FunT>
+decltype(auto) do_visit(T& alternative, const FunT& fn) {
+    return fn(alternative);
+}
 } // namespace detail
 
 template<class Type, class UnionType>
@@ -174,6 +174,19 @@ vector<T>& create_vector_sized(message_builder& builder, int size) {
     return vec;
 }
 
+/**
+ * Returns whether a vector of the given number of elements can still be created in the
+ * builder.
+ */
+template<class T>
+bool fits_vector(const message_builder& builder, size_t count) {
+    auto pos = (builder.size() + alignof(vector<T>) - 1) / alignof(vector<T>) *
+                   alignof(vector<T>) +
+               sizeof(vector<T>);
+    pos = (pos + alignof(T) - 1) / alignof(T) * alignof(T);
+    return pos + count * sizeof(T) <= builder.capacity();
+}
+
 template<class T, std::enable_if_t<!is_ptr<T>{} && !is_reference_type<T>{}>* = nullptr>
 vector<T>& create_vector(message_builder& builder, tos::span<const T> elems) {
     auto& vec = create_vector_sized<T>(builder, elems.size());
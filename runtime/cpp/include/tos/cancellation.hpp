@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace tos {
+/**
+ * Tells a task, and the tasks it awaits, that its result isn't needed anymore: either
+ * because its source was cancelled, or because its deadline passed.
+ *
+ * Tokens are checked rather than signalled. Nothing wakes up a suspended task when
+ * its token is cancelled, so long running tasks check cancelled() between their steps.
+ *
+ * A default constructed token is never cancelled. Tokens are cheap to copy, and refer
+ * to their source, which must outlive them.
+ */
+class cancellation_token {
+public:
+    using clock = std::chrono::steady_clock;
+
+    cancellation_token() = default;
+
+    bool cancelled() const {
+        if (m_flag && m_flag->load(std::memory_order_relaxed)) {
+            return true;
+        }
+        return m_deadline != clock::time_point::max() && clock::now() >= m_deadline;
+    }
+
+    bool has_deadline() const {
+        return m_deadline != clock::time_point::max();
+    }
+
+    // Returns clock::time_point::max() if the token has no deadline.
+    clock::time_point deadline() const {
+        return m_deadline;
+    }
+
+    /**
+     * Returns a token that is cancelled along with this one, or at the given deadline
+     * if it's earlier than this token's.
+     */
+    cancellation_token with_deadline(clock::time_point deadline) const {
+        auto res       = *this;
+        res.m_deadline = std::min(m_deadline, deadline);
+        return res;
+    }
+
+    // Whether the token can ever be cancelled.
+    bool empty() const {
+        return !m_flag && !has_deadline();
+    }
+
+private:
+    friend class cancellation_source;
+
+    explicit cancellation_token(const std::atomic<bool>* flag)
+        : m_flag{flag} {
+    }
+
+    const std::atomic<bool>* m_flag = nullptr;
+    clock::time_point m_deadline    = clock::time_point::max();
+};
+
+class cancellation_source {
+public:
+    cancellation_source() = default;
+    cancellation_source(const cancellation_source&) = delete;
+    cancellation_source& operator=(const cancellation_source&) = delete;
+
+    cancellation_token token() const {
+        return cancellation_token(&m_flag);
+    }
+
+    void cancel() {
+        m_flag.store(true, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> m_flag{false};
+};
+} // namespace tos
@@ -2,9 +2,22 @@
 
 #include <cassert>
 #include <coroutine>
+#include <tos/cancellation.hpp>
+#include <type_traits>
 #include <utility>
 
 namespace tos {
+namespace detail {
+template<class PromiseT, class ContinuationT>
+void inherit_token(PromiseT& promise, std::coroutine_handle<ContinuationT> continuation) {
+    if constexpr (requires { continuation.promise().token; }) {
+        if (promise.token.empty()) {
+            promise.token = continuation.promise().token;
+        }
+    }
+}
+} // namespace detail
+
 template<typename T = void>
 class Task {
     class TaskPromiseBase;
@@ -30,65 +43,21 @@ public:
     using promise_coro_handle = std::coroutine_handle<promise_type>;
 
     auto operator co_await() const& {
-        struct awaiter {
-            awaiter(promise_coro_handle coro)
-                : coro(coro) {
-            }
-
-            bool await_ready() const noexcept {
-                return false;
-            }
-            std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) {
-                this->coro.promise().continuation = continuation;
-
-                return this->coro;
-            }
-
-            decltype(auto) await_resume() {
-                if constexpr (!std::is_void_v<decltype(this->coro.promise().result())>) {
-                    return std::move(this->coro.promise().result());
-                } else {
-                    this->coro.promise().result();
-                }
-            }
-
-        private:
-            promise_coro_handle coro;
-        };
-
         return awaiter{this->coroHandle};
     }
 
     auto operator co_await() const&& {
-        struct awaiter {
-            awaiter(promise_coro_handle coro)
-                : coro(coro) {
-            }
-
-            bool await_ready() const noexcept {
-                return false;
-            }
-            std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) {
-                this->coro.promise().continuation = continuation;
-
-                return this->coro;
-            }
-
-            decltype(auto) await_resume() {
-                if constexpr (!std::is_void_v<decltype(this->coro.promise().result())>) {
-                    return std::move(this->coro.promise().result());
-                } else {
-                    this->coro.promise().result();
-                }
-            }
-
-        private:
-            promise_coro_handle coro;
-        };
-
         return awaiter{this->coroHandle};
     }
 
+    /**
+     * Sets the cancellation token of the task, which the tasks it awaits inherit. Tasks
+     * without a token of their own inherit the one of the task that awaits them.
+     */
+    void set_token(const cancellation_token& token) {
+        coroHandle.promise().token = token;
+    }
+
     bool run() {
         if (!coroHandle.done()) {
             coroHandle.resume();
@@ -101,6 +70,37 @@ public:
     }
 
 private:
+    // Awaiters are declared here rather than locally, as they have member templates.
+    class awaiter {
+    public:
+        awaiter(promise_coro_handle coro)
+            : coro(coro) {
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template<class PromiseT>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<PromiseT> continuation) {
+            this->coro.promise().continuation = continuation;
+            detail::inherit_token(this->coro.promise(), continuation);
+
+            return this->coro;
+        }
+
+        decltype(auto) await_resume() {
+            if constexpr (!std::is_void_v<decltype(this->coro.promise().result())>) {
+                return std::move(this->coro.promise().result());
+            } else {
+                this->coro.promise().result();
+            }
+        }
+
+    private:
+        promise_coro_handle coro;
+    };
+
     explicit Task(promise_coro_handle coro)
         : coroHandle(coro) {
     }
@@ -116,6 +116,8 @@ private:
         std::coroutine_handle<> continuation;
 
     public:
+        cancellation_token token;
+
         std::suspend_always initial_suspend() const noexcept {
             return {};
         }
@@ -128,7 +130,12 @@ private:
 
                 std::coroutine_handle<>
                 await_suspend(promise_coro_handle coroHandle) noexcept {
-                    return coroHandle.promise().continuation;
+                    // Tasks that are run directly rather than awaited have nothing to
+                    // continue with, and return to their caller instead.
+                    if (auto continuation = coroHandle.promise().continuation) {
+                        return continuation;
+                    }
+                    return std::noop_coroutine();
                 }
 
                 void await_resume() noexcept {
@@ -173,4 +180,35 @@ public:
     }
 };
 
+namespace detail {
+class current_token_awaiter {
+public:
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    template<class PromiseT>
+    bool await_suspend(std::coroutine_handle<PromiseT> coro) noexcept {
+        m_token = coro.promise().token;
+        // Resumes the task right away.
+        return false;
+    }
+
+    cancellation_token await_resume() const noexcept {
+        return m_token;
+    }
+
+private:
+    cancellation_token m_token;
+};
+} // namespace detail
+
+/**
+ * Returns the cancellation token of the task that awaits it:
+ *
+ *   auto token = co_await tos::current_token();
+ */
+inline detail::current_token_awaiter current_token() {
+    return {};
+}
 } // namespace tos
\ No newline at end of file
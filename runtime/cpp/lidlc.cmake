@@ -55,8 +55,27 @@ if (NOT ${LIDLC_BIN} MATCHES "NOTFOUND")
         target_link_libraries(${Name} INTERFACE lidl_rt)
         add_dependencies(${Name} ${Name}_IMPL)
     endfunction()
+
+    # Builds a python extension module named Name for the given file, on top of the C++
+    # header an add_lidlc target generates for it. Needs pybind11 to be loaded.
+    function(add_lidlc_python Name Lib FILE)
+        set(LIDLC_OUTPUT "${CMAKE_CURRENT_BINARY_DIR}/${Name}.cpp")
+        add_custom_command(OUTPUT ${LIDLC_OUTPUT}
+                COMMAND ${LIDLC_BIN}
+                ARGS -gpybind -f ${FILE} -o ${LIDLC_OUTPUT} "-I$<JOIN:$<TARGET_PROPERTY:${Lib},INTERFACE_INCLUDE_DIRECTORIES>, -I>"
+                DEPENDS ${FILE} ${LIDLC_BIN}
+                COMMENT "Building python bindings for ${FILE}"
+                WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR})
+
+        pybind11_add_module(${Name} ${LIDLC_OUTPUT})
+        target_link_libraries(${Name} PRIVATE ${Lib})
+    endfunction()
 else()
     function(add_lidlc Name)
         message(STATUS "lidlc not found!")
     endfunction()
+
+    function(add_lidlc_python Name Lib FILE)
+        message(STATUS "lidlc not found!")
+    endfunction()
 endif()
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <doctest.h>
+#include <lidlrt/arena.hpp>
+#include <vector>
+
+namespace lidl {
+namespace {
+TEST_CASE("arena size classes") {
+    message_arena arena;
+    REQUIRE_EQ(64, arena.get(1).capacity());
+    REQUIRE_EQ(64, arena.get(64).capacity());
+    REQUIRE_EQ(128, arena.get(65).capacity());
+    REQUIRE_EQ(1024, arena.get(1000).capacity());
+    REQUIRE_EQ(message_arena::max_buffer_size,
+               arena.get(message_arena::max_buffer_size).capacity());
+
+    auto buf = arena.get(100);
+    REQUIRE_EQ(128, buf.size());
+    buf.resize(50);
+    REQUIRE_EQ(50, buf.size());
+    REQUIRE_EQ(128, buf.capacity());
+}
+
+TEST_CASE("arena reuses buffers") {
+    message_arena arena;
+    const uint8_t* storage;
+    {
+        auto buf = arena.get(100);
+        storage  = buf.data();
+    }
+    REQUIRE_EQ(1, arena.cached_buffers());
+
+    auto buf = arena.get(128);
+    REQUIRE_EQ(storage, buf.data());
+    REQUIRE_EQ(0, arena.cached_buffers());
+
+    // Other size classes have their own free lists.
+    auto other = arena.get(256);
+    REQUIRE_NE(storage, other.data());
+}
+
+TEST_CASE("arena buffers come back clean") {
+    message_arena arena;
+    const uint8_t* storage;
+    {
+        auto buf = arena.get(128);
+        storage  = buf.data();
+        std::fill_n(buf.data(), buf.size(), uint8_t(0xab));
+    }
+    {
+        auto buf = arena.get(128);
+        REQUIRE_EQ(storage, buf.data());
+        REQUIRE(std::all_of(buf.data(), buf.data() + 128, [](auto b) { return b == 0; }));
+
+        // Only the message a buffer was trimmed to is written, and cleared.
+        std::fill_n(buf.data(), 100, uint8_t(0xcd));
+        buf.resize(100);
+    }
+    auto buf = arena.get(128);
+    REQUIRE_EQ(storage, buf.data());
+    REQUIRE(std::all_of(buf.data(), buf.data() + 128, [](auto b) { return b == 0; }));
+}
+
+TEST_CASE("arena epochs") {
+    message_arena arena;
+    REQUIRE_EQ(0, arena.epoch());
+
+    {
+        std::vector<message_arena::buffer> bufs;
+        for (int i = 0; i < 3; ++i) {
+            bufs.push_back(arena.get(64));
+        }
+    }
+    REQUIRE_EQ(3, arena.cached_buffers());
+
+    // The buffers were all in use during this epoch, so they are kept.
+    arena.reset();
+    REQUIRE_EQ(1, arena.epoch());
+    REQUIRE_EQ(3, arena.cached_buffers());
+
+    // Only one is in use during the next one, so the others are dropped.
+    {
+        auto buf = arena.get(64);
+    }
+    arena.reset();
+    REQUIRE_EQ(2, arena.epoch());
+    REQUIRE_EQ(1, arena.cached_buffers());
+}
+} // namespace
+} // namespace lidl
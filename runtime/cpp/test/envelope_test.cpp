@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <doctest.h>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/envelope.hpp>
+#include <vector>
+
+namespace lidl {
+namespace {
+using namespace std::chrono_literals;
+
+tracing::trace_context make_context() {
+    tracing::trace_context ctx;
+    std::fill(ctx.trace.begin(), ctx.trace.end(), uint8_t(0x11));
+    ctx.span  = 0x0102030405060708;
+    ctx.flags = tracing::trace_flags::sampled;
+    return ctx;
+}
+
+tos::span<uint8_t> make_request(message_builder& builder, bool with_envelope) {
+    auto root = builder.allocate(4, 1);
+    std::fill_n(root, 4, uint8_t(0x01));
+    if (with_envelope) {
+        auto token = tos::cancellation_token{}.with_deadline(
+            call_envelope::clock::now() + 10s);
+        attach_envelope(builder, token);
+    }
+    return builder.get_buffer();
+}
+
+TEST_CASE("envelope round trip") {
+    std::array<uint8_t, 128> buf;
+    message_builder builder(buf);
+    tracing::scoped_context ctx(make_context());
+    auto request = make_request(builder, true);
+
+    auto envelope = extract_envelope(request);
+    REQUIRE_EQ(4, request.size());
+    REQUIRE(envelope.trace.valid());
+    REQUIRE_EQ(make_context().span, envelope.trace.span);
+    REQUIRE(envelope.trace.trace == make_context().trace);
+    REQUIRE(envelope.trace.sampled());
+    REQUIRE_NE(call_envelope::clock::time_point::max(), envelope.deadline);
+    REQUIRE_FALSE(envelope.expired());
+}
+
+TEST_CASE("requests without an envelope are left as is") {
+    // The root ends in a byte that is also the version of both trailers.
+    std::array<uint8_t, 128> buf;
+    message_builder builder(buf);
+    auto request = make_request(builder, false);
+
+    auto envelope = extract_envelope(request);
+    REQUIRE_EQ(4, request.size());
+    REQUIRE_FALSE(envelope.trace.valid());
+    REQUIRE_EQ(call_envelope::clock::time_point::max(), envelope.deadline);
+
+    // The same with a root large enough to be mistaken for either trailer.
+    std::vector<uint8_t> large(64, 0x01);
+    tos::span<uint8_t> large_request(large);
+    envelope = extract_envelope(large_request);
+    REQUIRE_EQ(64, large_request.size());
+    REQUIRE_FALSE(envelope.trace.valid());
+    REQUIRE_EQ(call_envelope::clock::time_point::max(), envelope.deadline);
+}
+
+TEST_CASE("a missing deadline doesn't strip the trace context") {
+    std::array<uint8_t, 128> buf;
+    message_builder builder(buf);
+    make_request(builder, false);
+    tracing::scoped_context ctx(make_context());
+    tracing::attach(builder);
+    auto request = builder.get_buffer();
+
+    auto envelope = extract_envelope(request);
+    REQUIRE_EQ(4, request.size());
+    REQUIRE_EQ(make_context().span, envelope.trace.span);
+    REQUIRE_EQ(call_envelope::clock::time_point::max(), envelope.deadline);
+}
+} // namespace
+} // namespace lidl
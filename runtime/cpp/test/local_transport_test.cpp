@@ -0,0 +1,75 @@
+#include "service_generated.hpp"
+
+#include <array>
+#include <doctest.h>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/service.hpp>
+#include <lidlrt/transport/local.hpp>
+#include <string>
+
+namespace lidl {
+namespace {
+using lidl_example::repeat;
+
+class repeat_impl : public repeat::sync_server {
+public:
+    const lidl::vector<uint8_t>&
+    return_vector(lidl::message_builder& response_builder) override {
+        return lidl::create_vector_sized<uint8_t>(response_builder, 20);
+    }
+
+    std::string_view echo(std::string_view str,
+                          lidl::message_builder& response_builder) override {
+        return str;
+    }
+
+    tos::span<uint8_t> echo_bytes(tos::span<uint8_t> arg,
+                                  lidl::message_builder& response_builder) override {
+        return arg;
+    }
+};
+
+struct local_server {
+    bool run_message(tos::span<uint8_t> req, lidl::message_builder& response) {
+        return handler(impl, req, response);
+    }
+
+    repeat_impl impl;
+    lidl::typed_procedure_runner_t<repeat::sync_server> handler =
+        lidl::make_procedure_runner<repeat::sync_server>();
+};
+
+using client = repeat::stub_client<lidl::local_transport<local_server>>;
+
+TEST_CASE("local transport echo") {
+    client repeater;
+    std::array<uint8_t, 64> buf;
+    lidl::message_builder response(buf);
+    REQUIRE_EQ("hello", repeater.echo("hello", response));
+}
+
+TEST_CASE("local transport large messages") {
+    client repeater;
+    for (size_t size : {257, 500, 4000}) {
+        std::string message(size, 'x');
+        std::vector<uint8_t> buf(size + 64);
+        lidl::message_builder response(buf);
+        REQUIRE_EQ(message, repeater.echo(message, response));
+    }
+}
+
+TEST_CASE("local transport large messages after small ones") {
+    client repeater;
+    for (int i = 0; i < 100; ++i) {
+        std::array<uint8_t, 64> buf;
+        lidl::message_builder response(buf);
+        REQUIRE_EQ("hi", repeater.echo("hi", response));
+    }
+
+    std::string message(1000, 'y');
+    std::vector<uint8_t> buf(1100);
+    lidl::message_builder response(buf);
+    REQUIRE_EQ(message, repeater.echo(message, response));
+}
+} // namespace
+} // namespace lidl
@@ -0,0 +1,178 @@
+#include "tests_generated.hpp"
+#include "vec3f_generated.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <doctest.h>
+#include <filesystem>
+#include <lidlrt/buffer.hpp>
+#include <lidlrt/builder.hpp>
+#include <lidlrt/message_file.hpp>
+#include <lidlrt/string.hpp>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace lidl {
+namespace {
+std::string temp_path(const char* name) {
+    auto path = (std::filesystem::temp_directory_path() / name).string();
+    std::filesystem::remove(path);
+    return path;
+}
+
+std::vector<uint8_t> make_vec3f(float x, float y, float z) {
+    alignas(8) std::array<uint8_t, 64> buf;
+    message_builder builder(buf);
+    emplace_raw<gfx::vec3f>(builder, x, y, z);
+    auto res = builder.get_buffer();
+    return {res.begin(), res.end()};
+}
+
+std::vector<uint8_t> make_string_and_vector(std::string_view name) {
+    alignas(8) std::array<uint8_t, 64> buf;
+    message_builder builder(buf);
+    auto& str = create_string(builder, name);
+    auto& vec = create_vector_sized<uint16_t>(builder, 3);
+    std::iota(vec.begin(), vec.end(), uint16_t(1));
+    create<module::string_and_vector>(builder, str, vec);
+    auto res = builder.get_buffer();
+    return {res.begin(), res.end()};
+}
+
+void write_frame(std::FILE* file, uint32_t len, tos::span<const uint8_t> body) {
+    uint8_t header[4]{
+        uint8_t(len), uint8_t(len >> 8), uint8_t(len >> 16), uint8_t(len >> 24)};
+    std::fwrite(header, 1, sizeof header, file);
+    std::fwrite(body.data(), 1, body.size(), file);
+}
+
+bool ends_with(tos::span<const uint8_t> frame, const std::vector<uint8_t>& message) {
+    return frame.size() >= message.size() &&
+           std::equal(message.begin(), message.end(), frame.end() - message.size());
+}
+
+TEST_CASE("message file round trip") {
+    auto path = temp_path("lidl_message_file_test.bin");
+
+    std::vector<std::vector<uint8_t>> messages{make_vec3f(1, 2, 3),
+                                               make_string_and_vector("hello"),
+                                               make_vec3f(4, 5, 6)};
+    {
+        auto writer = message_file_writer::open(path.c_str());
+        REQUIRE(writer);
+        for (auto& message : messages) {
+            REQUIRE(writer->append(message));
+        }
+        REQUIRE(writer->flush());
+    }
+
+    // Appending to an existing file keeps the earlier messages.
+    {
+        auto writer = message_file_writer::open(path.c_str());
+        REQUIRE(writer);
+        messages.push_back(make_vec3f(7, 8, 9));
+        REQUIRE(writer->append(messages.back()));
+    }
+
+    auto file = message_file::open(path.c_str());
+    REQUIRE(file);
+    REQUIRE_EQ(messages.size(), file->size());
+    REQUIRE_FALSE(file->truncated());
+
+    for (size_t i = 0; i < messages.size(); ++i) {
+        REQUIRE(ends_with((*file)[i], messages[i]));
+        // Messages are padded so that they start aligned in the mapping.
+        REQUIRE_EQ(0,
+                   reinterpret_cast<uintptr_t>((*file)[i].end() - messages[i].size()) %
+                       message_file_alignment);
+    }
+
+    auto first = file->get_root<gfx::vec3f>(0);
+    REQUIRE(first);
+    REQUIRE_EQ(gfx::vec3f(1, 2, 3), *first);
+    REQUIRE_EQ(gfx::vec3f(7, 8, 9), *file->get_root<gfx::vec3f>(3));
+
+    auto second = file->get_verified_root<module::string_and_vector>(1);
+    REQUIRE(second);
+    REQUIRE_EQ("hello", second->name().string_view());
+    REQUIRE_EQ(std::vector<uint16_t>{1, 2, 3},
+               std::vector<uint16_t>(second->numbers().begin(), second->numbers().end()));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("message file rejects bad frames") {
+    auto path = temp_path("lidl_message_file_bad_test.bin");
+
+    auto file = std::fopen(path.c_str(), "wb");
+    REQUIRE(file);
+    auto vec = make_vec3f(1, 2, 3);
+    // The frame starts right after its header, so the root is misaligned.
+    std::vector<uint8_t> misaligned(1, 0);
+    misaligned.insert(misaligned.end(), vec.begin(), vec.end());
+    write_frame(file, misaligned.size(), misaligned);
+    // Too small to hold a vec3f.
+    write_frame(file, 2, std::vector<uint8_t>{1, 2});
+    // The writer stopped in the middle of this frame.
+    write_frame(file, 100, vec);
+    std::fclose(file);
+
+    auto messages = message_file::open(path.c_str());
+    REQUIRE(messages);
+    REQUIRE_EQ(2, messages->size());
+    REQUIRE(messages->truncated());
+    REQUIRE_FALSE(messages->get_root<gfx::vec3f>(0));
+    REQUIRE_FALSE(messages->get_root<gfx::vec3f>(1));
+    REQUIRE_FALSE(messages->get_verified_root<gfx::vec3f>(1));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("verified roots reject offsets out of the message") {
+    auto path = temp_path("lidl_message_file_offsets_test.bin");
+
+    auto good = make_string_and_vector("hello");
+    auto& root = get_root<module::string_and_vector>(good);
+
+    // The pointer to the name points way before the message.
+    auto bad_ptr = good;
+    int16_t offset = 30000;
+    std::memcpy(bad_ptr.data() + bad_ptr.size() - sizeof root, &offset, sizeof offset);
+
+    // The vector claims more elements than the message holds.
+    auto bad_len = good;
+    auto len_pos = reinterpret_cast<const uint8_t*>(&root.numbers()) - good.data();
+    int16_t len  = 1000;
+    std::memcpy(bad_len.data() + len_pos, &len, sizeof len);
+
+    // A negative length.
+    auto negative_len = good;
+    len               = -1;
+    std::memcpy(negative_len.data() + len_pos, &len, sizeof len);
+
+    {
+        auto writer = message_file_writer::open(path.c_str());
+        REQUIRE(writer);
+        REQUIRE(writer->append(good));
+        REQUIRE(writer->append(bad_ptr));
+        REQUIRE(writer->append(bad_len));
+        REQUIRE(writer->append(negative_len));
+    }
+
+    auto file = message_file::open(path.c_str());
+    REQUIRE(file);
+    REQUIRE_EQ(4, file->size());
+    REQUIRE(file->get_verified_root<module::string_and_vector>(0));
+    for (size_t i = 1; i < file->size(); ++i) {
+        // The frames themselves are fine, only their contents are wrong.
+        REQUIRE(file->get_root<module::string_and_vector>(i));
+        REQUIRE_FALSE(file->get_verified_root<module::string_and_vector>(i));
+    }
+
+    std::filesystem::remove(path);
+}
+} // namespace
+} // namespace lidl
@@ -0,0 +1,33 @@
+"""
+Imports the pybind11 extension lidlc generates for the example schema and reads back
+the messages it builds, both through encode and through a Builder.
+
+    python3 python_ext_test.py <extension dir>
+"""
+
+import sys
+
+sys.path.insert(0, sys.argv[1])
+
+import tests_pybind
+from tests_pybind import string_and_vector
+
+data = string_and_vector.encode({"name": "hello", "numbers": [1, 2, 3]})
+msg = string_and_vector.from_buffer(data)
+assert msg.name == "hello"
+assert memoryview(msg.numbers).tolist() == [1, 2, 3]
+
+builder = tests_pybind.Builder()
+string_and_vector.build(builder, {"name": "world", "numbers": range(100)})
+assert builder.size == len(builder.bytes())
+msg = string_and_vector.from_buffer(builder.view())
+assert msg.name == "world"
+assert memoryview(msg.numbers).tolist() == list(range(100))
+
+# Messages that don't fit in the builder are rejected rather than truncated.
+try:
+    string_and_vector.build(tests_pybind.Builder(64), {"name": "x", "numbers": range(100)})
+except Exception:
+    pass
+else:
+    raise AssertionError("built a message larger than its builder")
@@ -1,4 +1,4 @@
-import {Layout, LidlObject, Type} from "./Object";
+import {Layout, LidlObject, Type, typedArray, typedView} from "./Object";
 import assert from "assert";
 
 export class LidlArrayClass implements Type {
@@ -36,7 +36,19 @@ export class LidlArray extends LidlObject {
         }
     }
 
+    /**
+     * For arrays of numbers, returns a typed array aliasing the elements in the message,
+     * or undefined if they are misaligned in memory.
+     */
+    view(): any {
+        return typedView(this._type.type, this.buffer(), 0, this._type.size);
+    }
+
     get value(): any {
+        if (this._type.type.typed_array) {
+            return typedArray(this._type.type, this.buffer(), 0, this._type.size);
+        }
+
         const arr = [];
         for (let i = 0; i < this._type.size; ++i) {
             arr.push(this.at(i).value);
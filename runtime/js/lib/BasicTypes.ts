@@ -29,6 +29,8 @@ export class Bool extends LidlObject {
 }
 
 export class FloatClass implements TypedType<Float> {
+    typed_array = Float32Array;
+
     instantiate(buffer: Uint8Array): Float {
         return new Float(buffer);
     }
@@ -56,6 +58,8 @@ export class Float extends LidlObject {
 }
 
 export class DoubleClass implements Type {
+    typed_array = Float64Array;
+
     instantiate(data: Uint8Array): LidlObject {
         return new Double(data);
     }
@@ -83,6 +87,8 @@ export class Double extends LidlObject {
 }
 
 export class Uint8Class implements Type {
+    typed_array = Uint8Array;
+
     instantiate(data: Uint8Array): LidlObject {
         return new Uint8(data);
     }
@@ -110,6 +116,8 @@ export class Uint8 extends LidlObject {
 }
 
 export class Int8Class implements Type {
+    typed_array = Int8Array;
+
     instantiate(data: Uint8Array): LidlObject {
         return new Int8(data);
     }
@@ -137,6 +145,8 @@ export class Int8 extends LidlObject {
 }
 
 export class Uint16Class implements Type {
+    typed_array = Uint16Array;
+
     instantiate(data: Uint8Array): LidlObject {
         return new Uint16(data);
     }
@@ -164,6 +174,8 @@ export class Uint16 extends LidlObject {
 }
 
 export class Int16Class implements Type {
+    typed_array = Int16Array;
+
     instantiate(data: Uint8Array): LidlObject {
         return new Int16(data);
     }
@@ -191,6 +203,8 @@ export class Int16 extends LidlObject {
 }
 
 export class Uint32Class implements Type {
+    typed_array = Uint32Array;
+
     instantiate(data: Uint8Array): LidlObject {
         return new Uint32(data);
     }
@@ -218,6 +232,8 @@ export class Uint32 extends LidlObject {
 }
 
 export class Int32Class implements Type {
+    typed_array = Int32Array;
+
     instantiate(data: Uint8Array): LidlObject {
         return new Int32(data);
     }
@@ -245,6 +261,8 @@ export class Int32 extends LidlObject {
 }
 
 export class Uint64Class implements Type {
+    typed_array = BigUint64Array;
+
     instantiate(data: Uint8Array): LidlObject {
         return new Uint64(data);
     }
@@ -272,6 +290,8 @@ export class Uint64 extends LidlObject {
 }
 
 export class Int64Class implements Type {
+    typed_array = BigInt64Array;
+
     instantiate(data: Uint8Array): LidlObject {
         return new Int64(data);
     }
@@ -1,21 +1,136 @@
+import {Type} from "./Object";
+
+// Offsets are 16 bit signed integers, so messages can't be larger than this.
+export const MaxMessageSize = 32768;
+const MinCapacity = 64;
+
+// Builders hand out views into their buffer, and those must stay valid as the builder
+// grows. Where array buffers can be resized in place, the buffer grows geometrically
+// up to the maximum message size. Elsewhere, the whole range is reserved up front.
+const resizable = typeof (ArrayBuffer.prototype as any).resize === "function";
+
+function roundCapacity(size: number): number {
+    let capacity = MinCapacity;
+    while (capacity < size && capacity < MaxMessageSize) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+function makeBuffer(capacity: number): ArrayBuffer {
+    if (resizable) {
+        return new (ArrayBuffer as any)(capacity, {maxByteLength: MaxMessageSize});
+    }
+    return new ArrayBuffer(MaxMessageSize);
+}
+
 export class MessageBuilder {
+    private buffer: ArrayBuffer;
     private data: Uint8Array;
     private ptr: number = 0;
 
-    constructor() {
-        this.data = new Uint8Array(128);
+    constructor(capacity: number = 128) {
+        this.buffer = makeBuffer(roundCapacity(capacity));
+        this.data = new Uint8Array(this.buffer);
     }
 
     allocate(size: number, align: number): Uint8Array {
-        while (this.ptr % align != 0) {
-            this.ptr++;
+        const begin = Math.ceil(this.ptr / align) * align;
+        const end = begin + size;
+        if (end > this.data.byteLength) {
+            this.reserve(end);
         }
-        const res = this.data.subarray(this.ptr, this.ptr + size);
-        this.ptr += size;
-        return res;
+        this.ptr = end;
+        return this.data.subarray(begin, end);
     }
 
     get_buffer(): Uint8Array {
         return this.data.subarray(0, this.ptr);
     }
-}
\ No newline at end of file
+
+    size(): number {
+        return this.ptr;
+    }
+
+    capacity(): number {
+        return this.data.byteLength;
+    }
+
+    /**
+     * Makes room for a message of the given size. Views handed out before stay valid.
+     */
+    reserve(size: number) {
+        if (size <= this.data.byteLength) {
+            return;
+        }
+        if (size > MaxMessageSize) {
+            throw new RangeError(`Message of ${size} bytes exceeds the maximum of ${MaxMessageSize}`);
+        }
+        // Only reachable for resizable buffers, others are created at the maximum size.
+        (this.buffer as any).resize(roundCapacity(Math.max(size, this.data.byteLength * 2)));
+        this.data = new Uint8Array(this.buffer);
+    }
+
+    /**
+     * Starts a new message in the same buffer. Objects of the previous message must not
+     * be used afterwards.
+     */
+    reset() {
+        // Padding is never written, clear it so it does not carry old messages over.
+        this.data.fill(0, 0, this.ptr);
+        this.ptr = 0;
+    }
+}
+
+/**
+ * Keeps builders around between messages, so that a service building many messages
+ * reuses a few warm buffers rather than allocating one per message.
+ *
+ * Generated types have a size hint, which is the size of a message with empty strings
+ * and vectors. Builders are handed out with at least that much room.
+ */
+export class MessageBuilderPool {
+    private free: MessageBuilder[] = [];
+
+    constructor(private readonly maxFree: number = 16) {
+    }
+
+    acquire(hint: number | Type = 0): MessageBuilder {
+        const size = typeof hint === "number" ? hint : sizeHint(hint);
+
+        // Prefer a builder that is large enough already, but any of them will grow.
+        let best = -1;
+        for (let i = 0; i < this.free.length; ++i) {
+            if (this.free[i].capacity() >= size) {
+                best = i;
+                break;
+            }
+        }
+        if (best == -1 && this.free.length > 0) {
+            best = this.free.length - 1;
+        }
+
+        if (best == -1) {
+            return new MessageBuilder(size);
+        }
+
+        const mb = this.free.splice(best, 1)[0];
+        mb.reserve(size);
+        return mb;
+    }
+
+    /**
+     * Returns a builder to the pool. Objects built in it must not be used afterwards.
+     */
+    release(mb: MessageBuilder) {
+        if (this.free.length >= this.maxFree) {
+            return;
+        }
+        mb.reset();
+        this.free.push(mb);
+    }
+}
+
+function sizeHint(type: Type): number {
+    return type.size_hint ? type.size_hint() : type.layout().size;
+}
@@ -11,8 +11,20 @@ export function CreateObject<T extends Type>(type: T, mb: MessageBuilder, init:
 
 export type Layout = { size: number; alignment: number; };
 
+/**
+ * Constructor of the typed array with the same element representation as a basic type.
+ */
+export interface TypedArrayConstructor {
+    readonly BYTES_PER_ELEMENT: number;
+    new(buffer: ArrayBufferLike, byteOffset?: number, length?: number): any;
+}
+
 export interface Type {
     layout(): Layout;
+    // Expected size of a message with this type at its root, if known.
+    size_hint?(): number;
+    // Set for numeric types, whose vectors and arrays can be read as typed arrays.
+    typed_array?: TypedArrayConstructor;
 
     instantiate(data: Uint8Array): LidlObject;
 }
@@ -21,8 +33,52 @@ export interface TypedType<T extends LidlObject> extends Type {
     instantiate(data: Uint8Array): T;
 }
 
+const littleEndianHost = new Uint8Array(new Uint16Array([1]).buffer)[0] == 1;
+
+/**
+ * Returns a typed array aliasing count elements of a numeric type, starting at offset in
+ * data. Returns undefined if the elements are misaligned in memory or the host is big
+ * endian, in which case they can't be viewed in place.
+ */
+export function typedView(type: Type, data: Uint8Array, offset: number, count: number): any {
+    const ctor = type.typed_array;
+    if (!ctor || !littleEndianHost) {
+        return undefined;
+    }
+    const begin = data.byteOffset + offset;
+    if (begin % ctor.BYTES_PER_ELEMENT != 0) {
+        return undefined;
+    }
+    return new ctor(data.buffer, begin, count);
+}
+
+/**
+ * Like typedView, but falls back to copying the elements into a new typed array when
+ * they can't be viewed in place.
+ */
+export function typedArray(type: Type, data: Uint8Array, offset: number, count: number): any {
+    const view = typedView(type, data, offset, count);
+    if (view) {
+        return view;
+    }
+
+    const ctor = type.typed_array!;
+    const size = ctor.BYTES_PER_ELEMENT;
+    if (littleEndianHost) {
+        const begin = data.byteOffset + offset;
+        return new ctor(data.buffer.slice(begin, begin + count * size));
+    }
+
+    const res = new ctor(new ArrayBuffer(count * size));
+    for (let i = 0; i < count; ++i) {
+        res[i] = type.instantiate(data.subarray(offset + i * size, offset + (i + 1) * size)).value;
+    }
+    return res;
+}
+
 export abstract class LidlObject {
     private _buffer: Uint8Array;
+    private _view?: DataView;
 
     abstract get value(): any;
     abstract set value(val: any);
@@ -36,7 +92,10 @@ export abstract class LidlObject {
     }
 
     protected dataView(): DataView {
-        return new DataView(this._buffer.buffer, this._buffer.byteOffset, this._buffer.byteLength);
+        if (!this._view) {
+            this._view = new DataView(this._buffer.buffer, this._buffer.byteOffset, this._buffer.byteLength);
+        }
+        return this._view;
     }
 
     protected sliceBuffer(offset: number, length: number) {
@@ -1,7 +1,14 @@
-import {Layout, LidlObject, Type} from "./Object";
+import {Layout, LidlObject, Type, typedArray, typedView} from "./Object";
 
 export class VectorClass implements Type {
+    // Elements start at the first multiple of their alignment after the length.
+    readonly data_offset: number;
+    readonly element_size: number;
+
     constructor(public type: Type) {
+        const layout = type.layout();
+        this.data_offset = Math.ceil(2 / layout.alignment) * layout.alignment;
+        this.element_size = layout.size;
     }
 
     instantiate(data: Uint8Array): LidlObject {
@@ -29,21 +36,34 @@ export class Vector extends LidlObject {
     }
 
     dataBuffer() {
-        let offset = 2;
-        while (offset % this._type.layout().alignment != 0) {
-            offset += 1;
-        }
-        return this.sliceBuffer(offset, this.length() * this._type.layout().size);
+        return this.sliceBuffer(this._type.data_offset, this.length() * this._type.element_size);
     }
 
     get_type(): Type {
         return this._type;
     }
 
+    /**
+     * For vectors of numbers, returns a typed array aliasing the elements in the
+     * message, or undefined if they are misaligned in memory.
+     */
+    view(): any {
+        return typedView(this._type.type, this.buffer(), this._type.data_offset, this.length());
+    }
+
+    /**
+     * Vectors of numbers are returned as typed arrays, which alias the message when
+     * possible, other vectors as arrays of element values.
+     */
     get value(): any {
-        const arr = [];
-        for (let i = 0; i < this.length(); ++i) {
-            arr.push(this.at(i).value);
+        if (this._type.type.typed_array) {
+            return typedArray(this._type.type, this.buffer(), this._type.data_offset, this.length());
+        }
+
+        const len = this.length();
+        const arr = new Array(len);
+        for (let i = 0; i < len; ++i) {
+            arr[i] = this.at(i).value;
         }
         return arr;
     }
@@ -53,7 +73,7 @@ export class Vector extends LidlObject {
     }
 
     private buffer_for(idx: number): Uint8Array {
-        const baseBuffer = this.dataBuffer();
-        return baseBuffer.subarray(idx * this._type.type.layout().size, (idx + 1) * this._type.type.layout().size);
+        const size = this._type.element_size;
+        return this.sliceBuffer(this._type.data_offset + idx * size, size);
     }
-}
\ No newline at end of file
+}
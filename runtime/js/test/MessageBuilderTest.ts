@@ -0,0 +1,37 @@
+import * as lidl from "../lidl";
+import { describe } from 'mocha';
+import { expect } from 'chai';
+
+describe("Message builder grows", () => {
+    it('should keep earlier objects valid', function () {
+        const mb = new lidl.MessageBuilder(64);
+        const strtype = new lidl.LidlStringClass();
+        const first = strtype.create(mb, "hello world");
+        const long = "x".repeat(1000);
+        const second = strtype.create(mb, long);
+        const ptr = lidl.CreateObject(new lidl.PointerClass(strtype), mb, first);
+        expect(mb.capacity()).to.be.at.least(mb.size());
+        expect(second.value).to.equal(long);
+        expect(ptr.value).to.equal("hello world");
+    });
+
+    it('should reject messages larger than the maximum', function () {
+        const mb = new lidl.MessageBuilder();
+        expect(() => mb.allocate(lidl.MaxMessageSize + 1, 1)).to.throw(RangeError);
+    });
+});
+
+describe("Message builder pool", () => {
+    it('should reuse released builders', function () {
+        const pool = new lidl.MessageBuilderPool();
+        const mb = pool.acquire(new lidl.Uint8Class());
+        lidl.CreateObject(new lidl.Uint8Class(), mb, 42);
+        pool.release(mb);
+
+        const again = pool.acquire(1);
+        expect(again).to.equal(mb);
+        expect(again.size()).to.equal(0);
+        const u8 = lidl.CreateObject(new lidl.Uint8Class(), again, 7);
+        expect(u8.value).to.equal(7);
+    });
+});
@@ -0,0 +1,37 @@
+import * as lidl from "../lidl";
+import { describe } from 'mocha';
+import { expect } from 'chai';
+
+function makeVector(mb: lidl.MessageBuilder, values: number[]): lidl.Vector {
+    const type = new lidl.VectorClass(new lidl.Uint16Class());
+    const buf = mb.allocate(type.data_offset + values.length * 2, 2);
+    const view = new DataView(buf.buffer, buf.byteOffset, buf.byteLength);
+    view.setInt16(0, values.length, true);
+    values.forEach((v, i) => view.setUint16(type.data_offset + i * 2, v, true));
+    return <lidl.Vector>type.instantiate(buf);
+}
+
+describe("Numeric vectors", () => {
+    it('should be read as typed arrays', function () {
+        const vec = makeVector(new lidl.MessageBuilder(), [1, 2, 3]);
+        expect(vec.value).to.be.instanceOf(Uint16Array);
+        expect(Array.from(vec.value)).to.deep.equal([1, 2, 3]);
+        expect(vec.at(1).value).to.equal(2);
+    });
+
+    it('should alias the message when aligned', function () {
+        const vec = makeVector(new lidl.MessageBuilder(), [1, 2, 3]);
+        vec.view()[0] = 42;
+        expect(vec.at(0).value).to.equal(42);
+    });
+
+    it('should be copied when misaligned', function () {
+        const mb = new lidl.MessageBuilder();
+        const src = makeVector(mb, [1, 2, 3]);
+        const copy = new Uint8Array(src.buffer().length + 1);
+        copy.set(src.buffer(), 1);
+        const vec = <lidl.Vector>src.get_type().instantiate(copy.subarray(1));
+        expect(vec.view()).to.be.undefined;
+        expect(Array.from(vec.value)).to.deep.equal([1, 2, 3]);
+    });
+});
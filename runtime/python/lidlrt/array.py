@@ -1,6 +1,6 @@
 from .basic_types import StoredObject, anon_init
 from .pointer import Pointer
-from .detail import self_or_val
+from .detail import self_or_val, packed_view
 
 
 def Array(base_type, arr_size: int):
@@ -10,6 +10,11 @@ def Array(base_type, arr_size: int):
         effective_base_type = Pointer(base_type)
         pass
 
+    # Elements of basic types are unpacked straight from the buffer.
+    packer = None
+    if not hasattr(effective_base_type, "is_ptr"):
+        packer = getattr(effective_base_type, "packer", None)
+
     class ArrayType(StoredObject):
         def __len__(self):
             return arr_size
@@ -19,20 +24,52 @@ def Array(base_type, arr_size: int):
             buffers = (self._mem.get_slice(i * elem_size, elem_size) for i in range(arr_size))
             return [effective_base_type.from_memory(buffer) for buffer in buffers]
 
+        def elem_offset(self, idx: int):
+            if idx < 0:
+                idx += arr_size
+            if not 0 <= idx < arr_size:
+                raise IndexError("array index out of range")
+            return idx * effective_base_type.size
+
         def __getitem__(self, idx: int):
-            return self_or_val(self.raw_items()[idx])
+            if packer is not None:
+                mem = self._mem
+                return packer.unpack_from(mem._data, mem.get_base() + self.elem_offset(idx))[0]
+            mem = self._mem.get_slice(self.elem_offset(idx), effective_base_type.size)
+            return self_or_val(effective_base_type.from_memory(mem))
 
         def __setitem__(self, key, value):
+            if packer is not None:
+                mem = self._mem
+                packer.pack_into(mem._data, mem.get_base() + self.elem_offset(key), self_or_val(value))
+                return
             self.raw_items()[key].assign(value)
 
+        def view(self) -> memoryview:
+            """
+            Returns a zero copy view of the elements of an array of a numeric type.
+            """
+            return packed_view(effective_base_type, self._mem._data, self._mem.get_base(), arr_size)
+
         def __repr__(self):
             return repr(self.raw_items())
 
         def __iter__(self):
+            if packer is not None:
+                begin = self._mem.get_base()
+                end = begin + ArrayType.size
+                for (val,) in packer.iter_unpack(memoryview(self._mem._data)[begin:end]):
+                    yield val
+                return
             for elem in self.raw_items():
                 yield self_or_val(elem)
 
         def assign(self, vals):
+            if packer is not None:
+                begin = self._mem.get_base()
+                for i, val in zip(range(arr_size), vals):
+                    packer.pack_into(self._mem._data, begin + i * packer.size, self_or_val(val))
+                return
             for el, val in zip(self.raw_items(), vals):
                 el.assign(val)
 
@@ -65,19 +65,38 @@ def make_basic(t):
     return BoundT
 
 
-def make_int(sz: int, signed: bool):
-    class Ret(CommonBasicType):
+def make_packed(fmt: str):
+    """
+    Basic types are read and written through a precompiled struct.Struct straight from
+    the underlying buffer, without slicing it first.
+
+    fmt is the struct format character of the type. It's also the memoryview format
+    vectors and arrays of the type are cast to.
+    """
+    packer = struct.Struct("<" + fmt)
+
+    class Packed(CommonBasicType):
         @staticmethod
         def read(mem: Memory):
-            buf = mem.get_slice(0, sz)
-            return int.from_bytes(buf.raw_bytes(), byteorder='little', signed=signed)
+            return packer.unpack_from(mem._data, mem._begin)[0]
 
         @staticmethod
-        def write(mem: Memory, val: int):
-            buf = mem.get_slice(0, sz)
-            buf.raw_bytes()[:] = val.to_bytes(sz, byteorder='little', signed=signed)
+        def write(mem: Memory, val):
+            packer.pack_into(mem._data, mem._begin, val)
+
+        format = fmt
+        size = packer.size
+
+    Packed.packer = packer
 
-        size = sz
+    return Packed
+
+
+def make_int(sz: int, signed: bool):
+    fmt = {1: "b", 2: "h", 4: "i", 8: "q"}[sz]
+
+    class Ret(make_packed(fmt if signed else fmt.upper())):
+        pass
 
     Ret.__name__ = f"{'I' if signed else 'U'}{sz * 8}"
 
@@ -85,19 +104,8 @@ def make_int(sz: int, signed: bool):
 
 
 def make_float(sz: int):
-    class FloatType(CommonBasicType):
-        @staticmethod
-        def read(mem: Memory):
-            buf = mem.get_slice(0, sz)
-            [val] = struct.unpack("f" if sz == 4 else "d", buf.raw_bytes())
-            return val
-
-        @staticmethod
-        def write(mem: Memory, val: float):
-            buf = mem.get_slice(0, sz)
-            buf.raw_bytes()[:] = struct.pack("f" if sz == 4 else "d", val)
-
-        size = sz
+    class FloatType(make_packed("f" if sz == 4 else "d")):
+        pass
 
     FloatType.__name__ = f"f{sz * 8}"
 
@@ -119,10 +127,5 @@ F64 = make_float(8)
 
 
 @make_basic
-class Bool(CommonBasicType):
-    @staticmethod
-    def read(mem: Memory):
-        buf = mem.get_slice(0, 1)
-        return bool.from_bytes(buf.raw_bytes(), byteorder='little')
-
-    size = 1
+class Bool(make_packed("?")):
+    pass
@@ -10,8 +10,7 @@ class Builder:
         self._avail = self._buf
 
     def allocate(self, sz: int, align: int = 1) -> Memory:
-        while self._avail.get_base() % align != 0:
-            self._avail = self._avail.get_slice(0, length=1)
+        self._avail = self._avail.get_slice(-self._avail.get_base() % align)
 
         alloc = self._avail.get_slice(0, length=sz)
         self._avail = self._avail.get_slice(sz)
@@ -19,10 +18,10 @@ class Builder:
         return alloc
 
     def create_raw(self, type):
-        return type.from_memory(mem=self.allocate(type.size, 1))
+        return type.from_memory(mem=self.allocate(type.size, getattr(type, "alignment", 1)))
 
     def create(self, type, **kwargs):
-        return type(mem=self.allocate(type.size, 1), **kwargs)
+        return type(mem=self.allocate(type.size, getattr(type, "alignment", 1)), **kwargs)
 
     def get(self):
         mem = self._buf.get_slice(0, self._avail.get_base())
@@ -80,6 +80,47 @@ def make_repr(is_struct: bool, description):
         return union_repr(description)
 
 
+def make_member_property(name, off, typ):
+    """
+    Members are only decoded when they are accessed.
+
+    Basic members are unpacked straight from the buffer with the precompiled format of
+    their type. Other members are wrapped in an object of their type the first time they
+    are accessed, and the wrapper is reused afterwards.
+    """
+    packer = getattr(typ, "packer", None)
+    if packer is not None and not hasattr(typ, "is_ptr"):
+        unpack_from = packer.unpack_from
+        pack_into = packer.pack_into
+
+        def getter(instance):
+            mem = instance._mem
+            return unpack_from(mem._data, mem._begin + off)[0]
+
+        def setter(instance, val):
+            mem = instance._mem
+            pack_into(mem._data, mem._begin + off, self_or_val(val))
+
+        return property(getter, setter)
+
+    cache_name = f"_member_{name}"
+
+    def wrapper(instance):
+        obj = instance.__dict__.get(cache_name)
+        if obj is None:
+            obj = typ.from_memory(instance._mem.get_slice(off, typ.size))
+            instance.__dict__[cache_name] = obj
+        return obj
+
+    def getter(instance):
+        return self_or_val(wrapper(instance))
+
+    def setter(instance, val):
+        wrapper(instance).assign(val)
+
+    return property(getter, setter)
+
+
 def make_compound(is_struct, description):
     class CompoundType(description, StoredObject):
         def assign(self, val):
@@ -95,15 +136,7 @@ def make_compound(is_struct, description):
                 setattr(self, name, getattr(val, name))
 
     for name, mem in description.members.items():
-        def getter(instance, off=mem["offset"], typ=mem["type"]):
-            buf = instance._mem.get_slice(off, typ.size)
-            return self_or_val(typ.from_memory(buf))
-
-        def setter(instance, val, off=mem["offset"], typ=mem["type"]):
-            buf = instance._mem.get_slice(off, typ.size)
-            typ.from_memory(buf).assign(val)
-
-        setattr(CompoundType, name, property(getter, setter))
+        setattr(CompoundType, name, make_member_property(name, mem["offset"], mem["type"]))
 
     CompoundType.__name__ = description.__name__
     CompoundType.__init__ = make_ctor(CompoundType, description, is_struct)
@@ -1,4 +1,22 @@
+import sys
+
+
 def self_or_val(e):
     if hasattr(e, "value"):
         return e.value
     return e
+
+
+def packed_view(elem_type, data, begin: int, count: int) -> memoryview:
+    """
+    Returns a zero copy view of count elements of a basic type stored in data, starting
+    at begin. The view supports the buffer protocol, so numpy.asarray and
+    numpy.frombuffer can wrap it without copying.
+    """
+    if not hasattr(elem_type, "packer") or hasattr(elem_type, "is_ptr"):
+        raise TypeError(f"{elem_type.__name__} elements cannot be viewed")
+    if sys.byteorder != "little":
+        # memoryview.cast only supports native formats.
+        raise NotImplementedError("views are only supported on little endian hosts")
+    end = begin + count * elem_type.size
+    return memoryview(data)[begin:end].cast(elem_type.format)
@@ -7,16 +7,13 @@ from .pointer import Pointer
 
 
 def copy_arg_to_build_call(builder: Builder, arg):
-    print(arg.__class__)
     if isinstance(arg, str):
         # copy as lidl.String
         return String.create(builder, arg)
 
     if isinstance(arg, bytes):
         # copy as lidl.Vector(U8)
-        res = Vector(U8).create(builder, arg)
-        print("vector")
-        return res
+        return Vector(U8).create(builder, arg)
 
     if isinstance(arg, list):
         raise NotImplementedError("Passing lists not supported yet!")
@@ -40,7 +37,6 @@ def copy_args_to_struct(params_struct):
     def func(builder=None, **kwargs):
         for key in kwargs.keys():
             kwargs[key] = copy_arg_to_build_call(builder, kwargs[key])
-            print(kwargs[key])
         if hasattr(params_struct, "is_ref"):
             return builder.create(params_struct, **kwargs)
         return params_struct(**kwargs)
@@ -70,14 +66,12 @@ def generate_proc(cls, proc_name: str):
 
     def fn(instance, **kwargs):
         builder = Builder(Memory(bytearray(1024)))
-        call = params_union(proc_name, builder=builder, **kwargs)
-        print(call)
+        params_union(proc_name, builder=builder, **kwargs)
         res = instance.send_receive(builder.get())
         res_size = cls.return_union.size
         base = res.get_end() - res_size
         res.set_base(base)
         ret = cls.return_union.from_memory(res)
-        #print(ret)
         return copy_res_to_return(cls, proc_name, ret)
 
     fn.__name__ = proc_name
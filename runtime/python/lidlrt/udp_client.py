@@ -9,9 +9,7 @@ def udp_client(service_type, endpoint):
 
     def send_receive(x):
         sock.sendto(bytes(x), endpoint)
-        print(f"Sending {x.hex()}")
         data, addr = sock.recvfrom(2048)
-        print(f"Received {data.hex()}")
         return Memory(data)
 
     setattr(fs, "send_receive", send_receive)
@@ -1,6 +1,6 @@
 from .basic_types import StoredObject, anon_init, I16
 from .pointer import Pointer
-from .detail import self_or_val
+from .detail import self_or_val, packed_view
 from .builder import Builder
 
 
@@ -11,19 +11,24 @@ def Vector(base_type):
         effective_base_type = Pointer(base_type)
         pass
 
+    # Elements of basic types are unpacked straight from the buffer.
+    packer = None
+    if not hasattr(effective_base_type, "is_ptr"):
+        packer = getattr(effective_base_type, "packer", None)
+
     class VectorType(StoredObject):
         def __len__(self):
             return I16.read(self._mem)
 
-        def items_buffer(self):
-            elem_size = effective_base_type.size
+        def items_begin(self):
+            # The elements start after the length, aligned for the element type.
             elem_align = effective_base_type.size
-            addr_after_len = self._mem.get_base()
-            while addr_after_len % elem_align != 0:
-                addr_after_len += 1
-            elems_offset = addr_after_len - self._mem.get_base()
-            buffer = self._mem.get_slice(I16.size + elems_offset, elem_size * len(self))
-            return buffer
+            begin = self._mem.get_base() + I16.size
+            return begin + (-begin % elem_align)
+
+        def items_buffer(self):
+            begin = self.items_begin() - self._mem.get_base()
+            return self._mem.get_slice(begin, effective_base_type.size * len(self))
 
         def raw_items(self):
             elem_size = effective_base_type.size
@@ -31,27 +36,58 @@ def Vector(base_type):
             buffers = (buffer.get_slice(i * elem_size, elem_size) for i in range(len(self)))
             return [effective_base_type.from_memory(buffer) for buffer in buffers]
 
+        def elem_offset(self, idx: int):
+            size = len(self)
+            if idx < 0:
+                idx += size
+            if not 0 <= idx < size:
+                raise IndexError("vector index out of range")
+            return self.items_begin() + idx * effective_base_type.size
+
         def __getitem__(self, idx: int):
-            return self_or_val(self.raw_items()[idx])
+            if packer is not None:
+                return packer.unpack_from(self._mem._data, self.elem_offset(idx))[0]
+            mem = self._mem.get_slice(self.elem_offset(idx) - self._mem.get_base(),
+                                      effective_base_type.size)
+            return self_or_val(effective_base_type.from_memory(mem))
 
         def __setitem__(self, key, value):
+            if packer is not None:
+                packer.pack_into(self._mem._data, self.elem_offset(key), self_or_val(value))
+                return
             self.raw_items()[key].assign(value)
 
+        def view(self) -> memoryview:
+            """
+            Returns a zero copy view of the elements of a vector of a numeric type.
+            """
+            return packed_view(effective_base_type, self._mem._data, self.items_begin(), len(self))
+
         def __repr__(self):
             return repr(self.raw_items())
 
         def __iter__(self):
+            if packer is not None:
+                begin = self.items_begin()
+                end = begin + len(self) * packer.size
+                for (val,) in packer.iter_unpack(memoryview(self._mem._data)[begin:end]):
+                    yield val
+                return
             for elem in self.raw_items():
                 yield self_or_val(elem)
 
         def assign(self, vals):
+            if packer is not None:
+                begin = self.items_begin()
+                for i, val in zip(range(len(self)), vals):
+                    packer.pack_into(self._mem._data, begin + i * packer.size, self_or_val(val))
+                return
             for el, val in zip(self.raw_items(), vals):
                 el.assign(val)
 
         @staticmethod
         def create(builder: Builder, data):
             mem = builder.allocate(2, 1)
-            print("vector")
 
             I16.from_memory(mem).value = len(data)
 
@@ -1,7 +1,25 @@
+#![no_std]
+
 mod message_builder;
-mod string;
 mod pointer;
+mod string;
+mod vector;
+mod verify;
 
+pub use message_builder::{MessageBuilder, Offset};
+pub use pointer::Pointer;
 pub use string::String;
-pub use message_builder::MessageBuilder;
-pub use pointer::Pointer;
\ No newline at end of file
+pub use vector::Vector;
+pub use verify::{Plain, Verifier, Verify};
+
+use core::mem::size_of;
+
+/// Returns the root object of a message, which is at its end, after checking that it
+/// and everything it points to is within the message and well formed.
+pub fn get_root<T: Verify>(buf: &[u8]) -> Option<&T> {
+    let pos = buf.len().checked_sub(size_of::<T>())?;
+    if !T::verify(&mut Verifier::new(buf), pos) {
+        return None;
+    }
+    Some(unsafe { &*(buf.as_ptr().add(pos) as *const T) })
+}
@@ -1,28 +1,220 @@
+use crate::pointer::Pointer;
+use crate::string::String;
+use crate::vector::{data_offset, Vector};
+use crate::verify::Plain;
+use core::convert::TryFrom;
+use core::marker::PhantomData;
+use core::mem::{align_of, size_of};
+use core::ptr;
+
+/// Position of a T built in a message builder. Objects are referred to by position
+/// while a message is being built, since the builder is still borrowed mutably.
+pub struct Offset<T> {
+    pos: usize,
+    _t: PhantomData<fn() -> T>,
+}
+
+impl<T> Clone for Offset<T> {
+    fn clone(&self) -> Self {
+        *self
+    }
+}
+
+impl<T> Copy for Offset<T> {}
+
+impl<T> Offset<T> {
+    fn new(pos: usize) -> Offset<T> {
+        Offset {
+            pos,
+            _t: PhantomData,
+        }
+    }
+
+    pub fn pos(&self) -> usize {
+        self.pos
+    }
+
+    /// Position of the member at the given offset in this object.
+    pub fn member(&self, offset: usize) -> usize {
+        self.pos + offset
+    }
+}
+
+/// Builds messages in a caller provided buffer. Every allocation returns None once the
+/// buffer runs out.
 pub struct MessageBuilder<'a> {
     data: &'a mut [u8],
-    ptr: u32,
+    ptr: usize,
 }
 
-impl MessageBuilder<'_> {
-    pub fn new<'a>(buf: &'a mut [u8]) -> MessageBuilder {
+impl<'a> MessageBuilder<'a> {
+    pub fn new(buf: &'a mut [u8]) -> MessageBuilder<'a> {
         MessageBuilder { data: buf, ptr: 0 }
     }
 
-    pub fn allocate<'a>(&'a self, size: i32, align: i32) -> &'a mut [u8] {
-        unsafe {
-            let const_self_ptr = self as *const MessageBuilder;
-            let self_ptr = const_self_ptr as *mut MessageBuilder;
-            let mut_self = &mut *self_ptr;
+    pub fn size(&self) -> usize {
+        self.ptr
+    }
+
+    /// The message built so far. Its root is the last object that was built.
+    pub fn get_buffer(&self) -> &[u8] {
+        &self.data[..self.ptr]
+    }
+
+    /// Reserves size zeroed bytes aligned to align, and returns their position.
+    pub fn allocate(&mut self, size: usize, align: usize) -> Option<usize> {
+        let begin = (self.ptr + align - 1) / align * align;
+        let end = begin.checked_add(size)?;
+        if end > self.data.len() {
+            return None;
+        }
+        for b in &mut self.data[self.ptr..end] {
+            *b = 0;
+        }
+        self.ptr = end;
+        Some(begin)
+    }
+
+    /// Reserves a zeroed T, for generated code to fill its members in.
+    pub fn allocate_object<T>(&mut self) -> Option<Offset<T>> {
+        self.allocate(size_of::<T>(), align_of::<T>()).map(Offset::new)
+    }
+
+    /// Writes a value at pos, which must be within an object allocated for it.
+    pub fn write<T: Plain>(&mut self, pos: usize, val: T) {
+        let dest = &mut self.data[pos..pos + size_of::<T>()];
+        // Plain values have no padding, so every byte copied is initialized.
+        unsafe { ptr::write_unaligned(dest.as_mut_ptr() as *mut T, val) }
+    }
+
+    /// Points the pointer at pos to the object at `to`. Returns None if the object is
+    /// too far away for a 16 bit offset, or is the pointer itself, which would read as
+    /// null.
+    pub fn write_pointer<T>(&mut self, pos: usize, to: Offset<T>) -> Option<()> {
+        let offset = pos as isize - to.pos as isize;
+        if offset == 0 || offset < i16::MIN as isize || offset > i16::MAX as isize {
+            return None;
+        }
+        self.write(pos, offset as i16);
+        Some(())
+    }
+
+    pub fn create<T: Plain>(&mut self, val: T) -> Option<Offset<T>> {
+        let obj = self.allocate_object::<T>()?;
+        self.write(obj.pos, val);
+        Some(obj)
+    }
+
+    pub fn create_pointer<T>(&mut self, to: Offset<T>) -> Option<Offset<Pointer<T>>> {
+        let obj = self.allocate_object::<Pointer<T>>()?;
+        self.write_pointer(obj.pos, to)?;
+        Some(obj)
+    }
+
+    pub fn create_string(&mut self, s: &str) -> Option<Offset<String>> {
+        let len = i16::try_from(s.len()).ok()?;
+        let obj = self.allocate(2 + s.len(), align_of::<String>())?;
+        self.write(obj, len);
+        self.data[obj + 2..obj + 2 + s.len()].copy_from_slice(s.as_bytes());
+        Some(Offset::new(obj))
+    }
 
-            while mut_self.ptr % align as u32 != 0 {
-                mut_self.ptr += 1;
-            }
+    fn allocate_vector<T>(&mut self, len: usize) -> Option<(usize, usize)> {
+        let len16 = i16::try_from(len).ok()?;
+        let obj = self.allocate(size_of::<Vector<T>>(), align_of::<Vector<T>>())?;
+        self.write(obj, len16);
 
-            let res = &mut mut_self.data[mut_self.ptr as usize..mut_self.ptr as usize + size as usize];
+        // Elements are aligned in memory, like the readers expect them to be.
+        let addr = self.data.as_ptr() as usize + obj;
+        let begin = obj + data_offset::<T>(addr);
+        self.allocate(begin + len * size_of::<T>() - self.ptr, 1)?;
+        Some((obj, begin))
+    }
 
-            mut_self.ptr += size as u32;
+    pub fn create_vector<T: Plain>(&mut self, elems: &[T]) -> Option<Offset<Vector<T>>> {
+        let (obj, begin) = self.allocate_vector::<T>(elems.len())?;
+        for (i, elem) in elems.iter().enumerate() {
+            self.write(begin + i * size_of::<T>(), *elem);
+        }
+        Some(Offset::new(obj))
+    }
 
-            res
+    pub fn create_vector_of_pointers<T>(
+        &mut self,
+        elems: &[Offset<T>],
+    ) -> Option<Offset<Vector<Pointer<T>>>> {
+        let (obj, begin) = self.allocate_vector::<Pointer<T>>(elems.len())?;
+        for (i, elem) in elems.iter().enumerate() {
+            self.write_pointer(begin + i * size_of::<Pointer<T>>(), *elem)?;
         }
+        Some(Offset::new(obj))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::get_root;
+
+    #[repr(align(8))]
+    struct Buffer([u8; 128]);
+
+    #[test]
+    fn string_round_trip() {
+        let mut buf = Buffer([0xff; 128]);
+        let mut mb = MessageBuilder::new(&mut buf.0);
+        let s = mb.create_string("hello").unwrap();
+        mb.create_pointer(s).unwrap();
+
+        let root = get_root::<Pointer<String>>(mb.get_buffer()).unwrap();
+        assert_eq!("hello", root.get().get());
+    }
+
+    #[test]
+    fn vector_round_trip() {
+        let mut buf = Buffer([0xff; 128]);
+        let mut mb = MessageBuilder::new(&mut buf.0);
+        // Misaligns the vector, so that its elements need padding.
+        mb.create(1u8).unwrap();
+        let v = mb.create_vector(&[1u32, 2, 3]).unwrap();
+        mb.create_pointer(v).unwrap();
+
+        let root = get_root::<Pointer<Vector<u32>>>(mb.get_buffer()).unwrap();
+        assert_eq!(&[1, 2, 3], root.as_slice());
+    }
+
+    #[test]
+    fn vector_of_pointers_round_trip() {
+        let mut buf = Buffer([0xff; 128]);
+        let mut mb = MessageBuilder::new(&mut buf.0);
+        let a = mb.create_string("a").unwrap();
+        let b = mb.create_string("bc").unwrap();
+        let v = mb.create_vector_of_pointers(&[a, b, a]).unwrap();
+        mb.create_pointer(v).unwrap();
+
+        let root = get_root::<Pointer<Vector<Pointer<String>>>>(mb.get_buffer()).unwrap();
+        let strs: [&str; 3] = [root[0].get(), root[1].get(), root[2].get()];
+        assert_eq!(["a", "bc", "a"], strs);
+    }
+
+    #[test]
+    fn rejects_null_pointers() {
+        let mut buf = Buffer([0; 128]);
+        let mut mb = MessageBuilder::new(&mut buf.0);
+        let ptr = mb.allocate_object::<Pointer<u32>>().unwrap();
+        assert!(mb.write_pointer(ptr.pos(), Offset::<u32>::new(ptr.pos())).is_none());
+
+        // A pointer that was never written is null.
+        assert!(get_root::<Pointer<u32>>(mb.get_buffer()).is_none());
     }
-}
\ No newline at end of file
+
+    #[test]
+    fn runs_out_of_space() {
+        let mut buf = Buffer([0; 128]);
+        let mut mb = MessageBuilder::new(&mut buf.0[..8]);
+        assert!(mb.create_string("too long for this").is_none());
+        assert!(mb.create(0u64).is_some());
+        assert!(mb.create(0u8).is_none());
+        assert_eq!(8, mb.size());
+    }
+}
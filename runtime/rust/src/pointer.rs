@@ -1,17 +1,94 @@
-use crate::MessageBuilder;
+use crate::verify::{Verifier, Verify};
+use core::marker::PhantomData;
+use core::ops::Deref;
 
+/// A self relative pointer: the pointee lives `offset` bytes before the pointer itself.
+/// An offset of 0 is a null pointer, like in the other runtimes, so it never verifies.
+///
+/// Pointers only make sense where they are in a message, so they can't be copied or
+/// moved out of one.
 #[repr(C)]
 pub struct Pointer<T> {
     offset: i16,
-    _: std::marker::PhantomData<T>
+    _pointee: PhantomData<T>,
 }
 
 impl<T> Pointer<T> {
-    fn deref<'a>(&'a self) -> &'a T {
+    pub fn offset(&self) -> i16 {
+        self.offset
+    }
+
+    pub fn get(&self) -> &T {
+        // Pointers are only reachable through a verified message, which checked that
+        // the pointee is in bounds and valid.
         unsafe {
-            let ptr_to_self = &self as *const Self;
-            let ptr_to_bytes = ptr_to_self as *const u8;
-            let ptr_to_pointee = ptr_to_bytes.sub(self.offset);
+            let this = self as *const Self as *const u8;
+            &*(this.offset(-(self.offset as isize)) as *const T)
+        }
+    }
+}
+
+impl<T> Deref for Pointer<T> {
+    type Target = T;
+
+    fn deref(&self) -> &T {
+        self.get()
+    }
+}
+
+unsafe impl<T: Verify> Verify for Pointer<T> {
+    fn verify(v: &mut Verifier, pos: usize) -> bool {
+        if !v.in_bounds_of::<Self>(pos) {
+            return false;
         }
+        let offset = v.read_i16(pos) as isize;
+        let target = pos as isize - offset;
+        offset != 0 && target >= 0 && v.follow::<T>(target as usize)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[repr(align(8))]
+    struct Buffer([u8; 8]);
+
+    // A u32 at 0, and a pointer to it with the given offset at pos.
+    fn verify_at(pos: usize, offset: i16) -> bool {
+        let mut buf = Buffer([0; 8]);
+        buf.0[..4].copy_from_slice(&42u32.to_le_bytes());
+        buf.0[pos..pos + 2].copy_from_slice(&offset.to_le_bytes());
+        Pointer::<u32>::verify(&mut Verifier::new(&buf.0), pos)
+    }
+
+    #[test]
+    fn in_bounds() {
+        assert!(verify_at(4, 4));
+        assert!(verify_at(6, 6));
+    }
+
+    #[test]
+    fn out_of_bounds() {
+        // Before the start of the message.
+        assert!(!verify_at(4, 8));
+        assert!(!verify_at(4, i16::MAX));
+        // After the pointer, with the pointee running past the end of the message.
+        assert!(!verify_at(4, -4));
+        assert!(!verify_at(4, i16::MIN));
+    }
+
+    #[test]
+    fn misaligned() {
+        // The pointee is not aligned for a u32.
+        assert!(!verify_at(4, 2));
+        // The pointer itself is not aligned.
+        assert!(!verify_at(5, 5));
     }
-}
\ No newline at end of file
+
+    #[test]
+    fn zero_offset_is_null() {
+        assert!(!verify_at(4, 0));
+        assert!(!verify_at(0, 0));
+    }
+}
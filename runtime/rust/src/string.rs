@@ -1,8 +1,13 @@
-use crate::MessageBuilder;
+use crate::verify::{Verifier, Verify};
+use core::fmt;
+use core::ops::Deref;
+use core::slice;
+use core::str;
 
+/// A length followed by that many bytes of UTF-8.
 #[repr(C)]
 pub struct String {
-    len: i16
+    len: i16,
 }
 
 impl String {
@@ -10,38 +15,54 @@ impl String {
         self.len
     }
 
-    pub fn get<'a>(&'a self) -> &'a str {
-        use core::slice;
-        use core::str;
-
+    pub fn as_bytes(&self) -> &[u8] {
+        // Strings are only reachable through a verified message, which checked that the
+        // contents are in bounds.
         unsafe {
             // The string contents lie right after the length.
             let ptr = (&self.len as *const i16).offset(1) as *const u8;
+            slice::from_raw_parts(ptr, self.len as usize)
+        }
+    }
+
+    pub fn get(&self) -> &str {
+        // Verification checked the contents are UTF-8.
+        unsafe { str::from_utf8_unchecked(self.as_bytes()) }
+    }
+}
 
-            let slice = slice::from_raw_parts(ptr, self.size() as usize);
+impl Deref for String {
+    type Target = str;
 
-            str::from_utf8(slice).unwrap()
-        }
+    fn deref(&self) -> &str {
+        self.get()
     }
+}
 
-    pub fn from_buffer<'a>(buf: &'a[u8]) -> &'a String {
-        unsafe {
-            let buf_ptr :*const u8 = &buf[0];
-            let ptr = buf_ptr as *const String;
-            &*ptr
-        }
+impl fmt::Display for String {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        f.write_str(self.get())
     }
+}
 
-    pub fn new<'a>(mb: &'a mut MessageBuilder<'a>, str: &str) -> &'a String {
-        let buffer = mb.allocate(2, 1);
-        let content = mb.allocate(str.bytes().len() as i32, 1);
+impl fmt::Debug for String {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        fmt::Debug::fmt(self.get(), f)
+    }
+}
 
-        unsafe {
-            let ptr = (&mut buffer[0] as *mut u8) as *mut i16;
-            *ptr = str.as_bytes().len() as i16
+unsafe impl Verify for String {
+    fn verify(v: &mut Verifier, pos: usize) -> bool {
+        if !v.in_bounds_of::<Self>(pos) {
+            return false;
+        }
+        let len = v.read_i16(pos);
+        if len < 0 {
+            return false;
         }
 
-        content.copy_from_slice(str.as_bytes());
-        String::from_buffer(buffer)
+        let begin = pos + 2;
+        v.in_bounds(begin, len as usize, 1)
+            && str::from_utf8(&v.buffer()[begin..begin + len as usize]).is_ok()
     }
 }
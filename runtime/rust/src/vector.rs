@@ -1,6 +1,67 @@
-use crate::MessageBuilder;
+use crate::verify::{Verifier, Verify};
+use core::marker::PhantomData;
+use core::mem::{align_of, size_of};
+use core::ops::Deref;
+use core::slice;
 
+/// A length followed by that many elements. The elements start at the first address
+/// after the length that is aligned for them.
 #[repr(C)]
-pub struct String {
-    len: i16
-}
\ No newline at end of file
+pub struct Vector<T> {
+    len: i16,
+    _elems: PhantomData<T>,
+}
+
+/// Number of bytes between a vector at address addr and its first element.
+pub(crate) fn data_offset<T>(addr: usize) -> usize {
+    let begin = addr + size_of::<i16>();
+    let align = align_of::<T>();
+    (begin + align - 1) / align * align - addr
+}
+
+impl<T> Vector<T> {
+    pub fn len(&self) -> usize {
+        self.len as usize
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    pub fn as_slice(&self) -> &[T] {
+        // Vectors are only reachable through a verified message, which checked that the
+        // elements are in bounds and valid.
+        unsafe {
+            let this = self as *const Self as *const u8;
+            let data = this.add(data_offset::<T>(this as usize)) as *const T;
+            slice::from_raw_parts(data, self.len())
+        }
+    }
+}
+
+impl<T> Deref for Vector<T> {
+    type Target = [T];
+
+    fn deref(&self) -> &[T] {
+        self.as_slice()
+    }
+}
+
+unsafe impl<T: Verify> Verify for Vector<T> {
+    fn verify(v: &mut Verifier, pos: usize) -> bool {
+        if !v.in_bounds_of::<Self>(pos) {
+            return false;
+        }
+        let len = v.read_i16(pos);
+        if len < 0 {
+            return false;
+        }
+
+        let begin = pos + data_offset::<T>(v.buffer().as_ptr() as usize + pos);
+        let size = len as usize * size_of::<T>();
+        if !v.in_bounds(begin, size, align_of::<T>()) {
+            return false;
+        }
+        T::PLAIN || (0..len as usize).all(|i| T::verify(v, begin + i * size_of::<T>()))
+    }
+}
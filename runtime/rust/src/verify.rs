@@ -0,0 +1,130 @@
+use core::mem::{align_of, size_of};
+use core::ptr;
+
+// Pointers may form cycles, and a message could point to the same object many times, so
+// the verifier bounds both how deep it follows pointers and how many it follows overall.
+const MAX_DEPTH: u32 = 64;
+
+/// Walks a message before any of it is handed out as references, checking that every
+/// object is in bounds, aligned and well formed.
+pub struct Verifier<'a> {
+    buf: &'a [u8],
+    depth: u32,
+    budget: usize,
+}
+
+impl<'a> Verifier<'a> {
+    pub fn new(buf: &'a [u8]) -> Verifier<'a> {
+        Verifier {
+            buf,
+            depth: 0,
+            budget: buf.len(),
+        }
+    }
+
+    pub fn buffer(&self) -> &'a [u8] {
+        self.buf
+    }
+
+    /// Whether size bytes at pos are within the message, and pos is aligned to align in
+    /// memory.
+    pub fn in_bounds(&self, pos: usize, size: usize, align: usize) -> bool {
+        match pos.checked_add(size) {
+            Some(end) if end <= self.buf.len() => {}
+            _ => return false,
+        }
+        (self.buf.as_ptr() as usize).wrapping_add(pos) % align == 0
+    }
+
+    /// Whether a T at pos is within the message and aligned.
+    pub fn in_bounds_of<T>(&self, pos: usize) -> bool {
+        self.in_bounds(pos, size_of::<T>(), align_of::<T>())
+    }
+
+    pub fn read_i16(&self, pos: usize) -> i16 {
+        i16::from_le_bytes([self.buf[pos], self.buf[pos + 1]])
+    }
+
+    /// Verifies a T at pos and returns a copy of it.
+    pub fn read<T: Verify + Copy>(&mut self, pos: usize) -> Option<T> {
+        if !T::verify(self, pos) {
+            return None;
+        }
+        Some(unsafe { ptr::read(self.buf.as_ptr().add(pos) as *const T) })
+    }
+
+    /// Verifies a T at pos, which is reached by following a pointer.
+    pub fn follow<T: Verify>(&mut self, pos: usize) -> bool {
+        if self.depth == MAX_DEPTH || self.budget == 0 {
+            return false;
+        }
+        self.depth += 1;
+        self.budget -= 1;
+        let res = T::verify(self, pos);
+        self.depth -= 1;
+        res
+    }
+}
+
+/// Types that can be read in place from a message.
+///
+/// # Safety
+///
+/// `verify` must only return true if a `Self` can be referenced at `pos` in the
+/// verifier's buffer: it must be in bounds, aligned, hold a valid value, and everything
+/// its methods reach through pointers must have been verified as well.
+pub unsafe trait Verify: Sized {
+    /// Whether every bit pattern is a valid value, so that only the bounds of the
+    /// object need to be checked.
+    const PLAIN: bool = false;
+
+    fn verify(v: &mut Verifier, pos: usize) -> bool;
+}
+
+/// Types that can be written to a message by copying their bytes: they contain no
+/// pointers and no padding.
+///
+/// # Safety
+///
+/// Implementors must not have padding bytes, as those would be copied into the message
+/// uninitialized.
+pub unsafe trait Plain: Copy + Verify {}
+
+macro_rules! impl_numeric {
+    ($($t:ty),*) => {
+        $(
+            unsafe impl Verify for $t {
+                const PLAIN: bool = true;
+
+                fn verify(v: &mut Verifier, pos: usize) -> bool {
+                    v.in_bounds_of::<$t>(pos)
+                }
+            }
+
+            unsafe impl Plain for $t {}
+        )*
+    };
+}
+
+impl_numeric!(i8, i16, i32, i64, u8, u16, u32, u64, f32, f64);
+
+unsafe impl Verify for bool {
+    fn verify(v: &mut Verifier, pos: usize) -> bool {
+        v.in_bounds_of::<bool>(pos) && v.buffer()[pos] <= 1
+    }
+}
+
+unsafe impl Plain for bool {}
+
+unsafe impl<T: Verify, const N: usize> Verify for [T; N] {
+    const PLAIN: bool = T::PLAIN;
+
+    fn verify(v: &mut Verifier, pos: usize) -> bool {
+        if !v.in_bounds_of::<[T; N]>(pos) {
+            return false;
+        }
+        T::PLAIN || (0..N).all(|i| T::verify(v, pos + i * size_of::<T>()))
+    }
+}
+
+unsafe impl<T: Plain, const N: usize> Plain for [T; N] {}
@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <lidl/basic.hpp>
 #include <lidl/basic_types.hpp>
 #include <lidl/generics.hpp>
@@ -22,9 +23,8 @@ raw_layout pointer_type::wire_layout(const module& mod, const name&) const {
 
 YAML::Node pointer_type::bin2yaml(const module& mod,
                                   const name& instantiation,
-                                  ibinary_reader& reader) const {
-    auto& arg = std::get<name>(instantiation.args[0]);
-    if (auto pointee = get_wire_type(mod, arg); pointee) {
+                                  binary_reader& reader) const {
+    if (auto pointee = get_pointee_type(mod, instantiation); pointee) {
         auto off = reader.read_object<int16_t>();
         reader.seek(-off);
         return pointee->bin2yaml(mod, reader);
@@ -35,19 +35,41 @@ YAML::Node pointer_type::bin2yaml(const module& mod,
 int pointer_type::yaml2bin(const module& mod,
                            const name& instantiation,
                            const YAML::Node& node,
-                           ibinary_writer& writer) const {
+                           binary_writer& writer) const {
     auto& arg = std::get<name>(instantiation.args[0]);
     if (auto pointee = get_type(mod, arg); pointee) {
-        auto pointee_pos = node.as<int>();
-        writer.align(2);
-        uint16_t diff = writer.tell() - pointee_pos;
-        auto pos      = writer.tell();
-        writer.write(diff);
-        return pos;
+        return write(writer, node.as<int>());
+    }
+    throw std::runtime_error("pointee must be a regular type");
+}
+
+void pointer_type::bin2json(const module& mod,
+                            const name& instantiation,
+                            binary_reader& reader,
+                            json_writer& writer) const {
+    if (auto pointee = get_pointee_type(mod, instantiation); pointee) {
+        auto off = reader.read_object<int16_t>();
+        reader.seek(-off);
+        return pointee->bin2json(mod, reader, writer);
     }
     throw std::runtime_error("pointee must be a regular type");
 }
 
+int pointer_type::json2bin(const module& mod,
+                           const name& instantiation,
+                           const json_value& value,
+                           binary_writer& writer) const {
+    return write(writer, static_cast<int>(value.as_int()));
+}
+
+int pointer_type::write(binary_writer& writer, int pointee_pos) {
+    writer.align(2);
+    uint16_t diff = writer.tell() - pointee_pos;
+    auto pos      = writer.tell();
+    writer.write(diff);
+    return pos;
+}
+
 type_categories pointer_type::category(const module& mod,
                                        const name& instantiation) const {
     return type_categories::reference;
@@ -119,6 +141,72 @@ name array_type::get_wire_type_name_impl(const module& mod, const name& your_nam
     return name{your_name.base, {wire_name_of_arg, your_name.args.at(1)}};
 }
 
+int array_type::json2bin(const module& mod,
+                         const name& instantiation,
+                         const json_value& value,
+                         binary_writer& writer) const {
+    auto& len = std::get<int64_t>(instantiation.args[1]);
+    if (len != value.size()) {
+        throw std::runtime_error("Array sizes do not match!");
+    }
+
+    writer.align(wire_layout(mod, instantiation).alignment());
+    auto pos  = writer.tell();
+    auto& arg = std::get<name>(instantiation.args[0]);
+    if (auto pointee = get_wire_type(mod, arg); pointee) {
+        value.for_each_element(
+            [&](const json_value& elem) { pointee->json2bin(mod, elem, writer); });
+    }
+    return pos;
+}
+
+YAML::Node array_type::bin2yaml(const module& mod,
+                                const name& instantiation,
+                                binary_reader& reader) const {
+    auto& arg = std::get<name>(instantiation.args[0]);
+    if (auto pointee = get_wire_type(mod, arg); pointee) {
+        auto len    = std::get<int64_t>(instantiation.args[1]);
+        auto layout = pointee->wire_layout(mod);
+        reader.align(layout.alignment());
+
+        auto begin = reader.tell();
+
+        auto arr = YAML::Node();
+        for (int i = 0; i < len; ++i) {
+            reader.seek(begin + i * layout.size(), std::ios::beg);
+            arr.push_back(pointee->bin2yaml(mod, reader));
+        }
+
+        return arr;
+    }
+
+    throw std::runtime_error("pointee must be a regular type");
+}
+
+void array_type::bin2json(const module& mod,
+                          const name& instantiation,
+                          binary_reader& reader,
+                          json_writer& writer) const {
+    auto& arg    = std::get<name>(instantiation.args[0]);
+    auto pointee = get_wire_type(mod, arg);
+    if (!pointee) {
+        throw std::runtime_error("pointee must be a regular type");
+    }
+
+    auto len    = std::get<int64_t>(instantiation.args[1]);
+    auto layout = pointee->wire_layout(mod);
+    reader.align(layout.alignment());
+
+    auto begin = reader.tell();
+
+    writer.begin_array();
+    for (int i = 0; i < len; ++i) {
+        reader.seek(begin + i * layout.size(), std::ios::beg);
+        pointee->bin2json(mod, reader, writer);
+    }
+    writer.end_array();
+}
+
 type_categories array_type::category(const module& mod, const name& instantiation) const {
     auto& arg    = instantiation.args.front().as_name();
     auto regular = get_wire_type(mod, arg);
@@ -129,23 +217,21 @@ type_categories array_type::category(const module& mod, const name& instantiatio
 int vector_type::yaml2bin(const module& mod,
                           const name& instantiation,
                           const YAML::Node& node,
-                          ibinary_writer& writer) const {
+                          binary_writer& writer) const {
     auto& arg    = std::get<name>(instantiation.args[0]);
     auto pointee = get_wire_type(mod, arg);
     Expects(pointee != nullptr);
 
     if (pointee->is_reference_type(mod)) {
-        auto actual_pointee =
-            get_wire_type(mod, std::get<name>(arg.args[0].get_variant()));
+        auto actual_pointee = get_pointee_type(mod, arg);
 
         std::vector<int> positions;
         for (auto& elem : node) {
-            writer.align(actual_pointee->wire_layout(mod).alignment());
             positions.push_back(actual_pointee->yaml2bin(mod, elem, writer));
         }
 
-        auto pos = writer.tell();
         writer.align(2);
+        auto pos = writer.tell();
         writer.write<int16_t>(node.size());
 
         for (auto pos : positions) {
@@ -156,8 +242,8 @@ int vector_type::yaml2bin(const module& mod,
 
         return pos;
     } else {
-        auto pos = writer.tell();
         writer.align(2);
+        auto pos = writer.tell();
         writer.write<int16_t>(node.size());
 
         for (auto& elem : node) {
@@ -170,7 +256,7 @@ int vector_type::yaml2bin(const module& mod,
 
 YAML::Node vector_type::bin2yaml(const module& mod,
                                  const name& instantiation,
-                                 ibinary_reader& reader) const {
+                                 binary_reader& reader) const {
     auto& arg = std::get<name>(instantiation.args[0]);
     if (auto pointee = get_wire_type(mod, arg); pointee) {
         auto size = reader.read_object<int16_t>();
@@ -194,6 +280,73 @@ YAML::Node vector_type::bin2yaml(const module& mod,
     throw std::runtime_error("pointee must be a regular type");
 }
 
+int vector_type::json2bin(const module& mod,
+                          const name& instantiation,
+                          const json_value& value,
+                          binary_writer& writer) const {
+    auto& arg    = std::get<name>(instantiation.args[0]);
+    auto pointee = get_wire_type(mod, arg);
+    Expects(pointee != nullptr);
+    auto alignment = pointee->wire_layout(mod).alignment();
+
+    if (pointee->is_reference_type(mod)) {
+        auto actual_pointee = get_pointee_type(mod, arg);
+
+        std::vector<int> positions;
+        positions.reserve(value.size());
+        value.for_each_element([&](const json_value& elem) {
+            positions.push_back(actual_pointee->json2bin(mod, elem, writer));
+        });
+
+        writer.align(2);
+        auto pos = writer.tell();
+        writer.write<int16_t>(positions.size());
+
+        for (auto pos : positions) {
+            writer.align(alignment);
+            pointer_type::write(writer, pos);
+        }
+
+        return pos;
+    }
+
+    writer.align(2);
+    auto pos = writer.tell();
+    writer.write<int16_t>(value.size());
+
+    value.for_each_element([&](const json_value& elem) {
+        writer.align(alignment);
+        pointee->json2bin(mod, elem, writer);
+    });
+    return pos;
+}
+
+void vector_type::bin2json(const module& mod,
+                           const name& instantiation,
+                           binary_reader& reader,
+                           json_writer& writer) const {
+    auto& arg    = std::get<name>(instantiation.args[0]);
+    auto pointee = get_wire_type(mod, arg);
+    if (!pointee) {
+        throw std::runtime_error("pointee must be a regular type");
+    }
+
+    auto size = reader.read_object<int16_t>();
+    reader.seek(2);
+
+    auto layout = pointee->wire_layout(mod);
+    reader.align(layout.alignment());
+
+    auto begin = reader.tell();
+
+    writer.begin_array();
+    for (int i = 0; i < size; ++i) {
+        reader.seek(begin + i * layout.size(), std::ios::beg);
+        pointee->bin2json(mod, reader, writer);
+    }
+    writer.end_array();
+}
+
 name vector_type::get_wire_type_name_impl(const module& mod,
                                           const name& your_name) const {
     auto ptr_sym = recursive_name_lookup(mod.symbols(), "ptr").value();
@@ -209,7 +362,7 @@ vector_type::vector_type(module& mod)
 
 int string_type::yaml2bin(const module& module,
                           const YAML::Node& node,
-                          ibinary_writer& writer) const {
+                          binary_writer& writer) const {
     auto str = node.as<std::string>();
     writer.align(2);
     auto pos = writer.tell();
@@ -218,7 +371,7 @@ int string_type::yaml2bin(const module& module,
     return pos;
 }
 
-YAML::Node string_type::bin2yaml(const module&, ibinary_reader& reader) const {
+YAML::Node string_type::bin2yaml(const module&, binary_reader& reader) const {
     /**
      * 2 bytes length + lenght many chars
      */
@@ -230,13 +383,87 @@ YAML::Node string_type::bin2yaml(const module&, ibinary_reader& reader) const {
         std::string(reinterpret_cast<const char*>(raw_str.data()), raw_str.size()));
 }
 
-YAML::Node bool_type::bin2yaml(const module& module, ibinary_reader& reader) const {
+int string_type::json2bin(const module& mod,
+                          const json_value& value,
+                          binary_writer& writer) const {
+    auto str = value.as_string();
+    writer.align(2);
+    auto pos = writer.tell();
+    writer.write<int16_t>(str.size());
+    writer.write_raw_string(str);
+    return pos;
+}
+
+void string_type::bin2json(const module&,
+                           binary_reader& reader,
+                           json_writer& writer) const {
+    auto len = reader.read_object<int16_t>();
+    reader.seek(2);
+    auto raw_str = reader.read_bytes(len);
+    writer.value(
+        std::string_view(reinterpret_cast<const char*>(raw_str.data()), raw_str.size()));
+}
+
+YAML::Node bool_type::bin2yaml(const module& module, binary_reader& reader) const {
     return YAML::Node(reader.read_object<bool>());
 }
 
 int bool_type::yaml2bin(const module& mod,
                         const YAML::Node& node,
-                        ibinary_writer& writer) const {
-    return 0;
+                        binary_writer& writer) const {
+    auto pos = writer.tell();
+    writer.write(node.as<bool>());
+    return pos;
+}
+
+void bool_type::bin2json(const module& mod,
+                         binary_reader& reader,
+                         json_writer& writer) const {
+    writer.value(reader.read_object<bool>());
+}
+
+int bool_type::json2bin(const module& mod,
+                        const json_value& value,
+                        binary_writer& writer) const {
+    auto pos = writer.tell();
+    writer.write(value.as_bool());
+    return pos;
+}
+
+int integral_type::json2bin(const module& mod,
+                            const json_value& value,
+                            binary_writer& writer) const {
+    auto layout = wire_layout(mod);
+    writer.align(layout.alignment());
+    auto pos = writer.tell();
+    if (is_unsigned) {
+        auto data = value.as_uint();
+        writer.write_raw({reinterpret_cast<const char*>(&data), size_t(layout.size())});
+    } else {
+        auto data = value.as_int();
+        writer.write_raw({reinterpret_cast<const char*>(&data), size_t(layout.size())});
+    }
+    return pos;
+}
+
+// Non finite values are written as null, since JSON can't represent them.
+int float_type::json2bin(const module& mod,
+                         const json_value& value,
+                         binary_writer& writer) const {
+    writer.align(4);
+    auto pos = writer.tell();
+    writer.write(value.is_null() ? std::numeric_limits<float>::quiet_NaN()
+                                 : static_cast<float>(value.as_double()));
+    return pos;
+}
+
+int double_type::json2bin(const module& mod,
+                          const json_value& value,
+                          binary_writer& writer) const {
+    writer.align(8);
+    auto pos = writer.tell();
+    writer.write(value.is_null() ? std::numeric_limits<double>::quiet_NaN()
+                                 : value.as_double());
+    return pos;
 }
 } // namespace lidl
@@ -4,59 +4,6 @@
 
 namespace lidl {
 namespace {
-class memory_reader : public ibinary_reader {
-public:
-    explicit memory_reader(gsl::span<uint8_t> data)
-        : m_data{data}
-        , m_loc(m_data.size()) {
-    }
-
-    using ibinary_reader::seek;
-    void seek(int bytes, std::ios::seekdir dir) override {
-        if (dir == std::ios::cur) {
-            m_loc += bytes;
-        } else if (dir == std::ios::beg) {
-            m_loc = bytes;
-        } else {
-            m_loc = m_data.size() - bytes;
-        }
-    }
-
-    int tell() override {
-        return m_loc;
-    }
-
-    gsl::span<uint8_t> read(gsl::span<uint8_t> span) override {
-        memcpy(span.data(), m_data.data() + m_loc, span.size());
-        return span;
-    }
-
-    gsl::span<const uint8_t> m_data;
-    int m_loc;
-};
-
-class memory_writer : public ibinary_writer {
-public:
-    explicit memory_writer(gsl::span<uint8_t> data)
-        : m_data{data} {
-    }
-
-    int tell() override {
-        return m_loc;
-    }
-    void write_raw(gsl::span<const char> data) override {
-        memcpy(m_data.data() + m_loc, data.data(), data.size());
-        m_loc += data.size();
-    }
-
-    gsl::span<uint8_t> get_data() {
-        return m_data.subspan(0, m_loc);
-    }
-
-    gsl::span<uint8_t> m_data;
-    int m_loc = 0;
-};
-
 TEST_CASE("bin2yaml") {
     auto root_module = std::make_unique<lidl::module>();
 
@@ -82,15 +29,13 @@ TEST_CASE("bin2yaml") {
     auto& un = module.unions.back();
     un->add_member("foo", member{name{ptr_handle, {name{str_handle}}}, un.get()});
 
-    uint8_t buff[64];
-
     SUBCASE("bools") {
         auto b = get_wire_type(module, name{bool_handle});
 
-        memory_writer writer(buff);
+        binary_writer writer;
         writer.write(true);
 
-        memory_reader reader(writer.get_data());
+        binary_reader reader(writer.get());
         reader.seek(0, std::ios::beg);
         auto res = b->bin2yaml(module, reader);
 
@@ -104,7 +49,7 @@ TEST_CASE("bin2yaml") {
         uint8_t buf[4];
         memcpy(buf, &i, 4);
 
-        memory_reader reader(buf);
+        binary_reader reader(buf);
         reader.seek(-i32->wire_layout(module).size());
         auto res = i32->bin2yaml(module, reader);
 
@@ -126,12 +71,12 @@ TEST_CASE("bin2yaml") {
          */
         auto str = get_wire_type(module, name{str_handle});
 
-        memory_writer writer(buff);
+        binary_writer writer;
 
         writer.write<int16_t>(11);
         writer.write_raw_string("hello world");
 
-        memory_reader reader(writer.get_data());
+        binary_reader reader(writer.get());
         reader.seek(0, std::ios::beg);
         auto res = str->bin2yaml(module, reader);
 
@@ -149,7 +94,7 @@ TEST_CASE("bin2yaml") {
         int16_t ptrdiff = 4;
         memcpy(buf + 4, &ptrdiff, sizeof ptrdiff);
 
-        memory_reader reader(buf);
+        binary_reader reader(buf);
         reader.seek(-ptr_to_int.wire_layout(module).size());
         auto res = ptr_to_int.bin2yaml(module, reader);
 
@@ -159,14 +104,14 @@ TEST_CASE("bin2yaml") {
     SUBCASE("Pointer to strings") {
         basic_generic_instantiation ptr_to_str(name{ptr_handle, {name{str_handle}}});
 
-        memory_writer writer(buff);
+        binary_writer writer;
 
         writer.write<int16_t>(11);
         writer.write_raw_string("hello world");
         writer.align(2);
         writer.write<int16_t>(writer.tell());
 
-        memory_reader reader(writer.get_data());
+        binary_reader reader(writer.get());
         reader.seek(-2);
         auto res = ptr_to_str.bin2yaml(module, reader);
 
@@ -177,14 +122,14 @@ TEST_CASE("bin2yaml") {
     SUBCASE("vector of ints") {
         basic_generic_instantiation vec_of_int(name{vec_handle, {name{i32_handle}}});
 
-        memory_writer writer(buff);
+        binary_writer writer;
 
         writer.write<int16_t>(2);
         writer.align(4);
         writer.write<int32_t>(42);
         writer.write<int32_t>(33);
 
-        memory_reader reader(writer.get_data());
+        binary_reader reader(writer.get());
         reader.seek(0, std::ios::beg);
 
         auto res = vec_of_int.bin2yaml(module, reader);
@@ -196,7 +141,7 @@ TEST_CASE("bin2yaml") {
         basic_generic_instantiation ptr_to_vec_of_int(
             name{ptr_handle, {name{vec_handle, {name{i32_handle}}}}});
 
-        memory_writer writer(buff);
+        binary_writer writer;
 
         writer.write<int16_t>(2); // size
         writer.align(4);
@@ -205,7 +150,7 @@ TEST_CASE("bin2yaml") {
         writer.align(2);
         writer.write<int16_t>(writer.tell()); // pointer offset
 
-        memory_reader reader(writer.get_data());
+        binary_reader reader(writer.get());
         reader.seek(-2);
         auto res = ptr_to_vec_of_int.bin2yaml(module, reader);
 
@@ -215,7 +160,7 @@ TEST_CASE("bin2yaml") {
     SUBCASE("enums") {
         basic_generic_instantiation vec_of_enums(name{vec_handle, {name{enum_handle}}});
 
-        memory_writer writer(buff);
+        binary_writer writer;
 
         writer.write<int16_t>(3);
         writer.align(1);
@@ -223,7 +168,7 @@ TEST_CASE("bin2yaml") {
         writer.write<int8_t>(1); // bar
         writer.write<int8_t>(2); // baz
 
-        memory_reader reader(writer.get_data());
+        binary_reader reader(writer.get());
         reader.seek(0, std::ios::beg);
         auto res = vec_of_enums.bin2yaml(module, reader);
 
@@ -232,7 +177,7 @@ TEST_CASE("bin2yaml") {
     }
 
     SUBCASE("unions") {
-        memory_writer writer(buff);
+        binary_writer writer;
 
         writer.write<int16_t>(11);
         writer.write_raw_string("hello world");
@@ -241,7 +186,7 @@ TEST_CASE("bin2yaml") {
         writer.align(2);
         writer.write<int16_t>(writer.tell()); // pointer to string
 
-        memory_reader reader(writer.get_data());
+        binary_reader reader(writer.get());
         reader.seek(-un.wire_layout(module).size());
         auto res = un.bin2yaml(module, reader);
 
@@ -0,0 +1,135 @@
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <iostream>
+#include <lidl/json.hpp>
+#include <lidl/module.hpp>
+#include <yaml-cpp/yaml.h>
+
+namespace {
+using namespace lidl;
+
+structure& add_struct(module& mod, std::string_view name) {
+    mod.structs.emplace_back(std::make_unique<structure>(&mod));
+    define(mod.symbols(), name, mod.structs.back().get());
+    return *mod.structs.back();
+}
+
+YAML::Node generate_capture(int num_items) {
+    YAML::Node items;
+    for (int i = 0; i < num_items; ++i) {
+        YAML::Node item;
+        item["id"]    = i;
+        item["score"] = i * 0.5;
+        item["name"]  = fmt::format("item_{}_abcdefgh", i);
+        for (int j = 0; j < 16; ++j) {
+            item["values"].push_back((i * 31 + j * 7) % 60000);
+        }
+        items.push_back(item);
+    }
+
+    YAML::Node res;
+    res["items"] = items;
+    return res;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    // Pointers are 16 bit offsets, so a single message has to stay well below 32KB.
+    int num_items = argc > 1 ? std::atoi(argv[1]) : 200;
+    int rounds    = argc > 2 ? std::atoi(argv[2]) : 500;
+
+    auto root_module = std::make_unique<module>();
+    root_module->add_child("", basic_module());
+    auto& mod = root_module->get_child("bench");
+
+    auto lookup = [&](std::string_view name) {
+        return recursive_full_name_lookup(mod.symbols(), name).value();
+    };
+
+    auto& item = add_struct(mod, "item");
+    item.add_member("id", member{name{lookup("u32")}, &item});
+    item.add_member("score", member{name{lookup("f64")}, &item});
+    item.add_member("name", member{name{lookup("string")}, &item});
+    item.add_member("values",
+                    member{name{lookup("vector"), {name{lookup("u16")}}}, &item});
+
+    auto& capture = add_struct(mod, "capture");
+    capture.add_member(
+        "items", member{name{lookup("vector"), {name{lookup("item")}}}, &capture});
+
+    auto input = generate_capture(num_items);
+
+    size_t total_bytes = 0;
+    binary_writer writer;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        writer = binary_writer{};
+        capture.yaml2bin(mod, input, writer);
+        total_bytes += writer.get().size();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto secs = std::chrono::duration<double>(end - begin).count();
+    std::cout << fmt::format("yaml2bin: {} bytes in {:.3f}s: {:.1f} MB/sec\n",
+                             total_bytes,
+                             secs,
+                             total_bytes / secs / 1e6);
+
+    auto message = writer.get();
+
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        binary_reader reader(message);
+        reader.seek(-capture.wire_layout(mod).size());
+        auto res = capture.bin2yaml(mod, reader);
+        if (res["items"].size() != size_t(num_items)) {
+            std::cerr << "Round trip failed!\n";
+            return 1;
+        }
+    }
+    end = std::chrono::steady_clock::now();
+
+    secs = std::chrono::duration<double>(end - begin).count();
+    std::cout << fmt::format("bin2yaml: {} bytes in {:.3f}s: {:.1f} MB/sec\n",
+                             message.size() * rounds,
+                             secs,
+                             message.size() * rounds / secs / 1e6);
+
+    std::string json;
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        json.clear();
+        json_writer json_out(json);
+        binary_reader reader(message);
+        reader.seek(-capture.wire_layout(mod).size());
+        capture.bin2json(mod, reader, json_out);
+    }
+    end = std::chrono::steady_clock::now();
+
+    secs = std::chrono::duration<double>(end - begin).count();
+    std::cout << fmt::format("bin2json: {} bytes in {:.3f}s: {:.1f} MB/sec\n",
+                             message.size() * rounds,
+                             secs,
+                             message.size() * rounds / secs / 1e6);
+
+    auto doc = json_document::parse(json);
+
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        binary_writer out;
+        capture.json2bin(mod, doc.root(), out);
+        if (out.get().size() != message.size()) {
+            std::cerr << "Round trip failed!\n";
+            return 1;
+        }
+    }
+    end = std::chrono::steady_clock::now();
+
+    secs = std::chrono::duration<double>(end - begin).count();
+    std::cout << fmt::format("json2bin: {} bytes in {:.3f}s: {:.1f} MB/sec\n",
+                             message.size() * rounds,
+                             secs,
+                             message.size() * rounds / secs / 1e6);
+}
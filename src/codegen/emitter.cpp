@@ -6,12 +6,14 @@
 #include <fmt/format.h>
 #include <iostream>
 #include <lidl/module.hpp>
+#include <lidl/time_report.hpp>
 #include <string>
 #include <unordered_map>
 
 
 namespace lidl::codegen {
 bool emitter::pass() {
+    time_report::count("emitter passes");
     bool changed = false;
 
     std::unordered_map<std::string, std::vector<section>> m_this_pass;
@@ -56,6 +58,7 @@ bool emitter::pass() {
 }
 
 std::string emitter::emit() {
+    time_report::phase emit_phase("emit");
     while (pass())
         ;
     if (!m_not_generated.empty()) {
@@ -112,6 +115,7 @@ void emitter::mark_module(const module& decl_mod) {
 emitter::emitter(const module& root_mod, const module& mod, sections all)
     : m_module{&mod}
     , m_not_generated(std::move(all.get_sections())) {
+    time_report::count("sections", m_not_generated.size());
     mark_module(root_mod);
 }
 
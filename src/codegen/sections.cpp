@@ -117,6 +117,9 @@ std::string section_key_t::to_string(const module& mod) const {
     case section_type::validator:
         typestr = "validator";
         break;
+    case section_type::json:
+        typestr = "json";
+        break;
     }
 
     assert(!typestr.empty());
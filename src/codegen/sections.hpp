@@ -24,7 +24,8 @@ enum class section_type
     std_traits,
 
     eq_operator,
-    validator
+    validator,
+    json
 };
 
 using section_entity_t = const base*;
@@ -0,0 +1,126 @@
+#include "constant_gen.hpp"
+
+#include "cppgen.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <lidl/basic_types.hpp>
+#include <lidl/eval/constants.hpp>
+
+namespace lidl::cpp {
+using codegen::sections;
+
+namespace {
+std::string floating_literal(double val, bool is_float) {
+    auto type = is_float ? "float" : "double";
+    if (std::isnan(val)) {
+        return fmt::format("std::numeric_limits<{}>::quiet_NaN()", type);
+    }
+    if (std::isinf(val)) {
+        return fmt::format(
+            "{}std::numeric_limits<{}>::infinity()", val < 0 ? "-" : "", type);
+    }
+
+    auto res = fmt::format("{}", val);
+    if (res.find_first_of(".e") == std::string::npos) {
+        res += ".0";
+    }
+    return is_float ? res + "f" : res;
+}
+
+std::string string_literal(std::string_view str) {
+    std::string res = "\"";
+    for (auto c : str) {
+        if (c == '"' || c == '\\') {
+            res += '\\';
+        }
+        res += c;
+    }
+    return res + "\"";
+}
+
+std::string constant_type(const module& mod, const name& type) {
+    if (dynamic_cast<const string_type*>(get_type(mod, type))) {
+        return "std::string_view";
+    }
+    return get_identifier(mod, type);
+}
+
+eval::value evaluated(const eval::evaluate_result& res) {
+    // Constants are checked before code generation, so evaluation can't fail here.
+    return std::get<eval::value>(res);
+}
+} // namespace
+
+std::string generate_literal(const module& mod, const name& type, const eval::value& val) {
+    if (val.is_bool()) {
+        return val.as_bool() ? "true" : "false";
+    }
+
+    if (val.is_integral()) {
+        if (val.as_integral() == INT64_MIN) {
+            return "(-9223372036854775807 - 1)";
+        }
+        return std::to_string(val.as_integral());
+    }
+
+    if (val.is_double()) {
+        return floating_literal(val.as_double(),
+                                dynamic_cast<const float_type*>(get_type(mod, type)));
+    }
+
+    if (val.is_string()) {
+        return string_literal(val.as_string());
+    }
+
+    if (val.is_enum()) {
+        return get_identifier(mod, val.as_enum().enum_value);
+    }
+
+    throw std::runtime_error("Unsupported constant value");
+}
+
+std::optional<std::string> generate_default_argument(const module& mod,
+                                                     const member& mem) {
+    if (!mem.default_value || get_type(mod, mem.type_)->is_reference_type(mod)) {
+        return {};
+    }
+    return generate_literal(mod, mem.type_, evaluated(eval::evaluate_default(mod, mem)));
+}
+
+std::vector<std::optional<std::string>> generate_default_arguments(const module& mod,
+                                                                   const structure& str) {
+    std::vector<std::optional<std::string>> res;
+    for (auto& [name, mem] : str.all_members()) {
+        res.push_back(mem.is_nullable() ? std::nullopt
+                                        : generate_default_argument(mod, mem));
+    }
+
+    auto last_required = std::find(res.rbegin(), res.rend(), std::nullopt);
+    std::fill(last_required, res.rend(), std::nullopt);
+    return res;
+}
+
+sections constant_gen::generate() {
+    auto val = evaluated(eval::evaluate_constant(mod(), get()));
+
+    section s;
+    s.add_key(def_key());
+    s.definition = fmt::format("inline constexpr {} {} = {};",
+                               constant_type(mod(), get().type),
+                               name(),
+                               generate_literal(mod(), get().type, val));
+
+    for (auto& key : codegen::def_keys_from_name(mod(), get().type)) {
+        s.add_dependency(key);
+    }
+
+    // Enum values need their enumeration to be defined.
+    if (val.is_enum()) {
+        auto member = get_symbol(val.as_enum().enum_value.base);
+        s.add_dependency({member->parent(), section_type::definition});
+    }
+
+    return sections{{std::move(s)}};
+}
+} // namespace lidl::cpp
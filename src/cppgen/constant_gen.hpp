@@ -0,0 +1,43 @@
+#pragma once
+
+#include "generator_base.hpp"
+
+#include <lidl/constant.hpp>
+#include <lidl/eval/value.hpp>
+#include <lidl/member.hpp>
+#include <lidl/structure.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lidl::cpp {
+/**
+ * Generates constants as `inline constexpr` variables. Strings become
+ * `std::string_view`s.
+ */
+struct constant_gen : codegen::generator_base<constant> {
+    using generator_base::generator_base;
+
+    codegen::sections generate() override;
+};
+
+/**
+ * Returns a C++ expression for the given value of the given type. The value must
+ * already be converted to the type by the evaluator.
+ */
+std::string generate_literal(const module& mod, const name& type, const eval::value& val);
+
+/**
+ * Returns the C++ expression for the default value of the given member, if it has one
+ * that can be passed to a constructor, i.e. if it's not behind a pointer.
+ */
+std::optional<std::string> generate_default_argument(const module& mod, const member& mem);
+
+/**
+ * Returns the default arguments of the constructor parameters for the members of the
+ * given structure, in declaration order. Since C++ only allows default arguments at the
+ * end of a parameter list, only the trailing members with defaults get one.
+ */
+std::vector<std::optional<std::string>> generate_default_arguments(const module& mod,
+                                                                   const structure& str);
+} // namespace lidl::cpp
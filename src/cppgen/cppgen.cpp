@@ -1,5 +1,6 @@
 #include "cppgen.hpp"
 
+#include "constant_gen.hpp"
 #include "emitter.hpp"
 #include "enum_gen.hpp"
 #include "generator_base.hpp"
@@ -20,6 +21,7 @@
 #include <fstream>
 #include <lidl/basic.hpp>
 #include <lidl/module.hpp>
+#include <lidl/time_report.hpp>
 #include <lidl/view_types.hpp>
 #include <optional>
 #include <sstream>
@@ -55,6 +57,35 @@ struct cppgen {
             }
         }
 
+        generate_sections();
+
+        auto& root_mod = root_module(mod());
+        codegen::emitter e(root_mod, mod(), m_sections);
+
+        str << "#pragma once\n\n#include <lidlrt/lidl.hpp>\n";
+        if (has_json()) {
+            str << "#include <lidlrt/json.hpp>\n";
+        }
+        if (!mod().services.empty()) {
+            str << "#include <lidlrt/service.hpp>\n";
+            str << "#include <tos/task.hpp>\n";
+        }
+        for (auto& imported : mod().imported_modules) {
+            if (imported->src_info && imported->src_info->origin) {
+                auto path = *imported->src_info->origin;
+                auto file_name = std::filesystem::path(path).stem().string();
+                str << fmt::format("#include <{}_generated.hpp>\n", file_name);
+
+            }
+        }
+        str << '\n';
+
+        str << e.emit() << '\n';
+    }
+
+private:
+    void generate_sections() {
+        time_report::phase sections_phase("sections");
         for (auto& e : m_module->enums) {
             m_sections.merge_before(codegen::do_generate<enum_gen>(mod(), e.get()));
         }
@@ -71,6 +102,10 @@ struct cppgen {
             m_sections.merge_before(do_generate<struct_gen>(mod(), s.get()));
         }
 
+        for (auto& c : mod().constants) {
+            m_sections.merge_before(do_generate<constant_gen>(mod(), c.get()));
+        }
+
         for (auto& service : mod().services) {
             m_sections.merge_before(
                 do_generate<better_service_generator>(mod(), service.get()));
@@ -80,29 +115,19 @@ struct cppgen {
             m_sections.merge_before(
                 do_generate<generic_gen>(mod(), ins->get_generic(), *ins));
         }
+    }
 
-        auto& root_mod = root_module(mod());
-        codegen::emitter e(root_mod, mod(), m_sections);
-
-        str << "#pragma once\n\n#include <lidlrt/lidl.hpp>\n";
-        if (!mod().services.empty()) {
-            str << "#include <lidlrt/service.hpp>\n";
-            str << "#include <tos/task.hpp>\n";
-        }
-        for (auto& imported : mod().imported_modules) {
-            if (imported->src_info && imported->src_info->origin) {
-                auto path = *imported->src_info->origin;
-                auto file_name = std::filesystem::path(path).stem().string();
-                str << fmt::format("#include <{}_generated.hpp>\n", file_name);
-
-            }
-        }
-        str << '\n';
-
-        str << e.emit() << '\n';
+    bool has_json() {
+        return std::any_of(
+            m_sections.get_sections().begin(),
+            m_sections.get_sections().end(),
+            [](const section& sect) {
+                return std::any_of(sect.keys().begin(), sect.keys().end(), [](auto& key) {
+                    return key.type == section_type::json;
+                });
+            });
     }
 
-private:
     codegen::sections m_sections;
 
     const module& mod() {
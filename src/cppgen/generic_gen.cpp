@@ -22,9 +22,8 @@ std::string generic_gen::full_name() {
 
 sections generic_gen::do_generate(const generic_structure& str) {
     auto par_mod = find_parent_module(&str);
-    par_mod->throwaway.emplace_back(str.instantiate(*par_mod, get().args));
-
-    auto& un = static_cast<structure&>(*par_mod->throwaway.back());
+    auto& un = const_cast<structure&>(
+        static_cast<const structure&>(str.get_instance(*par_mod, get().args)));
     define(par_mod->symbols(), local_full_name(), &un);
 
     struct_gen gen(*par_mod, local_full_name(), name(), full_name(), un);
@@ -34,9 +33,8 @@ sections generic_gen::do_generate(const generic_structure& str) {
 
 sections generic_gen::do_generate(const generic_union& u) {
     auto par_mod = find_parent_module(&u);
-    par_mod->throwaway.emplace_back(u.instantiate(*par_mod, get().args));
-
-    auto& un = static_cast<union_type&>(*par_mod->throwaway.back());
+    auto& un = const_cast<union_type&>(
+        static_cast<const union_type&>(u.get_instance(*par_mod, get().args)));
     define(par_mod->symbols(), local_full_name(), &un);
 
     union_gen gen(*par_mod, local_full_name(), name(), full_name(), un);
@@ -63,6 +61,16 @@ std::string declare_template(const module& mod,
         "template <{}>\nclass {};\n", fmt::join(params, ", "), generic_name);
 }
 
+// Other types refer to the instance through the instantiation rather than the instance
+// itself, so the JSON functions are keyed by it as well.
+void add_json_key(section& sec, const base* sym) {
+    if (std::any_of(sec.keys().begin(), sec.keys().end(), [](auto& key) {
+            return key.type == section_type::json;
+        })) {
+        sec.add_key({sym, section_type::json});
+    }
+}
+
 } // namespace
 
 sections generic_gen::generate() {
@@ -88,6 +96,7 @@ sections generic_gen::generate() {
                 sec.add_dependency(generic_decl_key);
                 sec.add_key({sym, section_type::definition});
             }
+            add_json_key(sec, sym);
         }
         common.merge_before(res);
     } else if (auto genun = dynamic_cast<const generic_union*>(get().get_generic())) {
@@ -100,6 +109,7 @@ sections generic_gen::generate() {
                 sec.add_dependency(generic_decl_key);
                 sec.add_key({sym, section_type::definition});
             }
+            add_json_key(sec, sym);
         }
         common.merge_before(res);
     } else {
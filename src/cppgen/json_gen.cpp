@@ -0,0 +1,282 @@
+#include "json_gen.hpp"
+
+#include "cppgen.hpp"
+
+#include <algorithm>
+#include <lidl/basic_types.hpp>
+#include <lidl/enumeration.hpp>
+#include <lidl/generics.hpp>
+
+namespace lidl::cpp {
+using codegen::sections;
+namespace {
+bool is_json_convertible(const module& mod,
+                         const name& nm,
+                         std::vector<const base*>& visiting);
+
+bool members_convertible(const module& mod,
+                         const base* type,
+                         const std::vector<const member*>& members,
+                         std::vector<const base*>& visiting) {
+    // Recursive types can only be converted through nullable members, which aren't
+    // supported anyway.
+    if (std::find(visiting.begin(), visiting.end(), type) != visiting.end()) {
+        return false;
+    }
+
+    visiting.push_back(type);
+    auto res = std::all_of(members.begin(), members.end(), [&](const member* mem) {
+        return !mem->is_nullable() && is_json_convertible(mod, mem->type_, visiting);
+    });
+    visiting.pop_back();
+    return res;
+}
+
+bool convertible(const module& mod,
+                 const structure& str,
+                 std::vector<const base*>& visiting) {
+    std::vector<const member*> members;
+    for (auto& [name, mem] : str.all_members()) {
+        members.push_back(&mem);
+    }
+    return members_convertible(mod, &str, members, visiting);
+}
+
+bool convertible(const module& mod,
+                 const union_type& u,
+                 std::vector<const base*>& visiting) {
+    if (u.raw) {
+        return false;
+    }
+
+    std::vector<const member*> members;
+    for (auto& [name, mem] : u.all_members()) {
+        members.push_back(mem);
+    }
+    return members_convertible(mod, &u, members, visiting);
+}
+
+bool is_json_convertible(const module& mod,
+                         const name& nm,
+                         std::vector<const base*>& visiting) {
+    auto sym = get_symbol(nm.base);
+
+    if (dynamic_cast<const vector_type*>(sym)) {
+        return is_json_convertible(mod, nm.args.front().as_name(), visiting);
+    }
+
+    if (auto str = dynamic_cast<const generic_structure*>(sym)) {
+        auto& ins = str->get_instance(*find_parent_module(str), nm);
+        return convertible(mod, static_cast<const structure&>(ins), visiting);
+    }
+
+    if (auto u = dynamic_cast<const generic_union*>(sym)) {
+        auto& ins = u->get_instance(*find_parent_module(u), nm);
+        return convertible(mod, static_cast<const union_type&>(ins), visiting);
+    }
+
+    if (dynamic_cast<const bool_type*>(sym) || dynamic_cast<const integral_type*>(sym) ||
+        dynamic_cast<const float_type*>(sym) || dynamic_cast<const double_type*>(sym) ||
+        dynamic_cast<const string_type*>(sym) || dynamic_cast<const enumeration*>(sym)) {
+        return true;
+    }
+
+    if (auto str = dynamic_cast<const structure*>(sym)) {
+        return convertible(mod, *str, visiting);
+    }
+
+    if (auto u = dynamic_cast<const union_type*>(sym)) {
+        return convertible(mod, *u, visiting);
+    }
+
+    return false;
+}
+
+// The functions for user defined types must be declared before the functions that call
+// them, and enumerations are converted through their traits.
+void add_json_dependencies(const module& mod, const name& nm, section& sect) {
+    sect.add_dependencies(codegen::def_keys_from_name(mod, nm));
+
+    auto sym = get_symbol(nm.base);
+    if (dynamic_cast<const vector_type*>(sym)) {
+        return add_json_dependencies(mod, nm.args.front().as_name(), sect);
+    }
+
+    if (dynamic_cast<const generic_structure*>(sym) ||
+        dynamic_cast<const generic_union*>(sym)) {
+        sect.add_dependency({resolve(mod, nm), section_type::json});
+    } else if (dynamic_cast<const structure*>(sym) ||
+               dynamic_cast<const union_type*>(sym)) {
+        sect.add_dependency({sym, section_type::json});
+    } else if (dynamic_cast<const enumeration*>(sym)) {
+        sect.add_dependency({sym, section_type::lidl_traits});
+    }
+}
+
+/**
+ * While parsing, every member is stored in a slot until all of them are available and
+ * the object can be constructed. Reference members are created in the builder right
+ * away, so their slots are pointers. Value members are kept in an optional.
+ */
+std::string declare_slot(const module& mod, std::string_view member_name, const member& mem) {
+    auto wire_name  = get_wire_type_name(mod, mem.type_);
+    auto identifier = get_identifier(mod, deref_ptr(mod, wire_name));
+    if (is_ptr(mod, wire_name)) {
+        return fmt::format("const {}* p_{} = nullptr;", identifier, member_name);
+    }
+    return fmt::format("std::optional<{}> p_{};", identifier, member_name);
+}
+
+std::string result_type(std::string_view abs_name, bool is_reference) {
+    if (is_reference) {
+        return fmt::format("const {}*&", abs_name);
+    }
+    return fmt::format("std::optional<{}>&", abs_name);
+}
+
+std::string construct(std::string_view abs_name,
+                      bool is_reference,
+                      const std::vector<std::string>& args) {
+    if (is_reference) {
+        return fmt::format("res = ::lidl::try_create<{}>(builder{}{});",
+                           abs_name,
+                           args.empty() ? "" : ", ",
+                           fmt::join(args, ", "));
+    }
+    return fmt::format("res.emplace({});", fmt::join(args, ", "));
+}
+} // namespace
+
+sections struct_json_gen::generate() {
+    std::vector<const base*> visiting;
+    if (!convertible(mod(), get(), visiting)) {
+        return {};
+    }
+
+    section sect;
+    sect.add_key({symbol(), section_type::json});
+    sect.add_dependency(def_key());
+
+    std::vector<std::string> writes;
+    std::vector<std::string> slots;
+    std::vector<std::string> reads;
+    std::vector<std::string> checks{"!in.ok()"};
+    std::vector<std::string> args;
+    for (auto& [memname, member] : get().all_members()) {
+        add_json_dependencies(mod(), member.type_, sect);
+
+        writes.push_back(
+            fmt::format("out.key(\"{0}\");\nto_json(out, val.{0}());", memname));
+        slots.push_back(declare_slot(mod(), memname, member));
+        reads.push_back(fmt::format(R"__(if (key == "{0}") {{
+                if (!from_json(in, builder, p_{0})) {{ return false; }}
+            }} else )__",
+                                    memname));
+        checks.push_back(fmt::format("!p_{}", memname));
+        args.push_back(fmt::format("*p_{}", memname));
+    }
+
+    auto is_reference = get().is_reference_type(mod());
+
+    // Empty structures leave the parameters unnamed to avoid unused parameter warnings.
+    constexpr auto format = R"__(inline void to_json(::lidl::json::output& out, const {0}& {7}) {{
+        using ::lidl::json::to_json;
+        out.begin_object();
+        {1}
+        out.end_object();
+    }}
+[[nodiscard]] inline bool from_json(::lidl::json::input& in, ::lidl::message_builder& {8}, {2} res) {{
+        using ::lidl::json::from_json;
+        {3}
+        if (!in.begin_object()) {{ return false; }}
+        std::string_view key;
+        while (in.next_key(key)) {{
+            {4}{{
+                in.skip();
+            }}
+        }}
+        if ({5}) {{ return false; }}
+        {6}
+        return bool(res);
+    }})__";
+
+    sect.definition = fmt::format(format,
+                                  absolute_name(),
+                                  fmt::join(writes, "\n"),
+                                  result_type(absolute_name(), is_reference),
+                                  fmt::join(slots, "\n"),
+                                  fmt::join(reads, ""),
+                                  fmt::join(checks, " || "),
+                                  construct(absolute_name(), is_reference, args),
+                                  args.empty() ? "" : "val",
+                                  args.empty() ? "" : "builder");
+
+    return sections{{std::move(sect)}};
+}
+
+sections union_json_gen::generate() {
+    std::vector<const base*> visiting;
+    if (!convertible(mod(), get(), visiting)) {
+        return {};
+    }
+
+    section sect;
+    sect.add_key({symbol(), section_type::json});
+    sect.add_dependency(def_key());
+
+    auto is_reference = get().is_reference_type(mod());
+
+    std::vector<std::string> cases;
+    std::vector<std::string> reads;
+    for (auto& [memname, member] : get().all_members()) {
+        add_json_dependencies(mod(), member->type_, sect);
+
+        cases.push_back(fmt::format(R"__(case {0}::alternatives::{1}:
+            out.key("{1}");
+            to_json(out, val.{1}());
+            break;)__",
+                                    absolute_name(),
+                                    memname));
+
+        reads.push_back(fmt::format(R"__(if (key == "{0}") {{
+            {1}
+            if (!from_json(in, builder, p_{0})) {{ return false; }}
+            {2}
+        }} else )__",
+                                    memname,
+                                    declare_slot(mod(), memname, *member),
+                                    construct(absolute_name(),
+                                              is_reference,
+                                              {fmt::format("*p_{}", memname)})));
+    }
+
+    constexpr auto format = R"__(inline void to_json(::lidl::json::output& out, const {0}& val) {{
+        using ::lidl::json::to_json;
+        out.begin_object();
+        switch (val.alternative()) {{
+            {1}
+        }}
+        out.end_object();
+    }}
+[[nodiscard]] inline bool from_json(::lidl::json::input& in, ::lidl::message_builder& builder, {2} res) {{
+        using ::lidl::json::from_json;
+        std::string_view key;
+        if (!in.begin_object() || !in.next_key(key)) {{ return false; }}
+        {3}{{
+            in.fail();
+            return false;
+        }}
+        // Only a single alternative may be present.
+        if (in.next_key(key)) {{ in.fail(); }}
+        return in.ok() && res;
+    }})__";
+
+    sect.definition = fmt::format(format,
+                                  absolute_name(),
+                                  fmt::join(cases, "\n"),
+                                  result_type(absolute_name(), is_reference),
+                                  fmt::join(reads, ""));
+
+    return sections{{std::move(sect)}};
+}
+} // namespace lidl::cpp
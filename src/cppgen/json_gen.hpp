@@ -0,0 +1,33 @@
+#pragma once
+
+#include "generator_base.hpp"
+#include <lidl/structure.hpp>
+#include <lidl/union.hpp>
+
+namespace lidl::cpp {
+/**
+ * Generates to_json and from_json functions for a structure.
+ *
+ * The functions are straight-line code for every member, serialization writes into a
+ * reusable lidl::json::output and parsing pulls values from a lidl::json::input into a
+ * message builder. No reflection is involved at runtime.
+ *
+ * Structures with members that have no JSON representation, such as nullable members
+ * or arrays, don't get the functions.
+ */
+struct struct_json_gen : codegen::generator_base<structure> {
+    using generator_base::generator_base;
+
+    codegen::sections generate() override;
+};
+
+/**
+ * Generates to_json and from_json functions for a union. A union is represented as an
+ * object with a single member, named after the active alternative.
+ */
+struct union_json_gen : codegen::generator_base<union_type> {
+    using generator_base::generator_base;
+
+    codegen::sections generate() override;
+};
+} // namespace lidl::cpp
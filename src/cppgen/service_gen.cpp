@@ -637,7 +637,9 @@ std::string better_service_generator::make_procedure_stub(std::string_view proc_
         lidl::message_builder mb{{as_span(req_buf)}};
         ServBase::transform_call(mb,
             [&]() -> auto& {{
-                return lidl::create<{4}::wire_types::call_union>(mb, {2}({3}));
+                auto& call = lidl::create<{4}::wire_types::call_union>(mb, {2}({3}));
+                lidl::attach_envelope(mb);
+                return call;
             }}
         );
         auto buf = mb.get_buffer();
@@ -649,11 +651,14 @@ std::string better_service_generator::make_procedure_stub(std::string_view proc_
 
     constexpr auto async_def_format = R"__({0} override {{
         using lidl::as_span;
+        auto token_ = co_await lidl::outgoing_token();
         auto req_buf = ServBase::get_buffer();
         lidl::message_builder mb{{as_span(req_buf)}};
         ServBase::transform_call(mb,
             [&]() -> auto& {{
-                return lidl::create<{4}::wire_types::call_union>(mb, {2}({3}));
+                auto& call = lidl::create<{4}::wire_types::call_union>(mb, {2}({3}));
+                lidl::attach_envelope(mb, token_);
+                return call;
             }}
         );
         auto buf = mb.get_buffer();
@@ -1,28 +1,40 @@
 #include "struct_bodygen.hpp"
 
+#include "constant_gen.hpp"
+
 namespace lidl::cpp {
 using codegen::sections;
 sections raw_struct_gen::generate() {
 #ifdef LIDL_VERBOSE_LOG
     std::cerr << fmt::format("Generating raw struct {}\n", absolute_name());
 #endif
+    // Fields are emitted in layout order so that the C++ compiler places them at the
+    // same offsets lidl computed, which differs from declaration order when members are
+    // reordered.
     std::vector<std::string> members;
-    for (auto& [name, member] : get().all_members()) {
-        auto member_type_name = get_wire_type_name(mod(), member.type_);
-        members.push_back(generate_field(name, get_identifier(mod(), member_type_name)));
+    for (auto& [name, member] : get().layout_order_members(mod())) {
+        auto member_type_name = get_wire_type_name(mod(), member->type_);
+        auto field = generate_field(name, get_identifier(mod(), member_type_name));
+        if (member->alignment) {
+            field = fmt::format("alignas({}) {}", *member->alignment, field);
+        }
+        members.push_back(std::move(field));
     }
 
     auto ctor = generate_raw_constructor();
 
-    constexpr auto format = R"__(struct {} {{
+    constexpr auto format = R"__(struct {}{} {{
             {}
             {}
         }};)__";
 
+    auto alignment =
+        get().alignment() ? fmt::format("alignas({}) ", *get().alignment()) : "";
+
     section def_sect;
     def_sect.add_key(def_key());
-    def_sect.definition =
-        fmt::format(format, name(), fmt::join(ctor, "\n"), fmt::join(members, "\n"));
+    def_sect.definition = fmt::format(
+        format, alignment, name(), fmt::join(ctor, "\n"), fmt::join(members, "\n"));
 
     // Member types must be defined before us
     for (auto& [name, member] : get().all_members()) {
@@ -52,17 +64,29 @@ std::vector<std::string> raw_struct_gen::generate_raw_constructor() {
     std::vector<std::string> arg_names;
     std::vector<std::string> initializer_list;
 
+    // Constructor parameters follow the declaration order, initializers follow the order
+    // the fields are declared in the raw struct.
+    auto defaults = generate_default_arguments(mod(), get());
+    auto def_it   = defaults.begin();
     for (auto& [member_name, member] : get().all_members()) {
         auto member_type_name = get_wire_type_name(mod(), member.type_);
 
         auto identifier = get_user_identifier(mod(), member_type_name);
+        auto& def       = *def_it++;
 
         if (!member.is_nullable()) {
-            arg_names.push_back(fmt::format("const {}& p_{}", identifier, member_name));
-            initializer_list.push_back(fmt::format("{0}(p_{0})", member_name));
+            arg_names.push_back(fmt::format("const {}& p_{}", identifier, member_name) +
+                                (def ? " = " + *def : ""));
             continue;
         }
         arg_names.push_back(fmt::format("const {}* p_{}", identifier, member_name));
+    }
+
+    for (auto& [member_name, member] : get().layout_order_members(mod())) {
+        if (!member->is_nullable()) {
+            initializer_list.push_back(fmt::format("{0}(p_{0})", member_name));
+            continue;
+        }
         initializer_list.push_back(
             fmt::format("{0}(p_{0} ? decltype({0}){{*p_{0}}} : decltype({0}){{nullptr}})",
                         member_name));
@@ -113,15 +137,19 @@ std::vector<std::string> struct_body_gen::generate_constructor() {
     std::vector<std::string> arg_names;
     std::vector<std::string> initializer_list;
 
+    auto defaults = generate_default_arguments(mod(), str());
+    auto def_it   = defaults.begin();
     for (auto& [member_name, member] : str().all_members()) {
         auto member_type_name = get_wire_type_name(mod(), member.type_);
 
         auto identifier = get_user_identifier(mod(), member_type_name);
+        auto& def       = *def_it++;
 
         initializer_list.push_back(fmt::format("p_{}", member_name));
 
         if (!member.is_nullable()) {
-            arg_names.push_back(fmt::format("const {}& p_{}", identifier, member_name));
+            arg_names.push_back(fmt::format("const {}& p_{}", identifier, member_name) +
+                                (def ? " = " + *def : ""));
             continue;
         }
         arg_names.push_back(fmt::format("const {}* p_{}", identifier, member_name));
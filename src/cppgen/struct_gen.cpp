@@ -5,14 +5,66 @@
 #include "struct_gen.hpp"
 
 #include "cppgen.hpp"
+#include "json_gen.hpp"
 #include "struct_bodygen.hpp"
 
+#include <lidl/enumeration.hpp>
+#include <lidl/eval/constants.hpp>
 #include <lidl/service.hpp>
 
 namespace lidl::cpp {
 using codegen::sections;
+
+namespace {
+/**
+ * Builds the YAML representation of a message that consists of the default values of
+ * the given structure, if every member has one. Members of structure types are filled
+ * in with their own defaults. The largest alignment in the message is collected in
+ * alignment, since the message must be copied to a position aligned to it.
+ */
+std::optional<YAML::Node>
+default_message(const module& mod, const structure& str, int& alignment) {
+    YAML::Node res;
+    alignment = std::max<int>(alignment, str.wire_layout(mod).alignment());
+
+    for (auto& [name, mem] : str.all_members()) {
+        if (!mem.default_value) {
+            auto member_str = dynamic_cast<const structure*>(
+                get_type(mod, deref_ptr(mod, get_wire_type_name(mod, mem.type_))));
+            if (!member_str || member_str->all_members().empty()) {
+                return {};
+            }
+            auto sub = default_message(mod, *member_str, alignment);
+            if (!sub) {
+                return {};
+            }
+            res[name] = *sub;
+            continue;
+        }
+
+        auto val = std::get<eval::value>(eval::evaluate_default(mod, mem));
+        if (val.is_bool()) {
+            res[name] = val.as_bool();
+        } else if (val.is_integral()) {
+            res[name] = val.as_integral();
+        } else if (val.is_double()) {
+            res[name] = val.as_double();
+        } else if (val.is_string()) {
+            res[name] = std::string(val.as_string());
+            // Strings start with their 16 bit length.
+            alignment = std::max<int>(alignment, alignof(int16_t));
+        } else if (val.is_enum()) {
+            auto member = get_symbol(val.as_enum().enum_value.base);
+            res[name]   = static_cast<const enum_member*>(member)->value;
+        }
+    }
+
+    return res;
+}
+} // namespace
+
 sections struct_gen::do_generate() {
-    constexpr auto format = R"__(class {0} : public ::lidl::struct_base<{0}> {{
+    constexpr auto format = R"__(class {2}{0} : public ::lidl::struct_base<{0}> {{
             {1}
         }};)__";
 
@@ -20,7 +72,11 @@ sections struct_gen::do_generate() {
 
     section s;
     s.add_key(def_key());
-    s.definition = fmt::format(format, name(), body.get_sections().at(0).definition);
+    auto alignment =
+        get().alignment() ? fmt::format("alignas({}) ", *get().alignment()) : "";
+
+    s.definition =
+        fmt::format(format, name(), body.get_sections().at(0).definition, alignment);
     s.depends_on = body.get_sections().at(0).depends_on;
 
     section operator_eq;
@@ -42,6 +98,7 @@ sections struct_gen::do_generate() {
     if (!members.empty()) {
         result.add(std::move(operator_eq));
     }
+    result.merge_before(struct_json_gen(mod(), name(), absolute_name(), get()).generate());
     return result;
 }
 
@@ -82,7 +139,7 @@ sections struct_gen::generate_traits() {
                 static constexpr const char* name = "{0}";
                 static {0}& ctor(::lidl::message_builder& builder{2}) {{
                     return ::lidl::create<{0}>(builder{3});
-                }}
+                }}{5}
             }};)__";
 
     section trait_sect;
@@ -91,7 +148,8 @@ sections struct_gen::generate_traits() {
                                         fmt::join(members, ", "),
                                         fmt::join(ctor_types, ", "),
                                         fmt::join(ctor_args, ", "),
-                                        fmt::join(member_types, ", "));
+                                        fmt::join(member_types, ", "),
+                                        generate_default_message());
     trait_sect.add_dependency(def_key());
     trait_sect.add_key({symbol(), section_type::lidl_traits});
 
@@ -155,5 +213,29 @@ sections struct_gen::generate_traits() {
     return res;
 }
 
+std::string struct_gen::generate_default_message() {
+    if (get().all_members().empty() || get().is_generic()) {
+        return "";
+    }
+
+    int alignment = 1;
+    auto node     = default_message(mod(), get(), alignment);
+    if (!node) {
+        return "";
+    }
+
+    binary_writer writer;
+    get().yaml2bin(mod(), *node, writer);
 
+    std::vector<std::string> bytes;
+    for (auto byte : writer.get()) {
+        bytes.push_back(fmt::format("{:#04x}", byte));
+    }
+
+    constexpr auto format = R"__(
+                static constexpr size_t default_message_alignment = {};
+                static constexpr std::array<uint8_t, {}> default_message{{{}}};)__";
+
+    return fmt::format(format, alignment, bytes.size(), fmt::join(bytes, ", "));
+}
 } // namespace lidl::cpp
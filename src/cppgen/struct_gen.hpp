@@ -15,5 +15,11 @@ private:
     codegen::sections do_generate();
 
     codegen::sections generate_traits();
+
+    /**
+     * Members of the lidl traits holding a prebuilt message made of the default values
+     * of this structure, if all of its members have defaults.
+     */
+    std::string generate_default_message();
 };
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "cppgen.hpp"
 #include "enum_gen.hpp"
+#include "json_gen.hpp"
 #include "struct_bodygen.hpp"
 
 
@@ -204,6 +205,7 @@ template <class FunT>
     if (!eq_members.empty()) {
         result.add(std::move(operator_eq));
     }
+    result.merge_before(union_json_gen(mod(), name(), absolute_name(), get()).generate());
 
     return result;
 }
@@ -2,7 +2,7 @@
 
 namespace lidl {
 
-YAML::Node enumeration::bin2yaml(const module& mod, ibinary_reader& reader) const {
+YAML::Node enumeration::bin2yaml(const module& mod, binary_reader& reader) const {
     auto integral =
         lidl::get_wire_type(mod, underlying_type)->bin2yaml(mod, reader).as<uint64_t>();
 
@@ -17,6 +17,55 @@ YAML::Node enumeration::bin2yaml(const module& mod, ibinary_reader& reader) cons
     return YAML::Node(it->first);
 }
 
+int64_t enumeration::read_value(const module& mod, binary_reader& reader) const {
+    auto data = reader.read_bytes(wire_layout(mod).size());
+    int64_t x{0};
+    memcpy(reinterpret_cast<char*>(&x), data.data(), data.size());
+    return x;
+}
+
+int enumeration::write_value(const module& mod,
+                             int64_t value,
+                             binary_writer& writer) const {
+    auto layout = wire_layout(mod);
+    writer.align(layout.alignment());
+    auto pos = writer.tell();
+    writer.write_raw({reinterpret_cast<const char*>(&value), size_t(layout.size())});
+    return pos;
+}
+
+void enumeration::bin2json(const module& mod,
+                           binary_reader& reader,
+                           json_writer& writer) const {
+    auto integral = read_value(mod, reader);
+
+    auto mems = all_members();
+    auto it   = std::find_if(mems.begin(), mems.end(), [integral](auto& member) {
+        return member.second->value == integral;
+    });
+
+    if (it == mems.end()) {
+        throw std::runtime_error("unknown enum value");
+    }
+
+    writer.value(it->first);
+}
+
+int enumeration::json2bin(const module& mod,
+                          const json_value& value,
+                          binary_writer& writer) const {
+    if (!value.is_string()) {
+        return write_value(mod, value.as_int(), writer);
+    }
+
+    auto val = find_by_name(value.as_string());
+    if (val < 0) {
+        throw std::runtime_error(
+            fmt::format("unknown enum member \"{}\"", value.as_string()));
+    }
+    return write_value(mod, val, writer);
+}
+
 enum_member::enum_member(enumeration& en, int val, std::optional<source_info> src_info)
     : cbase{&en, std::move(src_info)}
     , value(val) {
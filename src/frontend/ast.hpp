@@ -21,9 +21,21 @@ struct name : node {
     std::optional<std::vector<std::variant<int64_t, name>>> args;
 };
 
+/**
+ * Attributes are written before the element they apply to, e.g. `@reorder struct foo`.
+ */
+struct attribute : node {
+    identifier name;
+    std::vector<std::variant<int64_t, identifier>> args;
+};
+
+struct expression;
+
 struct member : node {
+    std::vector<attribute> attributes;
     identifier name;
     ast::name type_name;
+    std::shared_ptr<expression> default_value;
 };
 
 struct structure_body {
@@ -37,6 +49,7 @@ struct union_body {
 };
 
 struct structure : node {
+    std::vector<attribute> attributes;
     identifier name;
     structure_body body;
 };
@@ -46,6 +59,7 @@ struct generic_parameter : node {
 };
 
 struct generic_structure : node {
+    std::vector<attribute> attributes;
     std::vector<generic_parameter> params;
     identifier name;
     structure_body body;
@@ -89,7 +103,9 @@ struct metadata {
     std::vector<std::string> imports;
 };
 
-struct expression : node {};
+struct expression : node {
+    virtual ~expression() = default;
+};
 
 struct string_literal_expression : expression {
     explicit string_literal_expression(std::string val)
@@ -98,6 +114,27 @@ struct string_literal_expression : expression {
     std::string literal;
 };
 
+struct integer_literal_expression : expression {
+    explicit integer_literal_expression(int64_t val)
+        : literal(val) {
+    }
+    int64_t literal;
+};
+
+struct floating_literal_expression : expression {
+    explicit floating_literal_expression(double val)
+        : literal(val) {
+    }
+    double literal;
+};
+
+struct boolean_literal_expression : expression {
+    explicit boolean_literal_expression(bool val)
+        : literal(val) {
+    }
+    bool literal;
+};
+
 struct id_expression : expression {
     ast::name name;
 };
@@ -107,8 +144,35 @@ struct function_call_expression : expression {
     std::vector<std::unique_ptr<expression>> arguments;
 };
 
+/**
+ * `sizeof(T)` and `alignof(T)`, where `op` is the keyword.
+ */
+struct type_query_expression : expression {
+    std::string op;
+    ast::name type;
+};
+
+/**
+ * Operators are stored with their spelling, e.g. `<=`.
+ */
+struct unary_expression : expression {
+    std::string op;
+    std::shared_ptr<expression> operand;
+};
+
+struct binary_expression : expression {
+    std::string op;
+    std::shared_ptr<expression> left, right;
+};
+
+struct constant : node {
+    identifier name;
+    ast::name type;
+    std::shared_ptr<expression> value;
+};
+
 struct static_assertion : node {
-    // std::unique_ptr<expression> body;
+    std::shared_ptr<expression> body;
     std::shared_ptr<expression> error_message;
 };
 
@@ -118,6 +182,7 @@ using element = std::variant<structure,
                              service,
                              generic_structure,
                              generic_union,
+                             constant,
                              static_assertion>;
 
 struct module {
@@ -1,12 +1,93 @@
 #include "lexer.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <lidl/error.hpp>
 #include <string_view>
-#include <unordered_map>
 
 namespace lidl::frontend {
 namespace {
-std::unordered_map<std::string_view, token_type> keywords = {
+enum char_class : uint8_t
+{
+    cc_none        = 0,
+    cc_ident_start = 1 << 0,
+    cc_ident_rest  = 1 << 1,
+    cc_digit       = 1 << 2,
+    cc_space       = 1 << 3,
+    cc_punct       = 1 << 4,
+};
+
+struct char_tables {
+    std::array<uint8_t, 256> classes{};
+    std::array<token_type, 256> punctuators{};
+};
+
+constexpr char_tables make_char_tables() {
+    char_tables res{};
+
+    for (int c = 'a'; c <= 'z'; ++c) {
+        res.classes[c] |= cc_ident_start | cc_ident_rest;
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) {
+        res.classes[c] |= cc_ident_start | cc_ident_rest;
+    }
+    for (int c = '0'; c <= '9'; ++c) {
+        res.classes[c] |= cc_ident_rest | cc_digit;
+    }
+    res.classes['_'] |= cc_ident_rest;
+
+    for (unsigned char c : {' ', '\t', '\n', '\r', '\v', '\f'}) {
+        res.classes[c] |= cc_space;
+    }
+
+    constexpr std::pair<char, token_type> one_chars[] = {
+        {'.', token_type::dot},
+        {':', token_type::colon},
+        {';', token_type::semicolon},
+        {'=', token_type::eq},
+        {'(', token_type::left_parens},
+        {')', token_type::right_parens},
+        {'{', token_type::left_brace},
+        {'}', token_type::right_brace},
+        {'<', token_type::left_angular},
+        {'>', token_type::right_angular},
+        {',', token_type::comma},
+        {'@', token_type::at},
+        {'+', token_type::plus},
+        {'-', token_type::minus},
+        {'*', token_type::star},
+        {'/', token_type::slash},
+        {'%', token_type::percent},
+        {'!', token_type::bang},
+        {'\n', token_type::newline},
+    };
+
+    for (auto& [c, type] : one_chars) {
+        res.classes[static_cast<unsigned char>(c)] |= cc_punct;
+        res.punctuators[static_cast<unsigned char>(c)] = type;
+    }
+
+    return res;
+}
+
+constexpr auto tables = make_char_tables();
+
+constexpr uint8_t char_class_of(char c) {
+    return tables.classes[static_cast<unsigned char>(c)];
+}
+
+/**
+ * Keywords are recognized with a perfect hash over the length and the first and
+ * last characters of an identifier. The hash only selects a candidate, the
+ * candidate still has to compare equal to the identifier.
+ */
+struct keyword_entry {
+    std::string_view text;
+    token_type type;
+};
+
+constexpr keyword_entry keywords[] = {
     {"struct", token_type::kw_struct},
     {"union", token_type::kw_union},
     {"enum", token_type::kw_enum},
@@ -16,81 +97,136 @@ std::unordered_map<std::string_view, token_type> keywords = {
     {"namespace", token_type::kw_namespace},
     {"import", token_type::kw_import},
     {"static_assert", token_type::kw_static_assert},
+    {"sizeof", token_type::kw_sizeof},
+    {"alignof", token_type::kw_alignof},
+    {"const", token_type::kw_const},
 };
 
-std::unordered_map<uint32_t, token_type> one_chars = {
-    {'.', token_type::dot},
-    {':', token_type::colon},
-    {';', token_type::semicolon},
-    {'=', token_type::eq},
-    {'(', token_type::left_parens},
-    {')', token_type::right_parens},
-    {'{', token_type::left_brace},
-    {'}', token_type::right_brace},
-    {'<', token_type::left_angular},
-    {'>', token_type::right_angular},
-    {',', token_type::comma},
-    {'\n', token_type::newline},
-    {EOF, token_type::eof},
-};
+constexpr size_t keyword_hash(std::string_view ident) {
+    return (static_cast<unsigned char>(ident.front()) +
+            static_cast<unsigned char>(ident.back()) + ident.size() * 13) &
+           31;
+}
 
-std::unordered_map<std::string_view, token_type> two_chars = {
-    {"->", token_type::arrow},
-    {"=>", token_type::fat_arrow},
-    {"::", token_type::coloncolon},
+struct keyword_table {
+    std::array<const keyword_entry*, 32> slots{};
+    bool perfect = true;
 };
 
-std::optional<std::pair<token_type, int>> try_one_char(std::string_view input) {
-    if (auto it = one_chars.find(input.front()); it != one_chars.end()) {
-        return std::pair{it->second, 1};
+constexpr keyword_table make_keyword_table() {
+    keyword_table res{};
+    for (auto& kw : keywords) {
+        auto& slot = res.slots[keyword_hash(kw.text)];
+        if (slot) {
+            res.perfect = false;
+        }
+        slot = &kw;
     }
-    return {};
+    return res;
 }
 
-std::optional<std::pair<token_type, int>> try_two_char(std::string_view input) {
-    if (auto it = two_chars.find(input.substr(0, 2)); it != two_chars.end()) {
-        return std::pair{it->second, 2};
+constexpr auto keyword_lookup = make_keyword_table();
+static_assert(keyword_lookup.perfect, "Keyword hash has collisions!");
+
+constexpr token_type classify_identifier(std::string_view ident) {
+    auto entry = keyword_lookup.slots[keyword_hash(ident)];
+    if (entry && entry->text == ident) {
+        return entry->type;
     }
-    return {};
+    return token_type::identifier;
 }
 
-std::optional<std::pair<token_type, int>> try_identifier(std::string_view input) {
-    auto orig = input;
-    if (!isalpha(input.front())) {
+static_assert(classify_identifier("static_assert") == token_type::kw_static_assert);
+static_assert(classify_identifier("structs") == token_type::identifier);
+static_assert(classify_identifier("sizeof") == token_type::kw_sizeof);
+
+using try_t = std::optional<std::pair<token_type, int>>;
+
+try_t try_two_char(std::string_view input) {
+    if (input.size() < 2) {
         return {};
     }
 
-    int len = 0;
-    while (isalnum(input.front()) || input.front() == '_') {
-        ++len;
-        input.remove_prefix(1);
+    switch (input[0]) {
+    case '-':
+        if (input[1] == '>') {
+            return std::pair{token_type::arrow, 2};
+        }
+        break;
+    case '=':
+        if (input[1] == '>') {
+            return std::pair{token_type::fat_arrow, 2};
+        }
+        if (input[1] == '=') {
+            return std::pair{token_type::eqeq, 2};
+        }
+        break;
+    case ':':
+        if (input[1] == ':') {
+            return std::pair{token_type::coloncolon, 2};
+        }
+        break;
+    case '!':
+        if (input[1] == '=') {
+            return std::pair{token_type::noteq, 2};
+        }
+        break;
+    case '<':
+        if (input[1] == '=') {
+            return std::pair{token_type::less_eq, 2};
+        }
+        break;
+    case '>':
+        if (input[1] == '=') {
+            return std::pair{token_type::greater_eq, 2};
+        }
+        break;
+    case '&':
+        if (input[1] == '&') {
+            return std::pair{token_type::ampamp, 2};
+        }
+        break;
+    case '|':
+        if (input[1] == '|') {
+            return std::pair{token_type::pipepipe, 2};
+        }
+        break;
     }
 
-    if (auto it = keywords.find(orig.substr(0, len)); it != keywords.end()) {
-        return std::pair{it->second, len};
+    return {};
+}
+
+try_t try_identifier(std::string_view input) {
+    auto it  = input.begin();
+    auto end = input.end();
+
+    while (it != end && (char_class_of(*it) & cc_ident_rest)) {
+        ++it;
     }
 
-    return std::pair{token_type::identifier, len};
+    auto ident = input.substr(0, it - input.begin());
+    return std::pair{classify_identifier(ident), static_cast<int>(ident.size())};
 }
 
-using try_t = std::optional<std::pair<token_type, int>>;
-
 try_t try_number(std::string_view input) {
-    bool have_dot = false;
-    int len       = 0;
+    auto it  = input.begin();
+    auto end = input.end();
 
-    while (isdigit(input.front()) || (input.front() == '.' && !have_dot)) {
-        len++;
-        if (input.front() == '.') {
-            have_dot = true;
-        }
-        input.remove_prefix(1);
+    while (it != end && (char_class_of(*it) & cc_digit)) {
+        ++it;
     }
 
-    if (len == 0) {
-        return {};
+    bool have_dot = false;
+    if (it != end && *it == '.') {
+        have_dot = true;
+        ++it;
+        while (it != end && (char_class_of(*it) & cc_digit)) {
+            ++it;
+        }
     }
 
+    auto len = static_cast<int>(it - input.begin());
+
     if (have_dot) {
         return std::pair{token_type::floating, len};
     }
@@ -100,68 +236,64 @@ try_t try_number(std::string_view input) {
 
 try_t try_comment(std::string_view input) {
     if (input.starts_with("//")) {
-        auto next_new_line = input.find_first_of('\n');
+        auto next_new_line = input.find('\n');
         if (next_new_line == input.npos) {
-            // error
-            exit(1);
+            return std::pair{token_type::line_comment, static_cast<int>(input.size())};
         }
-        return std::pair{token_type::line_comment, next_new_line};
+        return std::pair{token_type::line_comment, static_cast<int>(next_new_line)};
     }
 
     if (input.starts_with("/*")) {
-        auto next_new_line = input.find_first_of("*/", 2);
-        if (next_new_line == input.npos) {
-            // error
-            exit(1);
+        auto comment_end = input.find("*/", 2);
+        if (comment_end == input.npos) {
+            report_user_error(error_type::fatal, {}, "Unterminated block comment");
         }
-        return std::pair{token_type::block_comment, next_new_line + 2};
+        return std::pair{token_type::block_comment, static_cast<int>(comment_end + 2)};
     }
 
     return {};
 }
 
 try_t try_string_literal(std::string_view input) {
-    if (!input.starts_with('"')) {
-        return {};
+    auto literal_end = input.find_first_of("\"\n", 1);
+    if (literal_end == input.npos) {
+        report_user_error(error_type::fatal, {}, "Unterminated string literal");
     }
-
-    input.remove_prefix(1);
-    int len = 1;
-
-    while (input.front() != '"') {
-        ++len;
-        if (input.front() == '\n') {
-            report_user_error(error_type::fatal, {}, "Newline in string literal");
-        }
-        input.remove_prefix(1);
+    if (input[literal_end] == '\n') {
+        report_user_error(error_type::fatal, {}, "Newline in string literal");
     }
 
-    return std::pair{token_type::string_literal, len + 1};
+    return std::pair{token_type::string_literal, static_cast<int>(literal_end + 1)};
 }
 
-std::optional<std::pair<token_type, int>> try_next(std::string_view input) {
-    if (auto res = try_two_char(input)) {
-        return res;
+try_t try_next(std::string_view input) {
+    auto first = input.front();
+    auto cls   = char_class_of(first);
+
+    if (cls & cc_ident_start) {
+        return try_identifier(input);
     }
 
-    if (auto res = try_one_char(input)) {
-        return res;
+    if (cls & cc_digit) {
+        return try_number(input);
     }
 
-    if (auto res = try_identifier(input)) {
-        return res;
+    if (first == '/') {
+        if (auto res = try_comment(input)) {
+            return res;
+        }
     }
 
-    if (auto res = try_number(input)) {
-        return res;
+    if (first == '"') {
+        return try_string_literal(input);
     }
 
-    if (auto res = try_comment(input)) {
+    if (auto res = try_two_char(input)) {
         return res;
     }
 
-    if (auto res = try_string_literal(input)) {
-        return res;
+    if (cls & cc_punct) {
+        return std::pair{tables.punctuators[static_cast<unsigned char>(first)], 1};
     }
 
     return {};
@@ -209,17 +341,21 @@ void lexer::next() {
 }
 
 void lexer::consume_whitespace() {
-    for (int i = 0; !m_current.empty() && iswspace(m_current.front()); ++i) {
-        if (m_current.front() == ' ' || m_current.front() == '\t') {
-            src_info.column += 1;
-        } else if (m_current.front() == '\n') {
+    auto it  = m_current.begin();
+    auto end = m_current.end();
+
+    for (; it != end && (char_class_of(*it) & cc_space); ++it) {
+        if (*it == '\n') {
             src_info.line += 1;
             src_info.column = 0;
+        } else if (*it == ' ' || *it == '\t') {
+            src_info.column += 1;
         }
-
-        src_info.pos += 1;
-        m_current.remove_prefix(1);
     }
+
+    auto consumed = it - m_current.begin();
+    src_info.pos += consumed;
+    m_current.remove_prefix(consumed);
 }
 
 lexer::lexer(std::string_view input)
@@ -232,4 +368,4 @@ lexer::lexer(std::string_view input)
 token lexer::get() const {
     return m_last;
 }
-} // namespace lidl::frontend
\ No newline at end of file
+} // namespace lidl::frontend
@@ -10,6 +10,9 @@ enum class token_type
     kw_service,
     kw_enum,
     kw_static_assert,
+    kw_sizeof,
+    kw_alignof,
+    kw_const,
     kw_namespace,
     kw_import,
     left_angular,
@@ -26,11 +29,23 @@ enum class token_type
     semicolon,
     dot,
     eqeq,
+    noteq,
+    less_eq,
+    greater_eq,
+    ampamp,
+    pipepipe,
+    plus,
+    minus,
+    star,
+    slash,
+    percent,
+    bang,
     left_brace,
     right_brace,
     eq,
     arrow,
     fat_arrow,
+    at,
     integer,
     floating,
     kw_true,
@@ -61,7 +76,7 @@ private:
 
     bool m_finished = false;
     source_info src_info{0, 0, 0, 0};
-    token m_last;
+    token m_last{};
     std::string_view m_input;
     std::string_view m_current;
 };
@@ -0,0 +1,69 @@
+#include "lexer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <iostream>
+#include <string>
+
+namespace {
+std::string generate_input(int num_types) {
+    std::string res = "namespace lidl::bench;\n\n";
+    for (int i = 0; i < num_types; ++i) {
+        res += fmt::format(R"__(// structure number {0}
+struct type_{0} {{
+    x: f32;
+    y: vector<u8>;
+    z: array<i32, {1}>;
+    name: string;
+}}
+
+/*
+ * union number {0}
+ */
+union variant_{0} {{
+    a: type_{0};
+    b: f64;
+}}
+
+enum kind_{0} : u8 {{
+    foo,
+    bar = {1},
+    baz,
+}}
+
+service service_{0} {{
+    call(in: string_view, len: i32) -> (r: vector<type_{0}>);
+}}
+
+)__",
+                           i,
+                           i % 128);
+    }
+    return res;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    int num_types = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int rounds    = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    auto input = generate_input(num_types);
+
+    size_t total_tokens = 0;
+    auto begin          = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        for (auto lexer = lidl::frontend::lexer(input); !lexer.done(); lexer.next()) {
+            ++total_tokens;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto secs = std::chrono::duration<double>(end - begin).count();
+    std::cout << fmt::format("{} bytes, {} tokens in {:.3f}s: {:.0f} tokens/sec, {:.1f} MB/sec\n",
+                             input.size() * rounds,
+                             total_tokens,
+                             secs,
+                             total_tokens / secs,
+                             input.size() * rounds / secs / 1e6);
+}
@@ -0,0 +1,95 @@
+#include "lexer.hpp"
+
+#include <doctest.h>
+#include <vector>
+
+namespace lidl::frontend {
+namespace {
+std::vector<token> lex_all(std::string_view input) {
+    std::vector<token> res;
+    for (auto lex = lexer(input); !lex.done(); lex.next()) {
+        res.push_back(lex.get());
+    }
+    return res;
+}
+
+TEST_CASE("lexer recognizes keywords and identifiers") {
+    auto toks = lex_all("struct structs union enum_ static_assert import const");
+    REQUIRE_EQ(8, toks.size());
+    REQUIRE_EQ(token_type::kw_struct, toks[0].type);
+    REQUIRE_EQ(token_type::identifier, toks[1].type);
+    REQUIRE_EQ("structs", toks[1].content);
+    REQUIRE_EQ(token_type::kw_union, toks[2].type);
+    REQUIRE_EQ(token_type::identifier, toks[3].type);
+    REQUIRE_EQ(token_type::kw_static_assert, toks[4].type);
+    REQUIRE_EQ(token_type::kw_import, toks[5].type);
+    REQUIRE_EQ(token_type::kw_const, toks[6].type);
+    REQUIRE_EQ(token_type::eof, toks[7].type);
+}
+
+TEST_CASE("lexer handles punctuators") {
+    auto toks = lex_all("a::b -> => == = :;");
+    std::vector<token_type> expected = {token_type::identifier,
+                                        token_type::coloncolon,
+                                        token_type::identifier,
+                                        token_type::arrow,
+                                        token_type::fat_arrow,
+                                        token_type::eqeq,
+                                        token_type::eq,
+                                        token_type::colon,
+                                        token_type::semicolon,
+                                        token_type::eof};
+    REQUIRE_EQ(expected.size(), toks.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE_EQ(expected[i], toks[i].type);
+    }
+}
+
+TEST_CASE("lexer handles expression operators") {
+    auto toks = lex_all("sizeof(a) + 1 - 2 * 3 / 4 % 5 <= >= != < && || !alignof");
+    std::vector<token_type> expected = {token_type::kw_sizeof,
+                                        token_type::left_parens,
+                                        token_type::identifier,
+                                        token_type::right_parens,
+                                        token_type::plus,
+                                        token_type::integer,
+                                        token_type::minus,
+                                        token_type::integer,
+                                        token_type::star,
+                                        token_type::integer,
+                                        token_type::slash,
+                                        token_type::integer,
+                                        token_type::percent,
+                                        token_type::integer,
+                                        token_type::less_eq,
+                                        token_type::greater_eq,
+                                        token_type::noteq,
+                                        token_type::left_angular,
+                                        token_type::ampamp,
+                                        token_type::pipepipe,
+                                        token_type::bang,
+                                        token_type::kw_alignof,
+                                        token_type::eof};
+    REQUIRE_EQ(expected.size(), toks.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE_EQ(expected[i], toks[i].type);
+    }
+}
+
+TEST_CASE("lexer handles numbers, strings and comments") {
+    auto toks = lex_all("42 3.14 \"./std\" // line\n/* block\n */ x");
+    REQUIRE_EQ(7, toks.size());
+    REQUIRE_EQ(token_type::integer, toks[0].type);
+    REQUIRE_EQ("42", toks[0].content);
+    REQUIRE_EQ(token_type::floating, toks[1].type);
+    REQUIRE_EQ("3.14", toks[1].content);
+    REQUIRE_EQ(token_type::string_literal, toks[2].type);
+    REQUIRE_EQ("\"./std\"", toks[2].content);
+    REQUIRE_EQ(token_type::line_comment, toks[3].type);
+    REQUIRE_EQ(token_type::block_comment, toks[4].type);
+    REQUIRE_EQ("/* block\n */", toks[4].content);
+    REQUIRE_EQ(token_type::identifier, toks[5].type);
+    REQUIRE_EQ(2, toks[5].src_info->line);
+}
+} // namespace
+} // namespace lidl::frontend
@@ -1,7 +1,9 @@
 #include "parser.hpp"
 
+#include <lidl/eval.hpp>
 #include <lidl/loader.hpp>
 #include <lidl/module.hpp>
+#include <lidl/time_report.hpp>
 
 namespace lidl::frontend {
 namespace {
@@ -20,6 +22,19 @@ auto make_overload(Ts&&... ts) {
     return overload<std::remove_reference_t<Ts>...>(std::forward<Ts>(ts)...);
 }
 
+/**
+ * Parses the argument of an @align(N) attribute. N must be a power of two.
+ */
+size_t parse_alignment(const ast::attribute& attr) {
+    auto arg = attr.args.size() == 1 ? std::get_if<int64_t>(&attr.args.front()) : nullptr;
+    if (!arg || *arg <= 0 || (*arg & (*arg - 1)) != 0) {
+        report_user_error(error_type::fatal,
+                          attr.src_info,
+                          "@align expects a single power of two argument");
+    }
+    return static_cast<size_t>(*arg);
+}
+
 struct loader final : module_loader {
     loader(load_context& ctx, ast::module&& mod, std::optional<std::string> origin = {})
         : m_ast_mod(std::move(mod))
@@ -34,7 +49,11 @@ struct loader final : module_loader {
     }
 
     void load() override {
-        declare_pass();
+        {
+            time_report::phase declare_phase("declare");
+            declare_pass();
+        }
+        time_report::phase define_phase("define");
         define_pass();
     }
 
@@ -60,10 +79,14 @@ private:
     bool parse(const ast::generic_union& str, generic_union& res);
     bool parse(const ast::union_& str, union_type& s);
     bool parse(const ast::enumeration& str, enumeration& s);
+    bool parse(const ast::constant& c, constant& res);
     generic_parameters parse(const std::vector<ast::generic_parameter>& params);
     parameter parse(const ast::service::procedure::parameter& proc, base& s);
     std::unique_ptr<procedure> parse(const ast::service::procedure& proc, base& s);
     bool parse(const ast::service& serv, service& s);
+    void apply_attributes(const std::vector<ast::attribute>& attrs, structure& res);
+    std::unique_ptr<eval::expression> parse(const ast::expression& expr, base& s);
+    static_assertion parse(const ast::static_assertion& assertion);
 
     void add(std::string_view name, std::unique_ptr<structure>&& str) {
         m_mod->structs.emplace_back(std::move(str));
@@ -95,6 +118,11 @@ private:
         define(m_mod->symbols(), name, m_mod->services.back().get());
     }
 
+    void add(std::string_view name, std::unique_ptr<constant>&& c) {
+        m_mod->constants.emplace_back(std::move(c));
+        define(m_mod->symbols(), name, m_mod->constants.back().get());
+    }
+
     template<class T>
     void add_default_top_level(std::string_view name) {
         m_mod->symbols().declare(name);
@@ -139,6 +167,10 @@ template<>
 struct ast_to_lidl_map<ast::service> {
     using type = service;
 };
+template<>
+struct ast_to_lidl_map<ast::constant> {
+    using type = constant;
+};
 
 template<class T>
 using ast_to_lidl_map_t = typename ast_to_lidl_map<T>::type;
@@ -165,8 +197,10 @@ void lidl::frontend::loader::define_pass() {
     for (const auto& e : m_ast_mod.elements) {
         std::visit(
             [this](auto& x) {
-                if constexpr (!std::is_same_v<const ast::static_assertion&,
-                                              decltype(x)>) {
+                if constexpr (std::is_same_v<const ast::static_assertion&,
+                                             decltype(x)>) {
+                    m_mod->static_assertions.push_back(parse(x));
+                } else {
 #ifdef LIDL_VERBOSE_LOG
                     std::cerr << "Define " << x.name << '\n';
 #endif
@@ -209,23 +243,157 @@ name lidl::frontend::loader::parse(const ast::name& nm, base& s) {
 }
 
 std::unique_ptr<member> lidl::frontend::loader::parse(const ast::member& mem, base& s) {
-    auto res = std::make_unique<member>(&s);
+    auto res = std::make_unique<member>(&s, mem.src_info);
 
     res->type_ = parse(mem.type_name, *res);
 
+    if (mem.default_value) {
+        res->default_value = parse(*mem.default_value, *res);
+    }
+
+    for (auto& attr : mem.attributes) {
+        if (attr.name == "align") {
+            res->alignment = parse_alignment(attr);
+            continue;
+        }
+
+        if (attr.name == "cold") {
+            res->cold = true;
+            continue;
+        }
+
+        report_user_error(
+            error_type::warning, attr.src_info, "Unknown member attribute: {}", attr.name);
+    }
+
+    return res;
+}
+
+void lidl::frontend::loader::apply_attributes(const std::vector<ast::attribute>& attrs,
+                                              structure& res) {
+    for (auto& attr : attrs) {
+        if (attr.name == "reorder") {
+            res.set_reorder_members(true);
+            continue;
+        }
+
+        if (attr.name == "align") {
+            res.set_alignment(parse_alignment(attr));
+            continue;
+        }
+
+        report_user_error(
+            error_type::warning, attr.src_info, "Unknown structure attribute: {}", attr.name);
+    }
+}
+
+std::unique_ptr<eval::expression>
+lidl::frontend::loader::parse(const ast::expression& expr, base& s) {
+    auto with_src_info = [&](auto res) -> std::unique_ptr<eval::expression> {
+        res->src_info = expr.src_info;
+        return res;
+    };
+
+    if (auto lit = dynamic_cast<const ast::integer_literal_expression*>(&expr)) {
+        auto res   = std::make_unique<eval::integral_literal_expression>();
+        res->value = lit->literal;
+        return with_src_info(std::move(res));
+    }
+
+    if (auto lit = dynamic_cast<const ast::floating_literal_expression*>(&expr)) {
+        auto res   = std::make_unique<eval::floating_literal_expression>();
+        res->value = lit->literal;
+        return with_src_info(std::move(res));
+    }
+
+    if (auto lit = dynamic_cast<const ast::boolean_literal_expression*>(&expr)) {
+        auto res   = std::make_unique<eval::boolean_literal_expression>();
+        res->value = lit->literal;
+        return with_src_info(std::move(res));
+    }
+
+    if (auto lit = dynamic_cast<const ast::string_literal_expression*>(&expr)) {
+        auto res   = std::make_unique<eval::string_literal_expression>();
+        res->value = lit->literal;
+        return with_src_info(std::move(res));
+    }
+
+    if (auto id = dynamic_cast<const ast::id_expression*>(&expr)) {
+        auto lookup = recursive_full_name_lookup(s.get_scope(), id->name.base);
+        if (!lookup) {
+            report_user_error(
+                error_type::fatal, id->src_info, "Unknown name: {}", id->name.base);
+        }
+        auto res        = std::make_unique<eval::name_literal_expression>();
+        res->value_name = name{*lookup};
+        return with_src_info(std::move(res));
+    }
+
+    if (auto query = dynamic_cast<const ast::type_query_expression*>(&expr)) {
+        if (query->op == "sizeof") {
+            auto res       = std::make_unique<eval::sizeof_expression>();
+            res->type_name = parse(query->type, s);
+            return with_src_info(std::move(res));
+        }
+        auto res       = std::make_unique<eval::alignof_expression>();
+        res->type_name = parse(query->type, s);
+        return with_src_info(std::move(res));
+    }
+
+    if (auto unary = dynamic_cast<const ast::unary_expression*>(&expr)) {
+        auto res     = std::make_unique<eval::unary_expression>();
+        res->op      = eval::parse_unary_operator(unary->op).value();
+        res->operand = parse(*unary->operand, s);
+        return with_src_info(std::move(res));
+    }
+
+    if (auto binary = dynamic_cast<const ast::binary_expression*>(&expr)) {
+        auto res   = std::make_unique<eval::binary_expression>();
+        res->op    = eval::parse_binary_operator(binary->op).value();
+        res->left  = parse(*binary->left, s);
+        res->right = parse(*binary->right, s);
+        return with_src_info(std::move(res));
+    }
+
+    report_user_error(
+        error_type::fatal, expr.src_info, "Unsupported constant expression");
+    return nullptr;
+}
+
+static_assertion lidl::frontend::loader::parse(const ast::static_assertion& assertion) {
+    static_assertion res;
+    res.src_info  = assertion.src_info;
+    res.condition = parse(*assertion.body, *m_mod);
+    if (auto msg = dynamic_cast<const ast::string_literal_expression*>(
+            assertion.error_message.get())) {
+        res.message = msg->literal;
+    }
     return res;
 }
 
 bool lidl::frontend::loader::parse(const ast::structure& str, structure& res) {
+    apply_attributes(str.attributes, res);
     for (auto& mem : str.body.members) {
         res.add_member(mem.name, *parse(mem, res));
     }
+    split_cold_members(*m_mod, res, str.name);
     return true;
 }
 
 bool lidl::frontend::loader::parse(const ast::union_& str, union_type& res) {
     for (auto& mem : str.body.members) {
-        res.add_member(mem.name, *parse(mem, res));
+        auto member = parse(mem, res);
+        if (member->alignment || member->cold) {
+            report_user_error(error_type::warning,
+                              mem.src_info,
+                              "Layout attributes are not supported on union members");
+        }
+        if (member->default_value) {
+            report_user_error(error_type::fatal,
+                              mem.src_info,
+                              "Default values are not supported on union members");
+        }
+        res.add_member(mem.name, *member);
     }
     return true;
 }
@@ -238,6 +406,13 @@ bool lidl::frontend::loader::parse(const ast::enumeration& enu, enumeration& res
     return true;
 }
 
+bool lidl::frontend::loader::parse(const ast::constant& c, constant& res) {
+    res.src_info = c.src_info;
+    res.type     = parse(c.type, res);
+    res.value    = parse(*c.value, res);
+    return true;
+}
+
 parameter lidl::frontend::loader::parse(const ast::service::procedure::parameter& proc,
                                         base& s) {
     parameter res(&s);
@@ -276,13 +451,25 @@ bool lidl::frontend::loader::parse(const ast::generic_structure& str,
                                    generic_structure& res) {
     res.struct_     = std::make_unique<structure>(&res);
     res.declaration = parse(str.params);
+    apply_attributes(str.attributes, *res.struct_);
 
     for (auto& [name, param] : res.declaration) {
         res.get_scope().declare(name);
     }
 
     for (auto& mem : str.body.members) {
-        res.struct_->add_member(mem.name, *parse(mem, *res.struct_));
+        auto member = parse(mem, *res.struct_);
+        if (member->cold) {
+            report_user_error(error_type::fatal,
+                              mem.src_info,
+                              "Cold members are not supported in generic structures");
+        }
+        if (member->default_value) {
+            report_user_error(error_type::fatal,
+                              mem.src_info,
+                              "Default values are not supported in generic structures");
+        }
+        res.struct_->add_member(mem.name, *member);
     }
 
     return true;
@@ -194,10 +194,12 @@ struct parser {
     std::optional<ast::member> parse_member() {
         // identifier: type;
 
-        auto backup = m_tokens;
-        auto id     = parse_id();
+        auto backup     = m_tokens;
+        auto attributes = parse_attributes();
+        auto id         = parse_id();
 
         if (!id) {
+            m_tokens = backup;
             return {};
         }
 
@@ -214,9 +216,68 @@ struct parser {
         }
 
         ast::member res;
-        res.src_info  = backup.front().src_info;
-        res.name      = std::move(*id);
-        res.type_name = std::move(*type_id);
+        res.src_info   = backup.front().src_info;
+        res.attributes = std::move(attributes);
+        res.name       = std::move(*id);
+        res.type_name  = std::move(*type_id);
+
+        if (match(token_type::eq)) {
+            res.default_value = parse_expression();
+            if (!res.default_value) {
+                report_user_error(error_type::fatal,
+                                  m_tokens.front().src_info,
+                                  "Expected default value for {}",
+                                  res.name);
+            }
+        }
+
+        return res;
+    }
+
+    std::optional<std::variant<int64_t, ast::identifier>> parse_attribute_arg() {
+        if (auto int_lit = match(token_type::integer)) {
+            return std::stoll(std::string((*int_lit)[0].content));
+        }
+
+        if (auto id = parse_id()) {
+            return std::move(*id);
+        }
+
+        return {};
+    }
+
+    std::optional<ast::attribute> parse_attribute() {
+        auto backup = m_tokens;
+        if (!match(token_type::at)) {
+            return {};
+        }
+
+        auto id = parse_id();
+        if (!id) {
+            report_user_error(
+                error_type::fatal, m_tokens.front().src_info, "Expected attribute name");
+        }
+
+        ast::attribute res;
+        res.src_info = backup.front().src_info;
+        res.name     = std::move(*id);
+
+        auto args = parse_list<&parser::parse_attribute_arg,
+                               token_type::left_parens,
+                               token_type::comma,
+                               token_type::right_parens>();
+        if (args) {
+            res.args = std::move(*args);
+        }
+
+        return res;
+    }
+
+    std::vector<ast::attribute> parse_attributes() {
+        std::vector<ast::attribute> res;
+        while (auto attr = parse_attribute()) {
+            res.push_back(std::move(*attr));
+        }
         return res;
     }
 
@@ -487,15 +548,284 @@ struct parser {
         return res;
     }
 
+    static int binary_precedence(token_type type) {
+        switch (type) {
+        case token_type::pipepipe:
+            return 1;
+        case token_type::ampamp:
+            return 2;
+        case token_type::eqeq:
+        case token_type::noteq:
+            return 3;
+        case token_type::left_angular:
+        case token_type::right_angular:
+        case token_type::less_eq:
+        case token_type::greater_eq:
+            return 4;
+        case token_type::plus:
+        case token_type::minus:
+            return 5;
+        case token_type::star:
+        case token_type::slash:
+        case token_type::percent:
+            return 6;
+        default:
+            return 0;
+        }
+    }
+
+    std::shared_ptr<ast::expression> parse_primary_expression() {
+        auto backup = m_tokens;
+
+        if (auto mres = match(token_type::integer)) {
+            auto [tok] = *mres;
+            auto res = std::make_shared<ast::integer_literal_expression>(
+                std::stoll(std::string(tok.content)));
+            res->src_info = tok.src_info;
+            return res;
+        }
+
+        if (auto mres = match(token_type::floating)) {
+            auto [tok] = *mres;
+            auto res = std::make_shared<ast::floating_literal_expression>(
+                std::stod(std::string(tok.content)));
+            res->src_info = tok.src_info;
+            return res;
+        }
+
+        if (auto tok = oneof(token_type::kw_true, token_type::kw_false)) {
+            auto res = std::make_shared<ast::boolean_literal_expression>(
+                tok->type == token_type::kw_true);
+            res->src_info = tok->src_info;
+            return res;
+        }
+
+        if (auto mres = match(token_type::string_literal)) {
+            auto [tok] = *mres;
+            auto res   = std::make_shared<ast::string_literal_expression>(
+                std::string(tok.content.begin() + 1, tok.content.end() - 1));
+            res->src_info = tok.src_info;
+            return res;
+        }
+
+        if (match(token_type::left_parens)) {
+            auto res = parse_expression();
+            if (!res) {
+                report_user_error(
+                    error_type::fatal, m_tokens.front().src_info, "Expected expression");
+            }
+            if (!match(token_type::right_parens)) {
+                report_user_error(
+                    error_type::fatal, m_tokens.front().src_info, "Expected )");
+            }
+            return res;
+        }
+
+        if (auto tok = oneof(token_type::kw_sizeof, token_type::kw_alignof)) {
+            if (!match(token_type::left_parens)) {
+                report_user_error(error_type::fatal,
+                                  m_tokens.front().src_info,
+                                  "Expected ( after {}",
+                                  tok->content);
+            }
+            auto type = parse_name();
+            if (!type) {
+                report_user_error(error_type::fatal,
+                                  m_tokens.front().src_info,
+                                  "Expected type name in {}",
+                                  tok->content);
+            }
+            if (!match(token_type::right_parens)) {
+                report_user_error(
+                    error_type::fatal, m_tokens.front().src_info, "Expected )");
+            }
+            auto res      = std::make_shared<ast::type_query_expression>();
+            res->src_info = tok->src_info;
+            res->op       = std::string(tok->content);
+            res->type     = std::move(*type);
+            return res;
+        }
+
+        // Constants can't be generic, so there's no need to look for generic arguments,
+        // which would be ambiguous with the less than operator.
+        if (auto id = parse_qualified_id()) {
+            auto res           = std::make_shared<ast::id_expression>();
+            res->src_info      = backup.front().src_info;
+            res->name.src_info = res->src_info;
+            res->name.base     = std::move(*id);
+            return res;
+        }
+
+        return nullptr;
+    }
+
+    std::shared_ptr<ast::expression> parse_unary_expression() {
+        if (auto tok = oneof(token_type::minus, token_type::bang)) {
+            auto operand = parse_unary_expression();
+            if (!operand) {
+                report_user_error(error_type::fatal,
+                                  m_tokens.front().src_info,
+                                  "Expected expression after {}",
+                                  tok->content);
+            }
+            auto res      = std::make_shared<ast::unary_expression>();
+            res->src_info = tok->src_info;
+            res->op       = std::string(tok->content);
+            res->operand  = std::move(operand);
+            return res;
+        }
+
+        return parse_primary_expression();
+    }
+
+    // Binary operators are parsed by precedence climbing, all of them are left
+    // associative.
+    std::shared_ptr<ast::expression> parse_expression(int min_precedence = 1) {
+        auto left = parse_unary_expression();
+        if (!left) {
+            return nullptr;
+        }
+
+        while (true) {
+            auto op         = m_tokens.front();
+            auto precedence = binary_precedence(op.type);
+            if (precedence == 0 || precedence < min_precedence) {
+                break;
+            }
+            m_tokens = m_tokens.slice(1);
+
+            auto right = parse_expression(precedence + 1);
+            if (!right) {
+                report_user_error(error_type::fatal,
+                                  m_tokens.front().src_info,
+                                  "Expected expression after {}",
+                                  op.content);
+            }
+
+            auto res      = std::make_shared<ast::binary_expression>();
+            res->src_info = op.src_info;
+            res->op       = std::string(op.content);
+            res->left     = std::move(left);
+            res->right    = std::move(right);
+            left          = std::move(res);
+        }
+
+        return left;
+    }
+
+    std::optional<ast::constant> parse_constant() {
+        auto backup = m_tokens;
+        if (!match(token_type::kw_const)) {
+            return {};
+        }
+
+        auto id = parse_id();
+        if (!id) {
+            report_user_error(
+                error_type::fatal, m_tokens.front().src_info, "Expected constant name");
+        }
+
+        if (!match(token_type::colon)) {
+            report_user_error(error_type::fatal,
+                              m_tokens.front().src_info,
+                              "Expected type of constant {}",
+                              *id);
+        }
+
+        auto type = parse_name();
+        if (!type) {
+            report_user_error(error_type::fatal,
+                              m_tokens.front().src_info,
+                              "Expected type of constant {}",
+                              *id);
+        }
+
+        if (!match(token_type::eq)) {
+            report_user_error(error_type::fatal,
+                              m_tokens.front().src_info,
+                              "Expected value of constant {}",
+                              *id);
+        }
+
+        ast::constant res;
+        res.src_info = backup.front().src_info;
+        res.name     = std::move(*id);
+        res.type     = std::move(*type);
+        res.value    = parse_expression();
+
+        if (!res.value || !match(token_type::semicolon)) {
+            report_user_error(error_type::fatal,
+                              m_tokens.front().src_info,
+                              "Expected value of constant {}",
+                              res.name);
+        }
+
+        return res;
+    }
+
+    std::optional<ast::static_assertion> parse_static_assert() {
+        auto backup = m_tokens;
+        if (!match(token_type::kw_static_assert)) {
+            return {};
+        }
+
+        if (!match(token_type::left_parens)) {
+            report_user_error(error_type::fatal,
+                              m_tokens.front().src_info,
+                              "Expected ( after static_assert");
+        }
+
+        ast::static_assertion res;
+        res.src_info = backup.front().src_info;
+        res.body     = parse_expression();
+
+        if (!res.body) {
+            report_user_error(error_type::fatal,
+                              m_tokens.front().src_info,
+                              "Expected static assertion condition");
+        }
+
+        if (match(token_type::comma)) {
+            auto msg = match(token_type::string_literal);
+            if (!msg) {
+                report_user_error(error_type::fatal,
+                                  m_tokens.front().src_info,
+                                  "Expected static assertion message");
+            }
+            auto [tok]        = *msg;
+            res.error_message = std::make_shared<ast::string_literal_expression>(
+                std::string(tok.content.begin() + 1, tok.content.end() - 1));
+            res.error_message->src_info = tok.src_info;
+        }
+
+        if (!match(token_type::right_parens, token_type::semicolon)) {
+            report_user_error(error_type::fatal,
+                              m_tokens.front().src_info,
+                              "Expected ); after static assertion");
+        }
+
+        return res;
+    }
+
     std::optional<ast::element> parse_element() {
+        auto attributes = parse_attributes();
+
         if (auto el = parse_generic_structure()) {
+            el->attributes = std::move(attributes);
             return *el;
         }
 
         if (auto el = parse_structure()) {
+            el->attributes = std::move(attributes);
             return *el;
         }
 
+        if (!attributes.empty()) {
+            report_user_error(error_type::fatal,
+                              attributes.front().src_info,
+                              "Attributes are only supported on structures");
+        }
+
         if (auto el = parse_generic_union()) {
             return *el;
         }
@@ -512,6 +842,14 @@ struct parser {
             return *el;
         }
 
+        if (auto el = parse_constant()) {
+            return *el;
+        }
+
+        if (auto el = parse_static_assert()) {
+            return *el;
+        }
+
         return {};
     }
 
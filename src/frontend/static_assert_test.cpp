@@ -0,0 +1,132 @@
+#include <doctest.h>
+#include <lidl/eval.hpp>
+#include <lidl/loader.hpp>
+#include <lidl/module.hpp>
+#include <sstream>
+
+namespace lidl {
+std::shared_ptr<module_loader> make_frontend_loader(load_context& root,
+                                                    std::istream& file,
+                                                    std::optional<std::string> origin);
+
+namespace {
+std::vector<eval::evaluate_result> evaluate_assertions(std::string_view source) {
+    load_context ctx;
+    std::istringstream in{std::string(source)};
+    auto loader = make_frontend_loader(ctx, in, {});
+    loader->load();
+
+    auto& mod = loader->get_module();
+    std::vector<eval::evaluate_result> res;
+    for (auto& assertion : mod.static_assertions) {
+        res.push_back(eval::evaluate_expression(mod, *assertion.condition));
+    }
+    return res;
+}
+
+TEST_CASE("static assertions can query layouts and enums") {
+    auto res = evaluate_assertions(R"__(
+enum color {
+    red,
+    green,
+    blue,
+}
+
+struct header {
+    id: u32;
+    kind: color;
+    name: string;
+}
+
+static_assert(sizeof(header) == 8, "header grew");
+static_assert(alignof(header));
+static_assert(color::blue - color::red);
+static_assert(color::green == color::green && color::green != color::blue);
+static_assert(sizeof(array<u16, 3>) + alignof(u64));
+)__");
+
+    REQUIRE_EQ(5, res.size());
+    REQUIRE(std::get<eval::value>(res[0]).as_bool());
+    REQUIRE_EQ(4, std::get<eval::value>(res[1]).as_integral());
+    REQUIRE_EQ(2, std::get<eval::value>(res[2]).as_integral());
+    REQUIRE(std::get<eval::value>(res[3]).as_bool());
+    REQUIRE_EQ(14, std::get<eval::value>(res[4]).as_integral());
+}
+
+TEST_CASE("constant expressions follow C++ precedence") {
+    auto res = evaluate_assertions(R"__(
+static_assert(1 + 2 * 3);
+static_assert(-(3 + 4) * 2 % 5);
+static_assert(10 - 4 - 3);
+static_assert(1 < 2 == 3 > 2);
+static_assert(false || true && !false);
+static_assert(1.5 * 2);
+)__");
+
+    REQUIRE_EQ(6, res.size());
+    REQUIRE_EQ(7, std::get<eval::value>(res[0]).as_integral());
+    REQUIRE_EQ(-4, std::get<eval::value>(res[1]).as_integral());
+    REQUIRE_EQ(3, std::get<eval::value>(res[2]).as_integral());
+    REQUIRE(std::get<eval::value>(res[3]).as_bool());
+    REQUIRE(std::get<eval::value>(res[4]).as_bool());
+    REQUIRE_EQ(3.0, std::get<eval::value>(res[5]).as_double());
+}
+
+TEST_CASE("invalid constant expressions are errors") {
+    auto res = evaluate_assertions(R"__(
+static_assert(1 / 0);
+static_assert(9223372036854775807 + 1);
+static_assert(1 + true);
+static_assert(false || 1 == 1 && 2);
+)__");
+
+    REQUIRE_EQ(4, res.size());
+    for (auto& r : res) {
+        REQUIRE(std::holds_alternative<eval::common_errors>(r));
+    }
+}
+
+TEST_CASE("constants are converted to their types") {
+    auto res = evaluate_assertions(R"__(
+enum color {
+    red,
+    green,
+}
+
+const line: u32 = 64;
+const lines: i32 = line * 4;
+const ratio: f64 = 3;
+const fav: color = color::green;
+
+static_assert(lines);
+static_assert(ratio);
+static_assert(fav == color::green);
+)__");
+
+    REQUIRE_EQ(3, res.size());
+    REQUIRE_EQ(256, std::get<eval::value>(res[0]).as_integral());
+    REQUIRE_EQ(3.0, std::get<eval::value>(res[1]).as_double());
+    REQUIRE(std::get<eval::value>(res[2]).as_bool());
+}
+
+TEST_CASE("constants that don't fit their types are errors") {
+    auto res = evaluate_assertions(R"__(
+const small: u8 = 256;
+const negative: u32 = -1;
+const flag: bool = 1;
+const a: i32 = b;
+const b: i32 = a;
+
+static_assert(small);
+static_assert(negative);
+static_assert(flag);
+static_assert(a);
+)__");
+
+    REQUIRE_EQ(4, res.size());
+    for (auto& r : res) {
+        REQUIRE(std::holds_alternative<eval::common_errors>(r));
+    }
+}
+} // namespace
+} // namespace lidl
@@ -10,11 +10,41 @@
 #include <stdexcept>
 
 namespace lidl {
+instance_based_wire_type::cached_instance&
+instance_based_wire_type::get_cached(const module& mod, const name& instantiation) const {
+    auto [it, inserted] = m_instances.try_emplace(instance_key{&mod, instantiation});
+    if (inserted) {
+        try {
+            it->second.type = instantiate(mod, instantiation);
+        } catch (...) {
+            m_instances.erase(it);
+            throw;
+        }
+    }
+    return it->second;
+}
+
+const wire_type& instance_based_wire_type::get_instance(const module& mod,
+                                                        const name& instantiation) const {
+    return *get_cached(mod, instantiation).type;
+}
+
+raw_layout instance_based_wire_type::wire_layout(const module& mod,
+                                                 const name& instantiation) const {
+    auto& cached = get_cached(mod, instantiation);
+    if (!cached.layout) {
+        cached.layout = cached.type->wire_layout(mod);
+    }
+    return *cached.layout;
+}
+
 std::unique_ptr<wire_type> generic_structure::instantiate(const module& mod,
                                                           const name& ins) const {
     auto newstr = std::make_unique<structure>(const_cast<module*>(&mod), src_info);
 
     auto& genstr = dynamic_cast<const generic_structure&>(*get_symbol(ins.base));
+    newstr->set_reorder_members(genstr.struct_->reorder_members());
+    newstr->set_alignment(genstr.struct_->alignment());
 
     std::unordered_map<std::string_view, name> actual;
     int index = 0;
@@ -31,7 +61,8 @@ std::unique_ptr<wire_type> generic_structure::instantiate(const module& mod,
             // Generic parameters are forward declarations.
             // If a member does not have a forward declared type, we can safely skip it.
             member new_mem(newstr.get());
-            new_mem.type_ = mem.type_;
+            new_mem.type_     = mem.type_;
+            new_mem.alignment = mem.alignment;
             newstr->add_member(std::string(member_name), std::move(new_mem));
             continue;
         }
@@ -44,7 +75,8 @@ std::unique_ptr<wire_type> generic_structure::instantiate(const module& mod,
         }
 
         member new_mem(newstr.get());
-        new_mem.type_ = it->second;
+        new_mem.type_     = it->second;
+        new_mem.alignment = mem.alignment;
         newstr->add_member(std::string(member_name), std::move(new_mem));
     }
 
@@ -125,16 +157,28 @@ raw_layout generic_wire_type_instantiation::wire_layout(const module& mod) const
 }
 
 YAML::Node generic_wire_type_instantiation::bin2yaml(const module& module,
-                                                     ibinary_reader& reader) const {
+                                                     binary_reader& reader) const {
     return this->get_generic()->bin2yaml(module, args, reader);
 }
 
 int generic_wire_type_instantiation::yaml2bin(const module& mod,
                                               const YAML::Node& node,
-                                              ibinary_writer& writer) const {
+                                              binary_writer& writer) const {
     return this->get_generic()->yaml2bin(mod, args, node, writer);
 }
 
+void generic_wire_type_instantiation::bin2json(const module& module,
+                                               binary_reader& reader,
+                                               json_writer& writer) const {
+    this->get_generic()->bin2json(module, args, reader, writer);
+}
+
+int generic_wire_type_instantiation::json2bin(const module& mod,
+                                              const json_value& value,
+                                              binary_writer& writer) const {
+    return this->get_generic()->json2bin(mod, args, value, writer);
+}
+
 type_categories generic_reference_type::category(const module& mod,
                                                  const name& instantiation) const {
     return type_categories::reference;
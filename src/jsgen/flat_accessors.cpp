@@ -0,0 +1,70 @@
+#include "jsgen.hpp"
+
+#include <fmt/format.h>
+#include <lidl/basic_types.hpp>
+
+namespace lidl::js {
+namespace {
+// Name of the DataView accessors for a basic type, e.g. Uint16 for getUint16.
+std::optional<std::string> data_view_type(const wire_type& t) {
+    if (dynamic_cast<const float_type*>(&t)) {
+        return "Float32";
+    }
+    if (dynamic_cast<const double_type*>(&t)) {
+        return "Float64";
+    }
+    if (auto integral = dynamic_cast<const integral_type*>(&t)) {
+        // 64 bit accessors read and write bigints, as in getBigUint64.
+        auto bits = integral->size_in_bits;
+        return fmt::format("{}{}{}",
+                           bits == 64 ? "Big" : "",
+                           integral->is_unsigned ? "Uint" : "Int",
+                           bits);
+    }
+    return std::nullopt;
+}
+} // namespace
+
+std::optional<std::string> generate_flat_accessors(const module& mod,
+                                                   std::string_view mem_name,
+                                                   const name& type,
+                                                   int offset) {
+    auto wire = get_wire_type(mod, type);
+    if (!wire) {
+        return std::nullopt;
+    }
+
+    if (dynamic_cast<const bool_type*>(wire)) {
+        constexpr auto format = R"__(get {mem_name}() {{
+            return this.dataView().getUint8({offset}) != 0;
+        }}
+
+        set {mem_name}(val) {{
+            this.dataView().setUint8({offset}, val ? 1 : 0);
+        }})__";
+
+        return fmt::format(format, fmt::arg("mem_name", mem_name), fmt::arg("offset", offset));
+    }
+
+    auto accessor = data_view_type(*wire);
+    if (!accessor) {
+        return std::nullopt;
+    }
+
+    constexpr auto format = R"__(get {mem_name}() {{
+            return this.dataView().get{type}({offset}{endian});
+        }}
+
+        set {mem_name}(val) {{
+            this.dataView().set{type}({offset}, val{endian});
+        }})__";
+
+    // The single byte accessors take no endianness.
+    auto single_byte = wire->wire_layout(mod).size() == 1;
+    return fmt::format(format,
+                       fmt::arg("mem_name", mem_name),
+                       fmt::arg("type", *accessor),
+                       fmt::arg("offset", offset),
+                       fmt::arg("endian", single_byte ? "" : ", true"));
+}
+} // namespace lidl::js
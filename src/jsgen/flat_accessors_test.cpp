@@ -0,0 +1,58 @@
+#include "jsgen.hpp"
+#include "lidl/module.hpp"
+
+#include <doctest.h>
+
+namespace lidl::js {
+namespace {
+std::string accessors_of(const module& m, std::string_view type) {
+    auto res =
+        generate_flat_accessors(m, "x", name{m.symbols().name_lookup(type).value()}, 4);
+    REQUIRE(res);
+    return *res;
+}
+
+void require_accessors(const module& m, std::string_view type, std::string_view method) {
+    auto accessors = accessors_of(m, type);
+    CAPTURE(accessors);
+    REQUIRE_NE(std::string::npos, accessors.find(fmt::format("get{}(4", method)));
+    REQUIRE_NE(std::string::npos, accessors.find(fmt::format("set{}(4, val", method)));
+}
+
+TEST_CASE("flat accessors use the DataView methods of basic types") {
+    auto basic_module = lidl::basic_module();
+    auto& m           = *basic_module;
+
+    require_accessors(m, "u8", "Uint8");
+    require_accessors(m, "i8", "Int8");
+    require_accessors(m, "u16", "Uint16");
+    require_accessors(m, "i16", "Int16");
+    require_accessors(m, "u32", "Uint32");
+    require_accessors(m, "i32", "Int32");
+    require_accessors(m, "u64", "BigUint64");
+    require_accessors(m, "i64", "BigInt64");
+    require_accessors(m, "f32", "Float32");
+    require_accessors(m, "f64", "Float64");
+    require_accessors(m, "bool", "Uint8");
+}
+
+TEST_CASE("flat accessors are little endian") {
+    auto basic_module = lidl::basic_module();
+    auto& m           = *basic_module;
+
+    REQUIRE_NE(std::string::npos, accessors_of(m, "u16").find("getUint16(4, true)"));
+    REQUIRE_NE(std::string::npos,
+               accessors_of(m, "f64").find("setFloat64(4, val, true)"));
+    // Single bytes have no endianness.
+    REQUIRE_NE(std::string::npos, accessors_of(m, "i8").find("getInt8(4)"));
+}
+
+TEST_CASE("only basic types have flat accessors") {
+    auto basic_module = lidl::basic_module();
+    auto& m           = *basic_module;
+
+    auto string_name = name{m.symbols().name_lookup("string").value()};
+    REQUIRE_FALSE(generate_flat_accessors(m, "x", string_name, 0));
+}
+} // namespace
+} // namespace lidl::js
@@ -3,9 +3,28 @@
 #include <fmt/format.h>
 #include <lidl/module.hpp>
 #include <lidl/types.hpp>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace lidl::js {
+/**
+ * Estimates the size of a message with a t at its root: the size of t and of every
+ * object it points to, counting strings and vectors as empty. Builders are allocated
+ * with at least this much space, so most messages are built without growing.
+ */
+int size_hint(const module& mod, const wire_type& t);
+
+/**
+ * Generates a getter and setter for a member of a basic type that read it straight from
+ * the object's DataView at the given offset, rather than through a member object.
+ * Returns nothing for members of other types.
+ */
+std::optional<std::string> generate_flat_accessors(const module& mod,
+                                                   std::string_view mem_name,
+                                                   const name& type,
+                                                   int offset);
+
 inline std::string generate_layout_getter(const module& mod, const wire_type& t) {
     auto layout = t.wire_layout(mod);
 
@@ -16,9 +35,15 @@ inline std::string generate_layout_getter(const module& mod, const wire_type& t)
             alignment: {align}
         }};
     }}
+
+    size_hint(): number {{
+        return {hint};
+    }}
 )__";
 
-    return fmt::format(
-        format, fmt::arg("size", layout.size()), fmt::arg("align", layout.alignment()));
+    return fmt::format(format,
+                       fmt::arg("size", layout.size()),
+                       fmt::arg("align", layout.alignment()),
+                       fmt::arg("hint", size_hint(mod, t)));
 }
 } // namespace lidl::js
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "jsgen.hpp"
+
+#include <algorithm>
+#include <lidl/structure.hpp>
+#include <lidl/union.hpp>
+
+namespace lidl::js {
+namespace {
+// Recursive types would otherwise never end, and deep ones are rare enough that the
+// builder growing for them is fine.
+constexpr int max_hint_depth = 4;
+
+int out_of_line_size(const module& mod, const wire_type& t, int depth);
+
+int out_of_line_size(const module& mod, const name& n, int depth) {
+    auto wire_name = get_wire_type_name(mod, n);
+    if (!is_ptr(mod, wire_name)) {
+        auto wire = get_wire_type(mod, wire_name);
+        return wire ? out_of_line_size(mod, *wire, depth) : 0;
+    }
+
+    auto& pointee_name = deref_ptr(mod, wire_name);
+    auto pointee       = get_wire_type(mod, pointee_name);
+    if (!pointee) {
+        return 0;
+    }
+    return pointee->wire_layout(mod).size() +
+           out_of_line_size(mod, *pointee, depth + 1);
+}
+
+int out_of_line_size(const module& mod, const wire_type& t, int depth) {
+    if (depth > max_hint_depth) {
+        return 0;
+    }
+
+    if (auto str = dynamic_cast<const structure*>(&t)) {
+        int total = 0;
+        for (auto& [_, mem] : str->all_members()) {
+            total += out_of_line_size(mod, mem.type_, depth + 1);
+        }
+        return total;
+    }
+
+    if (auto u = dynamic_cast<const union_type*>(&t)) {
+        // Only one alternative is ever stored.
+        int largest = 0;
+        for (auto& [_, mem] : u->all_members()) {
+            largest = std::max(largest, out_of_line_size(mod, mem->type_, depth + 1));
+        }
+        return largest;
+    }
+
+    return 0;
+}
+} // namespace
+
+int size_hint(const module& mod, const wire_type& t) {
+    return t.wire_layout(mod).size() + out_of_line_size(mod, t, 0);
+}
+} // namespace lidl::js
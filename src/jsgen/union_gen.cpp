@@ -70,7 +70,11 @@ export class {name} extends {struct_base} {{
 std::string union_gen::generate_member(std::string_view mem_name, const member& mem) {
     auto mem_type = get_wire_type(mod(), mem.type_);
     if (mem_type->is_value(mod())) {
-        // This is a basic type
+        auto offset = get().layout(mod()).offset_of("val").value();
+        if (auto flat = generate_flat_accessors(mod(), mem_name, mem.type_, offset); flat) {
+            return *flat;
+        }
+
         constexpr auto format = R"__(get {mem_name}() {{
             return this.member_by_name("{mem_name}").value;
         }}
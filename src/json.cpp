@@ -0,0 +1,489 @@
+#include <charconv>
+#include <cmath>
+#include <lidl/json.hpp>
+
+namespace lidl {
+namespace {
+constexpr char hex_digits[] = "0123456789abcdef";
+
+template<class T>
+void append_number(std::string& out, T t) {
+    char buf[32];
+    auto res = std::to_chars(std::begin(buf), std::end(buf), t);
+    out.append(buf, res.ptr);
+}
+
+void append_utf8(std::string& out, uint32_t code_point) {
+    if (code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+uint32_t parse_hex4(std::string_view str) {
+    uint32_t res = 0;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + 4, res, 16);
+    if (ec != std::errc{} || ptr != str.data() + 4) {
+        throw json_error("Invalid unicode escape in JSON string");
+    }
+    return res;
+}
+
+template<class T>
+T parse_number(std::string_view text) {
+    T res{};
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), res);
+    if (ec != std::errc{} || ptr != text.data() + text.size()) {
+        throw json_error(fmt::format("\"{}\" is not a valid number here", text));
+    }
+    return res;
+}
+} // namespace
+
+class json_document::parser {
+public:
+    parser(std::string_view text, std::vector<token>& tokens)
+        : m_text{text}
+        , m_tokens{tokens} {
+    }
+
+    void parse() {
+        parse_value(0);
+        skip_whitespace();
+        if (m_pos != m_text.size()) {
+            fail("Trailing characters after JSON value");
+        }
+    }
+
+private:
+    // Bounds the recursion so that malicious inputs can't overflow the stack.
+    static constexpr int max_depth = 256;
+
+    [[noreturn]] void fail(std::string_view message) const {
+        throw json_error(fmt::format("{} at offset {}", message, m_pos));
+    }
+
+    void skip_whitespace() {
+        while (m_pos < m_text.size()) {
+            switch (m_text[m_pos]) {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                ++m_pos;
+                continue;
+            }
+            return;
+        }
+    }
+
+    char peek() {
+        skip_whitespace();
+        if (m_pos == m_text.size()) {
+            fail("Unexpected end of JSON text");
+        }
+        return m_text[m_pos];
+    }
+
+    void expect(char c) {
+        if (peek() != c) {
+            fail(fmt::format("Expected '{}'", c));
+        }
+        ++m_pos;
+    }
+
+    uint32_t push(json_kind kind, std::string_view text = {}, bool escaped = false) {
+        auto index = static_cast<uint32_t>(m_tokens.size());
+        m_tokens.push_back(token{
+            .kind = kind, .escaped = escaped, .next = index + 1, .size = 0, .text = text});
+        return index;
+    }
+
+    void parse_value(int depth) {
+        if (depth > max_depth) {
+            fail("JSON nested too deeply");
+        }
+
+        switch (peek()) {
+        case '{':
+            return parse_object(depth);
+        case '[':
+            return parse_array(depth);
+        case '"':
+            return parse_string();
+        case 't':
+            return parse_literal("true", json_kind::boolean);
+        case 'f':
+            return parse_literal("false", json_kind::boolean);
+        case 'n':
+            return parse_literal("null", json_kind::null);
+        default:
+            return parse_number();
+        }
+    }
+
+    void parse_object(int depth) {
+        auto index = push(json_kind::object);
+        ++m_pos;
+
+        uint32_t size = 0;
+        if (peek() != '}') {
+            while (true) {
+                if (peek() != '"') {
+                    fail("Expected a string key");
+                }
+                parse_string();
+                expect(':');
+                parse_value(depth + 1);
+                ++size;
+
+                if (peek() == ',') {
+                    ++m_pos;
+                    continue;
+                }
+                break;
+            }
+        }
+        expect('}');
+
+        m_tokens[index].size = size;
+        m_tokens[index].next = static_cast<uint32_t>(m_tokens.size());
+    }
+
+    void parse_array(int depth) {
+        auto index = push(json_kind::array);
+        ++m_pos;
+
+        uint32_t size = 0;
+        if (peek() != ']') {
+            while (true) {
+                parse_value(depth + 1);
+                ++size;
+
+                if (peek() == ',') {
+                    ++m_pos;
+                    continue;
+                }
+                break;
+            }
+        }
+        expect(']');
+
+        m_tokens[index].size = size;
+        m_tokens[index].next = static_cast<uint32_t>(m_tokens.size());
+    }
+
+    void parse_string() {
+        auto begin   = ++m_pos;
+        bool escaped = false;
+        while (true) {
+            auto end = m_text.find_first_of("\"\\", m_pos);
+            if (end == m_text.npos) {
+                fail("Unterminated JSON string");
+            }
+            m_pos = end + 1;
+            if (m_text[end] == '"') {
+                push(json_kind::string, m_text.substr(begin, end - begin), escaped);
+                return;
+            }
+            // Skip the escaped character, the escape itself is validated on use.
+            escaped = true;
+            ++m_pos;
+        }
+    }
+
+    void parse_literal(std::string_view literal, json_kind kind) {
+        if (m_text.substr(m_pos, literal.size()) != literal) {
+            fail("Invalid JSON literal");
+        }
+        push(kind, literal);
+        m_pos += literal.size();
+    }
+
+    void parse_number() {
+        auto begin = m_pos;
+        while (m_pos < m_text.size()) {
+            auto c = m_text[m_pos];
+            if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' ||
+                c == 'E') {
+                ++m_pos;
+                continue;
+            }
+            break;
+        }
+        if (begin == m_pos) {
+            fail("Unexpected character in JSON text");
+        }
+        push(json_kind::number, m_text.substr(begin, m_pos - begin));
+    }
+
+    std::string_view m_text;
+    size_t m_pos = 0;
+    std::vector<token>& m_tokens;
+};
+
+void json_writer::begin_object() {
+    separate();
+    m_out->push_back('{');
+    m_need_comma = false;
+}
+
+void json_writer::end_object() {
+    m_out->push_back('}');
+    m_need_comma = true;
+}
+
+void json_writer::begin_array() {
+    separate();
+    m_out->push_back('[');
+    m_need_comma = false;
+}
+
+void json_writer::end_array() {
+    m_out->push_back(']');
+    m_need_comma = true;
+}
+
+void json_writer::key(std::string_view key) {
+    separate();
+    write_string(key);
+    m_out->push_back(':');
+    m_need_comma = false;
+}
+
+void json_writer::value(std::string_view str) {
+    separate();
+    write_string(str);
+    m_need_comma = true;
+}
+
+void json_writer::value(bool b) {
+    separate();
+    m_out->append(b ? "true" : "false");
+    m_need_comma = true;
+}
+
+void json_writer::value(int64_t i) {
+    separate();
+    append_number(*m_out, i);
+    m_need_comma = true;
+}
+
+void json_writer::value(uint64_t i) {
+    separate();
+    append_number(*m_out, i);
+    m_need_comma = true;
+}
+
+void json_writer::value(float f) {
+    // JSON has no representation for infinities and NaNs.
+    if (!std::isfinite(f)) {
+        return null();
+    }
+    separate();
+    append_number(*m_out, f);
+    m_need_comma = true;
+}
+
+void json_writer::value(double d) {
+    if (!std::isfinite(d)) {
+        return null();
+    }
+    separate();
+    append_number(*m_out, d);
+    m_need_comma = true;
+}
+
+void json_writer::null() {
+    separate();
+    m_out->append("null");
+    m_need_comma = true;
+}
+
+void json_writer::write_string(std::string_view str) {
+    m_out->push_back('"');
+    auto begin = str.begin();
+    for (auto it = str.begin(); it != str.end(); ++it) {
+        auto c = static_cast<unsigned char>(*it);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        m_out->append(begin, it);
+        begin = it + 1;
+
+        m_out->push_back('\\');
+        switch (c) {
+        case '"':
+        case '\\':
+            m_out->push_back(c);
+            break;
+        case '\n':
+            m_out->push_back('n');
+            break;
+        case '\r':
+            m_out->push_back('r');
+            break;
+        case '\t':
+            m_out->push_back('t');
+            break;
+        default:
+            m_out->append("u00");
+            m_out->push_back(hex_digits[c >> 4]);
+            m_out->push_back(hex_digits[c & 0xF]);
+        }
+    }
+    m_out->append(begin, str.end());
+    m_out->push_back('"');
+}
+
+json_document json_document::parse(std::string_view text) {
+    json_document doc;
+    parser(text, doc.m_tokens).parse();
+    return doc;
+}
+
+size_t json_value::size() const {
+    if (!is_object() && !is_array()) {
+        throw json_error("Expected a JSON object or array");
+    }
+    return m_doc->m_tokens[m_index].size;
+}
+
+bool json_value::key_equals(uint32_t index, std::string_view key) const {
+    auto& tok = m_doc->m_tokens[index];
+    if (!tok.escaped) {
+        return tok.text == key;
+    }
+    return json_value{m_doc, index}.as_string() == key;
+}
+
+std::optional<json_value> json_value::find(std::string_view key) const {
+    if (!is_object()) {
+        throw json_error("Expected a JSON object");
+    }
+    auto end = next_sibling(m_index);
+    for (auto i = first_child(); i != end;) {
+        auto val = i + 1;
+        if (key_equals(i, key)) {
+            return json_value{m_doc, val};
+        }
+        i = next_sibling(val);
+    }
+    return std::nullopt;
+}
+
+json_value json_value::operator[](std::string_view key) const {
+    if (auto res = find(key)) {
+        return *res;
+    }
+    throw json_error(fmt::format("Missing member \"{}\"", key));
+}
+
+bool json_value::as_bool() const {
+    if (kind() != json_kind::boolean) {
+        throw json_error("Expected a boolean");
+    }
+    return m_doc->m_tokens[m_index].text == "true";
+}
+
+int64_t json_value::as_int() const {
+    if (kind() != json_kind::number) {
+        throw json_error("Expected a number");
+    }
+    return parse_number<int64_t>(m_doc->m_tokens[m_index].text);
+}
+
+uint64_t json_value::as_uint() const {
+    if (kind() != json_kind::number) {
+        throw json_error("Expected a number");
+    }
+    return parse_number<uint64_t>(m_doc->m_tokens[m_index].text);
+}
+
+double json_value::as_double() const {
+    if (kind() != json_kind::number) {
+        throw json_error("Expected a number");
+    }
+    return parse_number<double>(m_doc->m_tokens[m_index].text);
+}
+
+std::string json_value::as_string() const {
+    auto& tok = m_doc->m_tokens[m_index];
+    if (tok.kind != json_kind::string) {
+        throw json_error("Expected a string");
+    }
+
+    if (!tok.escaped) {
+        return std::string(tok.text);
+    }
+
+    std::string res;
+    res.reserve(tok.text.size());
+    auto text = tok.text;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '\\') {
+            res.push_back(text[i]);
+            continue;
+        }
+
+        if (++i == text.size()) {
+            throw json_error("Invalid escape in JSON string");
+        }
+
+        switch (text[i]) {
+        case '"':
+        case '\\':
+        case '/':
+            res.push_back(text[i]);
+            break;
+        case 'b':
+            res.push_back('\b');
+            break;
+        case 'f':
+            res.push_back('\f');
+            break;
+        case 'n':
+            res.push_back('\n');
+            break;
+        case 'r':
+            res.push_back('\r');
+            break;
+        case 't':
+            res.push_back('\t');
+            break;
+        case 'u': {
+            if (text.size() - i < 5) {
+                throw json_error("Invalid unicode escape in JSON string");
+            }
+            auto code_point = parse_hex4(text.substr(i + 1));
+            i += 4;
+            if (code_point >= 0xD800 && code_point < 0xDC00 && text.size() - i >= 7 &&
+                text.substr(i + 1, 2) == "\\u") {
+                auto low = parse_hex4(text.substr(i + 3));
+                if (low >= 0xDC00 && low < 0xE000) {
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+            }
+            append_utf8(res, code_point);
+            break;
+        }
+        default:
+            throw json_error("Invalid escape in JSON string");
+        }
+    }
+    return res;
+}
+} // namespace lidl
@@ -0,0 +1,160 @@
+#include <doctest.h>
+#include <lidl/json.hpp>
+#include <lidl/module.hpp>
+#include <lidl/structure.hpp>
+#include <lidl/union.hpp>
+
+namespace lidl {
+namespace {
+TEST_CASE("json writer") {
+    std::string out;
+    json_writer writer(out);
+    writer.begin_object();
+    writer.key("a");
+    writer.value(int64_t(-3));
+    writer.key("b");
+    writer.begin_array();
+    writer.value(true);
+    writer.value("x\"y\n");
+    writer.null();
+    writer.end_array();
+    writer.key("c");
+    writer.begin_object();
+    writer.end_object();
+    writer.end_object();
+    REQUIRE_EQ(R"({"a":-3,"b":[true,"x\"y\n",null],"c":{}})", out);
+}
+
+TEST_CASE("json document") {
+    auto doc  = json_document::parse(R"( {"a": [1, {"b": 2}, "ç"], "c": false} )");
+    auto root = doc.root();
+    REQUIRE(root.is_object());
+    REQUIRE_EQ(2, root.size());
+    REQUIRE_EQ(false, root["c"].as_bool());
+    REQUIRE_FALSE(root.find("d"));
+
+    auto arr = root["a"];
+    REQUIRE_EQ(3, arr.size());
+
+    std::vector<json_kind> kinds;
+    arr.for_each_element([&](const json_value& elem) { kinds.push_back(elem.kind()); });
+    REQUIRE_EQ(std::vector{json_kind::number, json_kind::object, json_kind::string},
+               kinds);
+
+    REQUIRE_THROWS_AS(json_document::parse(R"({"a": 1)"), json_error);
+    REQUIRE_THROWS_AS(json_document::parse("[1] 2"), json_error);
+}
+
+TEST_CASE("json round trip through a structure") {
+    auto root_module = std::make_unique<module>();
+    root_module->add_child("", basic_module());
+    auto& mod = root_module->get_child("test");
+
+    auto lookup = [&](std::string_view name) {
+        return recursive_full_name_lookup(mod.symbols(), name).value();
+    };
+
+    structure str;
+    str.add_member("a", member{name{lookup("i8")}});
+    str.add_member("b", member{name{lookup("i32")}});
+    str.add_member("c", member{name{lookup("string")}});
+    str.add_member("d", member{name{lookup("vector"), {name{lookup("u16")}}}});
+    str.add_member("e", member{name{lookup("f64")}});
+    str.add_member("f", member{name{lookup("array"), {name{lookup("u16")}, int64_t(3)}}});
+
+    auto text =
+        R"({"a":-5,"b":100000,"c":"hello","d":[1,2,65535],"e":0.25,"f":[7,8,9]})";
+    auto doc  = json_document::parse(text);
+
+    binary_writer writer;
+    str.json2bin(mod, doc.root(), writer);
+
+    binary_reader reader(writer.get());
+    reader.seek(-str.wire_layout(mod).size());
+
+    std::string out;
+    json_writer json(out);
+    str.bin2json(mod, reader, json);
+    REQUIRE_EQ(text, out);
+}
+
+TEST_CASE("json round trip through a union with mixed alignments") {
+    auto root_module = std::make_unique<module>();
+    root_module->add_child("", basic_module());
+    auto& mod = root_module->get_child("test");
+
+    auto lookup = [&](std::string_view name) {
+        return recursive_full_name_lookup(mod.symbols(), name).value();
+    };
+
+    union_type u(&mod);
+    u.add_member("a", member{name{lookup("u8")}, &u});
+    u.add_member("b", member{name{lookup("u64")}, &u});
+    u.add_member("c", member{name{lookup("u16")}, &u});
+
+    // The discriminator, then every alternative at the offset of the largest one.
+    REQUIRE_EQ(raw_layout{16, 8}, u.wire_layout(mod));
+    REQUIRE_EQ(8, u.layout(mod).offset_of("val"));
+
+    for (auto text : {R"({"a":5})", R"({"b":1234567890123})", R"({"c":65535})"}) {
+        auto doc = json_document::parse(text);
+
+        binary_writer writer;
+        u.json2bin(mod, doc.root(), writer);
+        REQUIRE_EQ(16, writer.get().size());
+
+        binary_reader reader(writer.get());
+        reader.seek(-16);
+
+        std::string out;
+        json_writer json(out);
+        u.bin2json(mod, reader, json);
+        REQUIRE_EQ(text, out);
+    }
+
+    // An image laid out by the C++ runtime.
+    std::array<uint8_t, 16> image{};
+    image[8] = 5;
+    binary_reader reader(image);
+    reader.seek(-16);
+    std::string out;
+    json_writer json(out);
+    u.bin2json(mod, reader, json);
+    REQUIRE_EQ(R"({"a":5})", out);
+}
+
+TEST_CASE("yaml2bin of a structure with bool members") {
+    auto root_module = std::make_unique<module>();
+    root_module->add_child("", basic_module());
+    auto& mod = root_module->get_child("test");
+
+    auto lookup = [&](std::string_view name) {
+        return recursive_full_name_lookup(mod.symbols(), name).value();
+    };
+
+    structure str(&mod);
+    str.add_member("f", member{name{lookup("bool")}, &str});
+    str.add_member("y", member{name{lookup("i32")}, &str});
+    str.add_member("g", member{name{lookup("bool")}, &str});
+    str.add_member("z", member{name{lookup("u16")}, &str});
+
+    // Like the default message the C++ backend prebuilds for create_default.
+    YAML::Node node;
+    node["f"] = true;
+    node["y"] = 2;
+    node["g"] = false;
+    node["z"] = 7;
+
+    binary_writer writer;
+    str.yaml2bin(mod, node, writer);
+    REQUIRE_EQ(12, writer.get().size());
+
+    binary_reader reader(writer.get());
+    reader.seek(-str.wire_layout(mod).size());
+    std::string out;
+    json_writer json(out);
+    str.bin2json(mod, reader, json);
+    REQUIRE_EQ(R"({"f":true,"y":2,"g":false,"z":7})", out);
+}
+} // namespace
+} // namespace lidl
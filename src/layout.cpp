@@ -12,17 +12,21 @@ size_t pad_to(size_t current, size_t needed_alignment) {
 } // namespace
 
 compound_layout& compound_layout::add_member(std::string_view member_name,
-                                             const raw_layout& member_layout) {
+                                             const raw_layout& member_layout,
+                                             size_t min_alignment) {
     if (offset_of(member_name)) {
         throw std::runtime_error("Member already exists!");
     }
 
+    auto member_alignment =
+        std::max<size_t>(member_layout.alignment(), std::max<size_t>(1, min_alignment));
+
     // The overall alignment of the compound type.
     auto align_to =
-        std::lcm(std::max<int>(1, m_current.alignment()), member_layout.alignment());
+        std::lcm(std::max<size_t>(1, m_current.alignment()), member_alignment);
 
     // Align the beginning address of the new member to the correct alignment
-    auto padding = pad_to(m_current.size() - m_padding, member_layout.alignment());
+    auto padding = pad_to(m_current.size() - m_padding, member_alignment);
 
     auto member_offset = m_current.size() - m_padding + padding;
 
@@ -35,10 +39,34 @@ compound_layout& compound_layout::add_member(std::string_view member_name,
     m_padding = new_padding;
 
     m_offsets.emplace(std::string(member_name), member_offset);
+    m_members.push_back(member_entry{std::string(member_name),
+                                     member_offset,
+                                     size_t(member_layout.size()),
+                                     member_alignment,
+                                     padding});
 
     return *this;
 }
 
+compound_layout& compound_layout::align_to(size_t alignment) {
+    auto new_alignment = std::lcm(std::max<size_t>(1, m_current.alignment()),
+                                  std::max<size_t>(1, alignment));
+    auto extra_padding = pad_to(m_current.size(), new_alignment);
+
+    m_current = raw_layout{m_current.size() + extra_padding, new_alignment};
+    m_padding += extra_padding;
+
+    return *this;
+}
+
+size_t compound_layout::padding_bytes() const {
+    size_t used = 0;
+    for (auto& mem : m_members) {
+        used += mem.size;
+    }
+    return m_current.size() - used;
+}
+
 std::optional<size_t> compound_layout::offset_of(std::string_view member_name) const {
     auto it = m_offsets.find(std::string(member_name));
     if (it == m_offsets.end()) {
@@ -0,0 +1,134 @@
+#include <fmt/format.h>
+#include <lidl/module.hpp>
+
+namespace lidl {
+namespace {
+template<class FnT>
+void for_each_structure(const module& mod, const FnT& fn) {
+    for (auto& [_, child] : mod.children) {
+        for_each_structure(*child, fn);
+    }
+
+    for (auto& serv : mod.services) {
+        for (auto& [name, proc] : serv->own_procedures()) {
+            fn(proc->params_struct(mod));
+            fn(proc->results_struct(mod));
+        }
+    }
+
+    for (auto& str : mod.structs) {
+        fn(*str);
+    }
+
+    for (auto& str : mod.generic_structs) {
+        fn(*str->struct_);
+    }
+}
+} // namespace
+
+void enable_member_reordering(const module& mod) {
+    for_each_structure(mod, [](const structure& str) {
+        const_cast<structure&>(str).set_reorder_members(true);
+    });
+}
+
+std::vector<reorder_report> report_member_reordering(const module& mod) {
+    std::vector<reorder_report> res;
+    for_each_structure(mod, [&](const structure& str) {
+        if (!str.reorder_members() || str.is_generic()) {
+            return;
+        }
+        auto sym = recursive_definition_lookup(root_module(mod).get_scope(), &str);
+        if (!sym) {
+            return;
+        }
+        res.push_back(reorder_report{
+            fmt::format("{}", fmt::join(absolute_name(*sym), "::")),
+            size_t(str.declaration_order_layout(mod).get().size()),
+            size_t(str.layout(mod).get().size())});
+    });
+    return res;
+}
+
+void split_cold_members(module& mod, structure& str, std::string_view struct_name) {
+    auto& all_members = str.own_members();
+    if (std::none_of(all_members.begin(), all_members.end(), [](auto& mem) {
+            return mem.second.cold;
+        })) {
+        return;
+    }
+
+    auto cold_name = fmt::format("{}_cold", struct_name);
+    if (mod.symbols().name_lookup(cold_name)) {
+        report_user_error(error_type::fatal,
+                          str.src_info,
+                          "Can't split the cold members of {}, {} already exists",
+                          struct_name,
+                          cold_name);
+    }
+
+    if (std::any_of(all_members.begin(), all_members.end(), [](auto& mem) {
+            return mem.first == "cold";
+        })) {
+        report_user_error(error_type::fatal,
+                          str.src_info,
+                          "Can't split the cold members of {}, it already has a member "
+                          "named cold",
+                          struct_name);
+    }
+
+    auto cold_str = std::make_unique<structure>(&mod, str.src_info);
+
+    // Members are defined in the structure's scope, so they have to be removed from
+    // there as well before being added back.
+    auto members = std::move(all_members);
+    all_members.clear();
+    for (auto& [mem_name, mem] : members) {
+        str.get_scope().undefine(mem_name);
+    }
+
+    for (auto& [mem_name, mem] : members) {
+        if (!mem.cold) {
+            str.add_member(mem_name, mem);
+            continue;
+        }
+        mem.cold = false;
+        cold_str->add_member(mem_name, mem);
+    }
+
+    // The cold structure has to be defined before the structure pointing to it.
+    auto it = std::find_if(mod.structs.begin(), mod.structs.end(), [&](auto& s) {
+        return s.get() == &str;
+    });
+    it               = mod.structs.insert(it, std::move(cold_str));
+    auto cold_handle = define(mod.symbols(), cold_name, it->get());
+
+    auto ptr_handle = recursive_full_name_lookup(mod.symbols(), "ptr").value();
+    str.add_member("cold", member{name{ptr_handle, {name{cold_handle}}}, &str});
+}
+
+void compute_layouts(const module& mod) {
+    for (auto& [_, child] : mod.children) {
+        compute_layouts(*child);
+    }
+
+    // Services define their call and return unions lazily, structures may refer to
+    // them, so they are generated first.
+    for (auto& serv : mod.services) {
+        for (auto& [name, proc] : serv->own_procedures()) {
+            proc->params_struct(mod).layout(mod);
+            proc->results_struct(mod).layout(mod);
+        }
+        serv->procedure_params_union(mod).layout(mod);
+        serv->procedure_results_union(mod).layout(mod);
+    }
+
+    for (auto& str : mod.structs) {
+        str->layout(mod);
+    }
+
+    for (auto& u : mod.unions) {
+        u->layout(mod);
+    }
+}
+} // namespace lidl
@@ -1,5 +1,6 @@
 #include <doctest.h>
 #include <lidl/layout.hpp>
+#include <lidl/module.hpp>
 
 namespace lidl {
 namespace {
@@ -42,5 +43,57 @@ TEST_CASE("three members") {
     computer.add_member("baz", {2, 2});
     REQUIRE_EQ(raw_layout{16, 4}, computer.get());
 }
+TEST_CASE("member offsets and padding are tracked") {
+    compound_layout computer;
+    computer.add_member("foo", {1, 1});
+    computer.add_member("bar", {4, 4});
+    computer.add_member("baz", {2, 2});
+    REQUIRE_EQ(raw_layout{12, 4}, computer.get());
+    REQUIRE_EQ(3, computer.members().size());
+    REQUIRE_EQ(4, computer.members()[1].offset);
+    REQUIRE_EQ(3, computer.members()[1].padding_before);
+    REQUIRE_EQ(8, computer.members()[2].offset);
+    REQUIRE_EQ(5, computer.padding_bytes());
+}
+TEST_CASE("forced member alignment") {
+    compound_layout computer;
+    computer.add_member("foo", {8, 8});
+    computer.add_member("bar", {1, 1}, 64);
+    REQUIRE_EQ(64, computer.offset_of("bar"));
+    REQUIRE_EQ(raw_layout{128, 64}, computer.get());
+}
+TEST_CASE("forced compound alignment") {
+    compound_layout computer;
+    computer.add_member("foo", {4, 4});
+    computer.align_to(64);
+    REQUIRE_EQ(raw_layout{64, 64}, computer.get());
+    computer.add_member("bar", {4, 4});
+    REQUIRE_EQ(4, computer.offset_of("bar"));
+    REQUIRE_EQ(raw_layout{64, 64}, computer.get());
+}
+TEST_CASE("reordered structure layout") {
+    auto root_module = std::make_unique<module>();
+    root_module->add_child("", basic_module());
+    auto& mod = root_module->get_child("test");
+
+    auto i8_handle  = recursive_full_name_lookup(mod.symbols(), "i8").value();
+    auto i32_handle = recursive_full_name_lookup(mod.symbols(), "i32").value();
+
+    structure str;
+    str.add_member("a", member{name{i8_handle}});
+    str.add_member("b", member{name{i32_handle}});
+    str.add_member("c", member{name{i8_handle}});
+    REQUIRE_EQ(raw_layout{12, 4}, str.layout(mod).get());
+
+    str.set_reorder_members(true);
+    REQUIRE_EQ(raw_layout{8, 4}, str.layout(mod).get());
+    REQUIRE_EQ(raw_layout{12, 4}, str.declaration_order_layout(mod).get());
+
+    auto order = str.layout_order_members(mod);
+    REQUIRE_EQ(3, order.size());
+    REQUIRE_EQ("b", order[0].first);
+    REQUIRE_EQ("a", order[1].first);
+    REQUIRE_EQ("c", order[2].first);
+}
 } // namespace
 } // namespace lidl
\ No newline at end of file
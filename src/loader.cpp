@@ -4,6 +4,7 @@
 #include <iostream>
 #include <lidl/loader.hpp>
 #include <lidl/module.hpp>
+#include <lidl/time_report.hpp>
 #include <optional>
 
 namespace lidl {
@@ -37,7 +38,9 @@ std::optional<fs::path> search_in_path(const fs::path& in, const fs::path& impor
     if (iter == fs::directory_iterator()) {
         return {};
     }
+#ifdef LIDL_VERBOSE_LOG
     std::cerr << iter->path() << '\n';
+#endif
     return fs::canonical(*iter);
 }
 
@@ -76,6 +79,7 @@ std::pair<std::shared_ptr<module_loader>, std::string> path_resolver::resolve_im
         return {nullptr, found->string()};
     }
 
+    time_report::phase parse_phase("parse", found->string());
     if (found->extension() == ".yaml") {
         return {make_yaml_loader(ctx, import_file, found->string()), found->string()};
     }
@@ -89,6 +93,7 @@ load_context::load_context() {
 }
 
 module* load_context::do_import(std::string_view import_name, std::string_view work_dir) {
+    time_report::phase import_phase("import", import_name);
     auto [loader, key] = importer->resolve_import(*this, import_name, work_dir);
     if (!loader) {
         return nullptr;
@@ -111,7 +116,9 @@ std::vector<std::string> load_context::perform_load(module_loader& loader,
     std::vector<std::string> import_names;
     std::vector<module*> imported_mods;
     for (auto& import : meta.imports) {
+#ifdef LIDL_VERBOSE_LOG
         std::cerr << "Processing import " << import << '\n';
+#endif
         auto import_mod = do_import(import, work_dir);
         if (!import_mod) {
             std::cerr << "Importing " << import << " failed!\n";
@@ -122,12 +129,18 @@ std::vector<std::string> load_context::perform_load(module_loader& loader,
 
         import_mod->set_imported();
         import_names.push_back(import);
+#ifdef LIDL_VERBOSE_LOG
         std::cerr << "Done\n";
+#endif
     }
 
     auto& mod = loader.get_module();
     mod.imported_modules = std::move(imported_mods);
-    loader.load();
+    {
+        time_report::phase load_phase("load");
+        loader.load();
+    }
+    time_report::count("modules loaded");
     return import_names;
 }
 } // namespace lidl
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <lidl/algorithm.hpp>
 #include <lidl/basic.hpp>
 #include <lidl/module.hpp>
+#include <lidl/time_report.hpp>
 
 namespace lidl {
 module& module::get_child(qualified_name child_name) {
@@ -46,9 +47,7 @@ module& module::add_child(std::string_view child_name, std::unique_ptr<module> c
 
 const basic_generic_instantiation&
 module::create_or_get_instantiation(const name& ins) const {
-    auto it = std::find_if(
-        name_ins.begin(), name_ins.end(), [&](auto& p) { return p.first == ins; });
-    if (it != name_ins.end()) {
+    if (auto it = name_ins.find(ins); it != name_ins.end()) {
         return *it->second;
     }
 
@@ -63,9 +62,10 @@ module::create_or_get_instantiation(const name& ins) const {
     }
 
     assert(instantiation);
+    time_report::count("instantiations");
 
     instantiations.emplace_back(std::move(instantiation));
-    name_ins.emplace_back(ins, instantiations.back().get());
+    name_ins.emplace(ins, instantiations.back().get());
     return *instantiations.back();
 }
 } // namespace lidl
\ No newline at end of file
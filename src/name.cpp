@@ -73,6 +73,11 @@ const wire_type* get_wire_type(const module& mod, const name& n) {
     return static_cast<const wire_type*>(t);
 }
 
+const type* get_pointee_type(const module& mod, const name& n) {
+    auto wire_name = get_wire_type_name(mod, n);
+    return get_type(mod, deref_ptr(mod, wire_name));
+}
+
 const type* get_type(const module& mod, const name& n) {
     assert(is_type(n));
     return dynamic_cast<const type*>(resolve(mod, n));
@@ -82,6 +87,25 @@ bool operator==(const name& left, const name& right) {
     return left.base == right.base && left.args == right.args;
 }
 
+namespace {
+size_t hash_combine(size_t seed, size_t val) {
+    return seed ^ (val + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+} // namespace
+
+size_t name_hash::operator()(const name& n) const noexcept {
+    auto res = hash_combine(std::hash<const scope*>{}(n.base.get_scope()),
+                            std::hash<int>{}(n.base.get_id()));
+    for (auto& arg : n.args) {
+        if (auto nm = std::get_if<name>(&arg)) {
+            res = hash_combine(res, (*this)(*nm));
+        } else {
+            res = hash_combine(res, std::hash<int64_t>{}(std::get<int64_t>(arg)));
+        }
+    }
+    return hash_combine(res, n.args.size());
+}
+
 const name& deref_ptr(const module& mod, const name& nm) {
     auto ptr_sym = recursive_name_lookup(mod.symbols(), "ptr").value();
     if (nm.base == ptr_sym) {
@@ -89,4 +113,9 @@ const name& deref_ptr(const module& mod, const name& nm) {
     }
     return nm;
 }
+
+bool is_ptr(const module& mod, const name& nm) {
+    auto ptr_sym = recursive_name_lookup(mod.symbols(), "ptr").value();
+    return nm.base == ptr_sym;
+}
 } // namespace lidl
\ No newline at end of file
@@ -1,10 +1,86 @@
+#include <codegen.hpp>
+#include <cppgen/cppgen.hpp>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <lidl/enumeration.hpp>
 #include <lidl/module.hpp>
-#include <string_view>
+#include <lidl/union.hpp>
 
-namespace lidl {
-void generate(const module& mod, std::ostream& str);
-void pybindgen(std::string_view name, module& mod, std::ostream& str) {
-    std::stringstream src;
-    generate(mod, src);
+namespace lidl::pybind {
+namespace {
+/**
+ * Generates a python extension module for a lidl module. The extension binds the C++
+ * types in the header the cpp backend generates for the same module, so python code
+ * reads and builds messages through the C++ runtime.
+ *
+ * The extension is named after the output file, which must be compiled as a pybind11
+ * module of the same name.
+ */
+class backend : public codegen::backend {
+public:
+    void generate(const module& mod, const codegen::output& out) override {
+        if (!out.output_path) {
+            throw std::runtime_error("Pybind backend requires an output path!");
+        }
+
+        if (!mod.src_info || !mod.src_info->origin) {
+            throw std::runtime_error("Pybind backend requires a module loaded from a file!");
+        }
+
+        codegen::detail::current_backend = this;
+
+        std::ofstream str{*out.output_path};
+        if (!str.good()) {
+            throw std::runtime_error("File could not be opened: " + *out.output_path);
+        }
+
+        auto header = std::filesystem::path(*mod.src_info->origin).stem().string();
+        auto ext_name = std::filesystem::path(*out.output_path).stem().string();
+
+        str << fmt::format("#include <{}_generated.hpp>\n", header);
+        str << "#include <lidlrt/python.hpp>\n\n";
+        str << fmt::format("PYBIND11_MODULE({}, m) {{\n", ext_name);
+        str << "    ::lidl::python::bind_runtime(m);\n";
+
+        for (auto& e : mod.enums) {
+            str << bind_call(mod, "bind_enum", e.get());
+        }
+
+        for (auto& s : mod.structs) {
+            str << bind_call(mod, "bind_struct", s.get());
+        }
+
+        // Raw unions have no alternative to tell which member to read.
+        for (auto& u : mod.unions) {
+            if (!u->raw) {
+                str << bind_call(mod, "bind_union", u.get());
+            }
+        }
+
+        str << "}\n";
+    }
+
+    std::string get_user_identifier(const module& mod, const name& name) const override {
+        return cpp::get_user_identifier(mod, name);
+    }
+
+    std::string get_identifier(const module& mod, const name& name) const override {
+        return cpp::get_identifier(mod, name);
+    }
+
+private:
+    std::string bind_call(const module& mod, std::string_view fn, const base* elem) {
+        auto sym = *recursive_definition_lookup(mod.symbols(), elem);
+        return fmt::format("    ::lidl::python::{}<{}>(m, \"{}\");\n",
+                           fn,
+                           get_identifier(mod, name{sym}),
+                           local_name(sym));
+    }
+};
+} // namespace
+
+std::unique_ptr<codegen::backend> make_backend() {
+    return std::make_unique<pybind::backend>();
 }
-} // namespace lidl
+} // namespace lidl::pybind
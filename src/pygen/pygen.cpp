@@ -174,6 +174,12 @@ class {0}:
         sect.definition = fmt::format(
             format, name(), fmt::join(members, ",\n"), get().wire_layout(mod()).size());
 
+        if (get().alignment()) {
+            sect.definition += "\n" + reindent(fmt::format("alignment = {}",
+                                                           get().wire_layout(mod()).alignment()),
+                                               4);
+        }
+
         if (get().is_reference_type(mod())) {
             sect.definition += "\n" + reindent("is_ref = True", 4);
         }
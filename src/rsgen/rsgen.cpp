@@ -0,0 +1,587 @@
+#include <algorithm>
+#include <codegen.hpp>
+#include <fmt/format.h>
+#include <fstream>
+#include <iostream>
+#include <lidl/algorithm.hpp>
+#include <lidl/basic_types.hpp>
+#include <lidl/enumeration.hpp>
+#include <lidl/module.hpp>
+#include <lidl/structure.hpp>
+#include <lidl/union.hpp>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace lidl::rs {
+namespace {
+using rust_path = std::vector<std::string>;
+
+std::string identifier(std::string_view name) {
+    static const std::set<std::string_view> keywords{
+        "as",     "async", "await", "box",   "break",  "const",    "continue",
+        "do",     "dyn",   "else",  "enum",  "extern", "false",    "fn",
+        "for",    "if",    "impl",  "in",    "let",    "loop",     "macro",
+        "match",  "mod",   "move",  "mut",   "pub",    "ref",      "return",
+        "static", "struct", "trait", "true", "try",    "type",     "typeof",
+        "union",  "unsafe", "use",  "where", "while",  "yield",    "abstract",
+        "become", "final", "override", "priv", "unsized", "virtual"};
+    if (keywords.count(name)) {
+        return fmt::format("r#{}", name);
+    }
+    return std::string(name);
+}
+
+std::string reindent(const std::string& val, int indent) {
+    std::string res;
+    for (auto& line : split(val, "\n")) {
+        if (!line.empty()) {
+            res += fmt::format("{:{}}{}", "", indent, line);
+        }
+        res += '\n';
+    }
+    res.pop_back();
+    return res;
+}
+
+/**
+ * The items of a lidl namespace, which becomes a Rust module.
+ */
+struct rust_module {
+    std::vector<std::string> items;
+    std::map<std::string, rust_module> children;
+
+    void emit(std::ostream& str, int depth = 0) const {
+        for (auto& item : items) {
+            str << reindent(item, depth * 4) << "\n\n";
+        }
+        for (auto& [name, child] : children) {
+            str << reindent(fmt::format("pub mod {} {{", identifier(name)), depth * 4)
+                << '\n';
+            child.emit(str, depth + 1);
+            str << reindent("}", depth * 4) << "\n\n";
+        }
+    }
+};
+
+/**
+ * A member of a generated struct, placed at the offset lidl lays it out at.
+ */
+struct field {
+    std::string name;
+    std::string type;
+    size_t offset;
+    size_t size;
+};
+
+/**
+ * Generates a Rust module that reads and builds the types of a lidl module in place.
+ *
+ * Every struct and union becomes a #[repr(C)] Rust struct with explicit padding, which
+ * is asserted to have the lidl layout at compile time. Messages are read through
+ * lidl::get_root, which verifies everything the generated types can reach before
+ * handing out references into the buffer.
+ *
+ * Types are referred to by paths relative to the module they are used in, so the
+ * generated code of imported modules must be included next to this one.
+ */
+class rsgen {
+public:
+    explicit rsgen(const module& mod)
+        : m_mod{&mod} {
+    }
+
+    void generate(std::ostream& str) {
+        for (auto& e : mod().enums) {
+            generate_enum(*e);
+        }
+
+        for (auto& s : mod().structs) {
+            generate_struct(*s);
+        }
+
+        for (auto& u : mod().unions) {
+            if (!u->raw) {
+                generate_union(*u);
+            }
+        }
+
+        m_root.emit(str);
+    }
+
+    std::string type_name(const name& n, const rust_path& from) const {
+        return raw_type_name(get_wire_type_name(mod(), n), from);
+    }
+
+private:
+    const module& mod() const {
+        return *m_mod;
+    }
+
+    // Maps a wire type name, whose arguments are wire types as well.
+    std::string raw_type_name(const name& n, const rust_path& from) const {
+        auto sym = get_symbol(n.base);
+
+        if (dynamic_cast<const bool_type*>(sym)) {
+            return "bool";
+        }
+        if (dynamic_cast<const float_type*>(sym)) {
+            return "f32";
+        }
+        if (dynamic_cast<const double_type*>(sym)) {
+            return "f64";
+        }
+        if (auto integral = dynamic_cast<const integral_type*>(sym)) {
+            return fmt::format(
+                "{}{}", integral->is_unsigned ? "u" : "i", integral->size_in_bits);
+        }
+        if (dynamic_cast<const string_type*>(sym)) {
+            return "lidl::String";
+        }
+        if (dynamic_cast<const pointer_type*>(sym)) {
+            return fmt::format("lidl::Pointer<{}>",
+                               raw_type_name(n.args.at(0).as_name(), from));
+        }
+        if (dynamic_cast<const vector_type*>(sym)) {
+            return fmt::format("lidl::Vector<{}>",
+                               raw_type_name(n.args.at(0).as_name(), from));
+        }
+        if (dynamic_cast<const array_type*>(sym)) {
+            return fmt::format("[{}; {}]",
+                               raw_type_name(n.args.at(0).as_name(), from),
+                               std::get<int64_t>(n.args.at(1).get_variant()));
+        }
+
+        if (!n.args.empty() || sym->is_generic()) {
+            throw std::runtime_error(
+                fmt::format("Rust backend does not support generic type {}",
+                            fmt::join(absolute_name(n.base), ".")));
+        }
+
+        auto path = absolute_name(n.base);
+        size_t common = 0;
+        while (common < from.size() && common + 1 < path.size() &&
+               from[common] == path[common]) {
+            ++common;
+        }
+
+        std::string res;
+        for (size_t i = common; i < from.size(); ++i) {
+            res += "super::";
+        }
+        for (size_t i = common; i < path.size(); ++i) {
+            res += identifier(path[i]);
+            if (i + 1 != path.size()) {
+                res += "::";
+            }
+        }
+        return res;
+    }
+
+    // Whether values of the type can be copied into a message, i.e. it holds no
+    // pointers or unions.
+    bool is_plain(const name& n) const {
+        auto wire_name = get_wire_type_name(mod(), n);
+        auto sym       = get_symbol(wire_name.base);
+        if (dynamic_cast<const basic_type*>(sym) || dynamic_cast<const enumeration*>(sym)) {
+            return true;
+        }
+        if (dynamic_cast<const array_type*>(sym)) {
+            return is_plain(wire_name.args.at(0).as_name());
+        }
+        if (auto str = dynamic_cast<const structure*>(sym)) {
+            return std::all_of(str->all_members().begin(),
+                               str->all_members().end(),
+                               [this](auto& mem) { return is_plain(mem.second.type_); });
+        }
+        return false;
+    }
+
+    // The type of the argument a member is built from: plain members are written by
+    // value, pointers are pointed at objects built before. Returns nothing for members
+    // that can't be built from outside, such as inline structs with pointers.
+    std::optional<std::string> builder_arg(const name& n, const rust_path& from) const {
+        if (is_plain(n)) {
+            return type_name(n, from);
+        }
+        auto wire_name = get_wire_type_name(mod(), n);
+        if (is_ptr(mod(), wire_name)) {
+            return fmt::format("lidl::Offset<{}>",
+                               raw_type_name(deref_ptr(mod(), wire_name), from));
+        }
+        return std::nullopt;
+    }
+
+    std::string builder_write(const name& n, size_t offset, std::string_view val) const {
+        if (is_ptr(mod(), get_wire_type_name(mod(), n))) {
+            return fmt::format("mb.write_pointer(obj.member({}), {})?;", offset, val);
+        }
+        return fmt::format("mb.write(obj.member({}), {});", offset, val);
+    }
+
+    std::pair<std::string, rust_path> path_of(const base* elem) const {
+        auto sym  = *recursive_definition_lookup(mod().symbols(), elem);
+        auto path = absolute_name(sym);
+        rust_path ns(path.begin(), path.end() - 1);
+        return {std::string(path.back()), std::move(ns)};
+    }
+
+    rust_module& module_at(const rust_path& ns) {
+        auto cur = &m_root;
+        for (auto& part : ns) {
+            cur = &cur->children[part];
+        }
+        return *cur;
+    }
+
+    static std::string fields_def(const std::vector<field>& fields,
+                                  size_t size,
+                                  bool public_fields) {
+        std::vector<std::string> lines;
+        size_t cur = 0;
+        int pads   = 0;
+        auto pad_to = [&](size_t offset) {
+            if (offset > cur) {
+                lines.push_back(fmt::format("_pad{}: [u8; {}],", pads++, offset - cur));
+            }
+        };
+        for (auto& f : fields) {
+            pad_to(f.offset);
+            lines.push_back(fmt::format(
+                "{}{}: {},", public_fields ? "pub " : "", identifier(f.name), f.type));
+            cur = f.offset + f.size;
+        }
+        pad_to(size);
+        return fmt::format("    {}", fmt::join(lines, "\n    "));
+    }
+
+    static std::string layout_asserts(std::string_view name,
+                                      const std::vector<field>& fields,
+                                      raw_layout layout) {
+        std::vector<std::string> lines;
+        lines.push_back(
+            fmt::format("assert!(core::mem::size_of::<{}>() == {});", name, layout.size()));
+        lines.push_back(fmt::format(
+            "assert!(core::mem::align_of::<{}>() == {});", name, layout.alignment()));
+        for (auto& f : fields) {
+            lines.push_back(fmt::format("assert!(core::mem::offset_of!({}, {}) == {});",
+                                        name,
+                                        identifier(f.name),
+                                        f.offset));
+        }
+        return fmt::format("const _: () = {{\n    {}\n}};", fmt::join(lines, "\n    "));
+    }
+
+    void generate_enum(const enumeration& e) {
+        auto [name, ns] = path_of(&e);
+        generate_enum(e, name, ns);
+    }
+
+    void generate_enum(const enumeration& e, std::string_view name, const rust_path& ns) {
+        constexpr auto format = R"__(#[repr({underlying})]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[allow(non_camel_case_types)]
+pub enum {name} {{
+    {members}
+}}
+
+unsafe impl lidl::Verify for {name} {{
+    fn verify(v: &mut lidl::Verifier, pos: usize) -> bool {{
+        match v.read::<{underlying}>(pos) {{
+            {values} => true,
+            _ => false,
+        }}
+    }}
+}}
+
+unsafe impl lidl::Plain for {name} {{}})__";
+
+        std::vector<std::string> members;
+        std::vector<std::string> values;
+        for (auto& [member_name, member] : e.all_members()) {
+            members.push_back(fmt::format("{} = {},", identifier(member_name), member->value));
+            values.push_back(fmt::format("Some({})", member->value));
+        }
+
+        module_at(ns).items.push_back(
+            fmt::format(format,
+                        fmt::arg("name", name),
+                        fmt::arg("underlying", type_name(e.underlying_type, ns)),
+                        fmt::arg("members", fmt::join(members, "\n    ")),
+                        fmt::arg("values", fmt::join(values, " | "))));
+    }
+
+    void generate_struct(const structure& s) {
+        constexpr auto format = R"__(#[repr({repr})]
+{derives}#[allow(non_camel_case_types, non_snake_case)]
+pub struct {name} {{
+{fields}
+}}
+
+{asserts}
+
+unsafe impl lidl::Verify for {name} {{
+{plain}    fn verify(v: &mut lidl::Verifier, pos: usize) -> bool {{
+        v.in_bounds_of::<Self>(pos){verify}
+    }}
+}})__";
+
+        auto [name, ns] = path_of(&s);
+        auto& layout    = s.layout(mod());
+
+        std::vector<field> fields;
+        for (auto& [member_name, member] : s.all_members()) {
+            fields.push_back(
+                field{member_name,
+                      type_name(member.type_, ns),
+                      layout.offset_of(member_name).value(),
+                      size_t(get_wire_type(mod(), member.type_)->wire_layout(mod()).size())});
+        }
+        std::sort(fields.begin(), fields.end(), [](auto& a, auto& b) {
+            return a.offset < b.offset;
+        });
+
+        std::vector<std::string> plain;
+        std::string verify;
+        for (auto& f : fields) {
+            plain.push_back(fmt::format("<{} as lidl::Verify>::PLAIN", f.type));
+            verify += fmt::format("\n            && <{} as lidl::Verify>::verify(v, pos + {})",
+                                  f.type,
+                                  f.offset);
+        }
+
+        auto wire_layout = s.wire_layout(mod());
+        auto repr        = s.alignment() ? fmt::format("C, align({})", wire_layout.alignment())
+                                         : std::string("C");
+
+        auto plain_struct =
+            is_plain(lidl::name{*recursive_definition_lookup(mod().symbols(), &s)});
+
+        // Plain structs of numbers need no more than a bounds check, but bools and enums
+        // still need their values checked.
+        std::string plain_const;
+        if (plain_struct) {
+            plain_const = fmt::format("    const PLAIN: bool = {};\n\n",
+                                      plain.empty() ? "true"
+                                                    : fmt::format("{}", fmt::join(plain, " && ")));
+        }
+
+        auto def          = fmt::format(
+            format,
+            fmt::arg("name", name),
+            fmt::arg("repr", repr),
+            fmt::arg("derives", plain_struct ? "#[derive(Clone, Copy)]\n" : ""),
+            fmt::arg("fields", fields_def(fields, wire_layout.size(), true)),
+            fmt::arg("asserts", layout_asserts(name, fields, wire_layout)),
+            fmt::arg("plain", plain_const),
+            fmt::arg("verify", verify));
+
+        if (plain_struct) {
+            def += fmt::format("\n\nunsafe impl lidl::Plain for {} {{}}", name);
+        }
+
+        std::vector<std::string> methods;
+        if (plain_struct) {
+            methods.push_back(struct_new(fields, wire_layout.size()));
+        }
+        if (auto create = struct_create(s, ns); create) {
+            methods.push_back(*create);
+        }
+        if (!methods.empty()) {
+            def += fmt::format("\n\nimpl {} {{\n{}\n}}", name, fmt::join(methods, "\n\n"));
+        }
+
+        module_at(ns).items.push_back(std::move(def));
+    }
+
+    static std::string struct_new(const std::vector<field>& fields, size_t size) {
+        std::vector<std::string> args;
+        std::vector<std::string> inits;
+        size_t cur = 0;
+        int pads   = 0;
+        auto pad_to = [&](size_t offset) {
+            if (offset > cur) {
+                inits.push_back(fmt::format("_pad{}: [0; {}],", pads++, offset - cur));
+            }
+        };
+        for (auto& f : fields) {
+            args.push_back(fmt::format("{}: {}", identifier(f.name), f.type));
+            pad_to(f.offset);
+            inits.push_back(fmt::format("{},", identifier(f.name)));
+            cur = f.offset + f.size;
+        }
+        pad_to(size);
+
+        return fmt::format("    pub fn new({}) -> Self {{\n        Self {{\n            {}\n        "
+                           "}}\n    }}",
+                           fmt::join(args, ", "),
+                           fmt::join(inits, "\n            "));
+    }
+
+    std::optional<std::string> struct_create(const structure& s, const rust_path& ns) const {
+        auto& layout = s.layout(mod());
+
+        std::vector<std::string> args{"mb: &mut lidl::MessageBuilder"};
+        std::vector<std::string> writes;
+        for (auto& [member_name, member] : s.all_members()) {
+            auto arg = builder_arg(member.type_, ns);
+            if (!arg) {
+                return std::nullopt;
+            }
+            args.push_back(fmt::format("{}: {}", identifier(member_name), *arg));
+            writes.push_back(builder_write(member.type_,
+                                           layout.offset_of(member_name).value(),
+                                           identifier(member_name)));
+        }
+
+        constexpr auto format = R"__(    pub fn create({args}) -> Option<lidl::Offset<Self>> {{
+        let obj = mb.allocate_object::<Self>()?;
+        {writes}
+        Some(obj)
+    }})__";
+
+        return fmt::format(format,
+                           fmt::arg("args", fmt::join(args, ", ")),
+                           fmt::arg("writes", fmt::join(writes, "\n        ")));
+    }
+
+    void generate_union(const union_type& u) {
+        constexpr auto format = R"__(#[repr(C)]
+#[allow(non_camel_case_types, non_snake_case)]
+union {name}_val {{
+    {variants}
+}}
+
+#[repr(C)]
+#[allow(non_camel_case_types)]
+pub struct {name} {{
+{fields}
+}}
+
+{asserts}
+
+unsafe impl lidl::Verify for {name} {{
+    fn verify(v: &mut lidl::Verifier, pos: usize) -> bool {{
+        if !v.in_bounds_of::<Self>(pos) {{
+            return false;
+        }}
+        match v.read::<{name}_alternatives>(pos + {discriminator}) {{
+            {verify}
+            None => false,
+        }}
+    }}
+}}
+
+impl {name} {{
+    pub fn alternative(&self) -> {name}_alternatives {{
+        self.discriminator
+    }}
+
+{accessors}
+}})__";
+
+        auto [name, ns] = path_of(&u);
+        auto& layout    = u.layout(mod());
+        auto discriminator = layout.offset_of("discriminator").value();
+        auto val           = layout.offset_of("val").value();
+
+        generate_enum(u.get_enum(mod()), fmt::format("{}_alternatives", name), ns);
+
+        std::vector<std::string> variants;
+        std::vector<std::string> verify;
+        std::vector<std::string> accessors;
+        for (auto& [member_name, member] : u.all_members()) {
+            auto type = type_name(member->type_, ns);
+            auto id   = identifier(member_name);
+            variants.push_back(fmt::format("{}: core::mem::ManuallyDrop<{}>,", id, type));
+            verify.push_back(fmt::format(
+                "Some({}_alternatives::{}) => <{} as lidl::Verify>::verify(v, pos + {}),",
+                name,
+                id,
+                type,
+                val));
+
+            accessors.push_back(fmt::format(R"__(    pub fn {id}(&self) -> Option<&{type}> {{
+        if self.discriminator == {name}_alternatives::{id} {{
+            Some(unsafe {{ &*self.val.{id} }})
+        }} else {{
+            None
+        }}
+    }})__",
+                                            fmt::arg("id", id),
+                                            fmt::arg("type", type),
+                                            fmt::arg("name", name)));
+
+            if (auto arg = builder_arg(member->type_, ns); arg) {
+                accessors.push_back(fmt::format(
+                    R"__(    pub fn create_{member}(mb: &mut lidl::MessageBuilder, val: {arg}) -> Option<lidl::Offset<Self>> {{
+        let obj = mb.allocate_object::<Self>()?;
+        mb.write(obj.member({discriminator}), {name}_alternatives::{id});
+        {write}
+        Some(obj)
+    }})__",
+                    fmt::arg("member", member_name),
+                    fmt::arg("arg", *arg),
+                    fmt::arg("discriminator", discriminator),
+                    fmt::arg("name", name),
+                    fmt::arg("id", id),
+                    fmt::arg("write", builder_write(member->type_, val, "val"))));
+            }
+        }
+
+        auto wire_layout = u.wire_layout(mod());
+        std::vector<field> fields{
+            {"discriminator",
+             fmt::format("{}_alternatives", name),
+             discriminator,
+             size_t(u.get_enum(mod()).wire_layout(mod()).size())},
+            {"val", fmt::format("{}_val", name), val, size_t(wire_layout.size()) - val}};
+
+        module_at(ns).items.push_back(
+            fmt::format(format,
+                        fmt::arg("name", name),
+                        fmt::arg("variants", fmt::join(variants, "\n    ")),
+                        fmt::arg("fields", fields_def(fields, wire_layout.size(), false)),
+                        fmt::arg("asserts", layout_asserts(name, fields, wire_layout)),
+                        fmt::arg("discriminator", discriminator),
+                        fmt::arg("verify", fmt::join(verify, "\n            ")),
+                        fmt::arg("accessors", fmt::join(accessors, "\n\n"))));
+    }
+
+    const module* m_mod;
+    rust_module m_root;
+};
+
+class backend : public codegen::backend {
+public:
+    void generate(const module& mod, const codegen::output& out) override {
+        codegen::detail::current_backend = this;
+
+        std::ostream* str = &std::cout;
+        std::ofstream file;
+        if (out.output_path) {
+            file.open(*out.output_path);
+            if (!file.good()) {
+                throw std::runtime_error("File could not be opened: " + *out.output_path);
+            }
+            str = &file;
+        }
+
+        rsgen gen(mod);
+        gen.generate(*str);
+    }
+
+    std::string get_user_identifier(const module& mod, const name& name) const override {
+        return get_identifier(mod, name);
+    }
+
+    std::string get_identifier(const module& mod, const name& name) const override {
+        return rsgen(mod).type_name(name, {});
+    }
+};
+} // namespace
+
+std::unique_ptr<codegen::backend> make_backend() {
+    return std::make_unique<rs::backend>();
+}
+} // namespace lidl::rs
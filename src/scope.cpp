@@ -5,6 +5,7 @@
 #include <lidl/algorithm.hpp>
 #include <lidl/base.hpp>
 #include <lidl/scope.hpp>
+#include <lidl/time_report.hpp>
 #include <stdexcept>
 
 
@@ -26,6 +27,7 @@ symbol_handle scope::declare(std::string_view name) {
     auto [it, emres] = m_aliases.emplace(std::string(name), res);
     assert(emres);
     m_names.emplace_back(it->first);
+    time_report::count("symbols");
     return res;
 }
 
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <lidl/generics.hpp>
 #include <lidl/structure.hpp>
 
 namespace lidl {
@@ -17,19 +18,72 @@ raw_layout structure::wire_layout(const module& mod) const {
     return layout(mod).get();
 }
 
-compound_layout structure::layout(const module& mod) const {
-    compound_layout computer;
+const compound_layout& structure::layout(const module& mod) const {
+    if (!m_layout) {
+        m_layout = compute_layout(mod, m_reorder_members);
+    }
+    return *m_layout;
+}
+
+compound_layout structure::declaration_order_layout(const module& mod) const {
+    return compute_layout(mod, false);
+}
+
+compound_layout structure::compute_layout(const module& mod, bool reorder) const {
+    struct member_layout {
+        std::string_view name;
+        raw_layout layout;
+        size_t alignment;
+    };
+
+    std::vector<member_layout> member_layouts;
+    member_layouts.reserve(members.size());
     for (auto& [name, member] : members) {
         auto wire_type = get_wire_type(mod, member.type_);
-        computer.add_member(name, wire_type->wire_layout(mod));
+        auto layout    = wire_type->wire_layout(mod);
+        member_layouts.push_back(member_layout{
+            name,
+            layout,
+            std::max<size_t>(layout.alignment(), member.alignment.value_or(1))});
+    }
+
+    if (reorder) {
+        // Every layout's size is a multiple of its alignment, so placing the members in
+        // decreasing order of alignment leaves no interior padding, unless a member has
+        // a forced alignment larger than its size.
+        std::stable_sort(
+            member_layouts.begin(), member_layouts.end(), [](auto& left, auto& right) {
+                return left.alignment > right.alignment;
+            });
+    }
+
+    compound_layout computer;
+    for (auto& mem : member_layouts) {
+        computer.add_member(mem.name, mem.layout, mem.alignment);
+    }
+    if (m_alignment) {
+        computer.align_to(*m_alignment);
     }
     return computer;
 }
 
-YAML::Node structure::bin2yaml(const module& mod, ibinary_reader& reader) const {
+std::vector<std::pair<std::string_view, const member*>>
+structure::layout_order_members(const module& mod) const {
+    std::vector<std::pair<std::string_view, const member*>> res;
+    for (auto& entry : layout(mod).members()) {
+        auto it = std::find_if(members.begin(), members.end(), [&](auto& mem) {
+            return mem.first == entry.name;
+        });
+        assert(it != members.end());
+        res.emplace_back(it->first, &it->second);
+    }
+    return res;
+}
+
+YAML::Node structure::bin2yaml(const module& mod, binary_reader& reader) const {
     YAML::Node node;
 
-    auto l = layout(mod);
+    auto& l = layout(mod);
 
     auto struct_begin = reader.tell();
 
@@ -53,7 +107,7 @@ YAML::Node structure::bin2yaml(const module& mod, ibinary_reader& reader) const
 
 int structure::yaml2bin(const module& mod,
                         const YAML::Node& node,
-                        ibinary_writer& writer) const {
+                        binary_writer& writer) const {
     std::unordered_map<std::string, int> references;
     for (auto& [mem_name, mem] : members) {
         auto t = lidl::get_wire_type(mod, mem.type_);
@@ -63,17 +117,18 @@ int structure::yaml2bin(const module& mod,
             continue;
         }
 
-        auto pointee = lidl::get_wire_type(mod, deref_ptr(mod, mem.type_));
+        auto pointee = lidl::get_pointee_type(mod, mem.type_);
         references.emplace(mem_name, pointee->yaml2bin(mod, node[mem_name], writer));
     }
 
     writer.align(wire_layout(mod).alignment());
     auto struct_pos = writer.tell(); // Struct beginning
-    auto l          = layout(mod);
-    for (auto& [mem_name, mem] : members) {
-        auto t = lidl::get_wire_type(mod, mem.type_);
+    auto& l         = layout(mod);
+    for (auto& [mem_name, mem_ptr] : layout_order_members(mod)) {
+        auto& mem = *mem_ptr;
+        auto t    = lidl::get_wire_type(mod, mem.type_);
         if (t->is_reference_type(mod)) {
-            const auto pos = references[mem_name];
+            const auto pos = references[std::string(mem_name)];
             YAML::Node ptr_node(pos);
             writer.align(t->wire_layout(mod).alignment());
 
@@ -83,7 +138,7 @@ int structure::yaml2bin(const module& mod,
 
             t->yaml2bin(mod, ptr_node, writer);
         } else {
-            auto& elem = node[mem_name];
+            auto& elem = node[std::string(mem_name)];
             writer.align(t->wire_layout(mod).alignment());
 
             auto expected_offset = l.offset_of(mem_name).value();
@@ -98,6 +153,60 @@ int structure::yaml2bin(const module& mod,
     return struct_pos;
 }
 
+void structure::bin2json(const module& mod,
+                         binary_reader& reader,
+                         json_writer& writer) const {
+    auto& l = layout(mod);
+
+    auto struct_begin = reader.tell();
+
+    writer.begin_object();
+    for (auto& [name, member] : members) {
+        reader.seek(struct_begin + l.offset_of(name).value(), std::ios::beg);
+        writer.key(name);
+        lidl::get_wire_type(mod, member.type_)->bin2json(mod, reader, writer);
+    }
+    writer.end_object();
+}
+
+int structure::json2bin(const module& mod,
+                        const json_value& value,
+                        binary_writer& writer) const {
+    std::unordered_map<std::string_view, int> references;
+    for (auto& [mem_name, mem] : members) {
+        auto t = lidl::get_wire_type(mod, mem.type_);
+
+        if (t->is_value(mod)) {
+            // Continue, we'll place it inline
+            continue;
+        }
+
+        auto pointee = lidl::get_pointee_type(mod, mem.type_);
+        references.emplace(mem_name, pointee->json2bin(mod, value[mem_name], writer));
+    }
+
+    writer.align(wire_layout(mod).alignment());
+    auto struct_pos = writer.tell(); // Struct beginning
+    auto& l         = layout(mod);
+    for (auto& [mem_name, mem_ptr] : layout_order_members(mod)) {
+        auto t = lidl::get_wire_type(mod, mem_ptr->type_);
+        writer.align(t->wire_layout(mod).alignment());
+
+        auto expected_offset = l.offset_of(mem_name).value();
+        auto cur_offset      = writer.tell() - struct_pos;
+        assert(expected_offset == cur_offset);
+
+        if (t->is_reference_type(mod)) {
+            pointer_type::write(writer, references[mem_name]);
+        } else {
+            t->json2bin(mod, value[mem_name], writer);
+        }
+    }
+    // Must add the trailing padding bytes!
+    writer.align(wire_layout(mod).alignment());
+    return struct_pos;
+}
+
 void structure::add_member(std::string name, member mem) {
 //    if (mem.type_ != lidl::get_wire_type_name(*find_parent_module(this), mem.type_)) {
 //        report_user_error(error_type::warning,
@@ -107,5 +216,6 @@ void structure::add_member(std::string name, member mem) {
 //    }
     members.emplace_back(std::move(name), std::move(mem));
     define(get_scope(), members.back().first, &members.back().second);
+    m_layout.reset();
 }
 } // namespace lidl
\ No newline at end of file
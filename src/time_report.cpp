@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <chrono>
+#include <fmt/format.h>
+#include <lidl/json.hpp>
+#include <lidl/time_report.hpp>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace lidl::time_report {
+namespace {
+using clock = std::chrono::steady_clock;
+
+struct event {
+    std::string name;
+    std::string detail;
+    int parent;
+    clock::time_point begin;
+    clock::time_point end;
+};
+
+struct report {
+    bool enabled = false;
+    clock::time_point start;
+    std::vector<event> events;
+    // Index of the innermost running phase, -1 if there is none.
+    int current = -1;
+    std::map<std::string, int64_t, std::less<>> counters;
+};
+
+report& get_report() {
+    static report rep;
+    return rep;
+}
+
+double millis(clock::duration dur) {
+    return std::chrono::duration<double, std::milli>(dur).count();
+}
+
+// Runs of phases with the same names along their path are merged in the table.
+struct table_node {
+    std::string name;
+    int calls = 0;
+    clock::duration total{};
+    clock::duration children{};
+    std::vector<std::unique_ptr<table_node>> nodes;
+
+    table_node& child(std::string_view child_name) {
+        for (auto& node : nodes) {
+            if (node->name == child_name) {
+                return *node;
+            }
+        }
+        nodes.push_back(std::make_unique<table_node>());
+        nodes.back()->name = std::string(child_name);
+        return *nodes.back();
+    }
+};
+
+void format_node(std::string& out, const table_node& node, int depth) {
+    auto name = fmt::format("{:{}}{}", "", depth * 2, node.name);
+    out += fmt::format("{:<40} {:>8} {:>12.3f} {:>12.3f}\n",
+                       name,
+                       node.calls,
+                       millis(node.total),
+                       millis(node.total - node.children));
+    for (auto& child : node.nodes) {
+        format_node(out, *child, depth + 1);
+    }
+}
+} // namespace
+
+void enable() {
+    auto& rep   = get_report();
+    rep.enabled = true;
+    rep.start   = clock::now();
+}
+
+bool enabled() {
+    return get_report().enabled;
+}
+
+void count(std::string_view counter, int64_t n) {
+    auto& rep = get_report();
+    if (!rep.enabled) {
+        return;
+    }
+    if (auto it = rep.counters.find(counter); it != rep.counters.end()) {
+        it->second += n;
+        return;
+    }
+    rep.counters.emplace(std::string(counter), n);
+}
+
+phase::phase(std::string_view name, std::string_view detail) {
+    auto& rep = get_report();
+    if (!rep.enabled) {
+        return;
+    }
+    m_index = static_cast<int>(rep.events.size());
+    rep.events.push_back(
+        {std::string(name), std::string(detail), rep.current, clock::now(), {}});
+    rep.current = m_index;
+}
+
+phase::~phase() {
+    if (m_index == -1) {
+        return;
+    }
+    auto& rep   = get_report();
+    auto& ev    = rep.events[m_index];
+    ev.end      = clock::now();
+    rep.current = ev.parent;
+}
+
+std::string format_table() {
+    auto& rep = get_report();
+
+    // Events are stored in the order they started in, so parents come before their
+    // children.
+    table_node root;
+    std::vector<table_node*> nodes(rep.events.size());
+    for (size_t i = 0; i < rep.events.size(); ++i) {
+        auto& ev     = rep.events[i];
+        auto& parent = ev.parent == -1 ? root : *nodes[ev.parent];
+        auto& node   = parent.child(ev.name);
+        node.calls++;
+        node.total += ev.end - ev.begin;
+        parent.children += ev.end - ev.begin;
+        nodes[i] = &node;
+    }
+
+    std::string res = fmt::format(
+        "{:<40} {:>8} {:>12} {:>12}\n", "phase", "calls", "total ms", "self ms");
+    for (auto& node : root.nodes) {
+        format_node(res, *node, 0);
+    }
+
+    if (!rep.counters.empty()) {
+        res += fmt::format("\n{:<40} {:>8}\n", "counter", "value");
+        for (auto& [name, val] : rep.counters) {
+            res += fmt::format("{:<40} {:>8}\n", name, val);
+        }
+    }
+
+    return res;
+}
+
+std::string format_chrome_trace() {
+    auto& rep = get_report();
+
+    auto micros = [&](clock::time_point point) {
+        return std::chrono::duration<double, std::micro>(point - rep.start).count();
+    };
+
+    std::string res;
+    json_writer writer(res);
+    writer.begin_object();
+    writer.key("traceEvents");
+    writer.begin_array();
+    clock::time_point last = rep.start;
+    for (auto& ev : rep.events) {
+        writer.begin_object();
+        writer.key("name");
+        writer.value(ev.name);
+        writer.key("cat");
+        writer.value("lidlc");
+        writer.key("ph");
+        writer.value("X");
+        writer.key("ts");
+        writer.value(micros(ev.begin));
+        writer.key("dur");
+        writer.value(micros(ev.end) - micros(ev.begin));
+        writer.key("pid");
+        writer.value(int64_t(1));
+        writer.key("tid");
+        writer.value(int64_t(1));
+        if (!ev.detail.empty()) {
+            writer.key("args");
+            writer.begin_object();
+            writer.key("detail");
+            writer.value(ev.detail);
+            writer.end_object();
+        }
+        writer.end_object();
+        last = std::max(last, ev.end);
+    }
+
+    // Counters are only known in total, so they are reported once, at the end.
+    if (!rep.counters.empty()) {
+        writer.begin_object();
+        writer.key("name");
+        writer.value("counters");
+        writer.key("ph");
+        writer.value("C");
+        writer.key("ts");
+        writer.value(micros(last));
+        writer.key("pid");
+        writer.value(int64_t(1));
+        writer.key("tid");
+        writer.value(int64_t(1));
+        writer.key("args");
+        writer.begin_object();
+        for (auto& [name, val] : rep.counters) {
+            writer.key(name);
+            writer.value(val);
+        }
+        writer.end_object();
+        writer.end_object();
+    }
+    writer.end_array();
+    writer.key("displayTimeUnit");
+    writer.value("ms");
+    writer.end_object();
+    return res;
+}
+} // namespace lidl::time_report
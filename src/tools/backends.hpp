@@ -0,0 +1,54 @@
+#pragma once
+
+#include <codegen.hpp>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+namespace lidl {
+#if defined(ENABLE_CPP)
+namespace cpp {
+std::unique_ptr<codegen::backend> make_backend();
+}
+#endif
+#if defined(ENABLE_JS)
+namespace js {
+std::unique_ptr<codegen::backend> make_backend();
+}
+#endif
+#if defined(ENABLE_PY)
+namespace py {
+std::unique_ptr<codegen::backend> make_backend();
+}
+#endif
+#if defined(ENABLE_PYBIND)
+namespace pybind {
+std::unique_ptr<codegen::backend> make_backend();
+}
+#endif
+#if defined(ENABLE_RS)
+namespace rs {
+std::unique_ptr<codegen::backend> make_backend();
+}
+#endif
+inline std::unordered_map<std::string_view,
+                          std::function<std::unique_ptr<codegen::backend>()>>
+    backends {
+#if defined(ENABLE_CPP)
+    {"cpp", cpp::make_backend},
+#endif
+#if defined(ENABLE_JS)
+        {"js", js::make_backend}, {"ts", js::make_backend},
+#endif
+#if defined(ENABLE_PY)
+        {"py", py::make_backend},
+#endif
+#if defined(ENABLE_PYBIND)
+        {"pybind", pybind::make_backend},
+#endif
+#if defined(ENABLE_RS)
+        {"rs", rs::make_backend},
+#endif
+};
+} // namespace lidl
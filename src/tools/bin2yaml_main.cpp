@@ -2,78 +2,339 @@
 // Created by fatih on 1/31/20.
 //
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iostream>
 #include <lidl/loader.hpp>
 #include <lidl/module.hpp>
 #include <lidlrt/buffer.hpp>
+#include <lyra/lyra.hpp>
+#include <sstream>
+#include <thread>
 #include <yaml-cpp/yaml.h>
 #include <yaml.hpp>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LIDL_HAVE_MMAP
+#endif
+
 namespace lidl {
-class memory_reader : public ibinary_reader {
+namespace {
+/**
+ * A read only view of a whole file. The file is memory mapped where possible, so that
+ * large captures are paged in on demand rather than read up front.
+ */
+class mapped_file {
 public:
-    explicit memory_reader(gsl::span<uint8_t> data)
-        : m_data{data}
-        , m_loc(m_data.size()) {
+    explicit mapped_file(const std::string& path) {
+#if defined(LIDL_HAVE_MMAP)
+        auto fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open " + path);
+        }
+
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            auto ptr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED) {
+                ::madvise(ptr, st.st_size, MADV_SEQUENTIAL);
+                m_map = {static_cast<const uint8_t*>(ptr), size_t(st.st_size)};
+            }
+        }
+        ::close(fd);
+
+        if (!m_map.empty()) {
+            return;
+        }
+#endif
+        std::ifstream file(path, std::ios::binary);
+        if (!file.good()) {
+            throw std::runtime_error("Could not open " + path);
+        }
+        m_fallback.assign(std::istreambuf_iterator<char>(file),
+                          std::istreambuf_iterator<char>{});
     }
 
-    using ibinary_reader::seek;
-    void seek(int bytes, std::ios::seekdir dir) override {
-        if (dir == std::ios::cur) {
-            m_loc += bytes;
-        } else if (dir == std::ios::beg) {
-            m_loc = bytes;
-        } else {
-            m_loc = m_data.size() - bytes;
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() {
+#if defined(LIDL_HAVE_MMAP)
+        if (!m_map.empty()) {
+            ::munmap(const_cast<uint8_t*>(m_map.data()), m_map.size());
         }
+#endif
     }
 
-    int tell() override {
-        return m_loc;
+    gsl::span<const uint8_t> data() const {
+        if (!m_map.empty()) {
+            return m_map;
+        }
+        return {m_fallback.data(), m_fallback.size()};
     }
 
-    gsl::span<uint8_t> read(gsl::span<uint8_t> span) override {
-        memcpy(span.data(), m_data.data() + m_loc, span.size());
-        return span;
+private:
+    gsl::span<const uint8_t> m_map;
+    std::vector<uint8_t> m_fallback;
+};
+
+/**
+ * Splits a capture file into messages. Every frame is a 4 byte little endian length
+ * followed by that many bytes of a single lidl message.
+ */
+std::vector<gsl::span<const uint8_t>> split_frames(gsl::span<const uint8_t> data) {
+    std::vector<gsl::span<const uint8_t>> frames;
+    size_t pos = 0;
+    while (pos < data.size()) {
+        if (data.size() - pos < sizeof(uint32_t)) {
+            std::cerr << fmt::format("Warning: {} trailing bytes at offset {} ignored\n",
+                                     data.size() - pos,
+                                     pos);
+            break;
+        }
+
+        uint32_t len;
+        memcpy(&len, data.data() + pos, sizeof len);
+        pos += sizeof len;
+
+        if (len > data.size() - pos) {
+            std::cerr << fmt::format(
+                "Warning: truncated frame at offset {}, expected {} bytes, have {}\n",
+                pos - sizeof len,
+                len,
+                data.size() - pos);
+            break;
+        }
+
+        frames.push_back(data.subspan(pos, len));
+        pos += len;
     }
+    return frames;
+}
 
-    gsl::span<const uint8_t> m_data;
-    int m_loc;
+enum class output_format
+{
+    yaml,
+    json,
 };
-} // namespace lidl
 
-int main(int argc, char** argv) {
-    using namespace lidl;
-    auto root_mod = std::make_unique<module>();
-    root_mod->add_child("", basic_module());
+struct bin2yaml_args {
+    std::string schema_path;
+    std::string root_type;
+    std::string input_path;
+    bool frames          = false;
+    output_format format = output_format::yaml;
+    int jobs             = 1;
+};
+
+/**
+ * A schema along with the root type messages are decoded as.
+ *
+ * The type model lazily caches layouts and generic instances, so it's not safe to share
+ * between threads. Every decoding thread loads its own copy instead.
+ */
+struct decoder {
+    explicit decoder(const bin2yaml_args& args) {
+        ctx.set_importer(std::make_unique<lidl::path_resolver>());
+        mod = ctx.do_import(args.schema_path, "");
 
-    auto importer = std::make_unique<lidl::path_resolver>();
-    //    for (auto& path : args.import_paths) {
-    //        importer->add_import_path(path);
-    //    }
+        if (!mod) {
+            std::cerr << "Module parsing failed!\n";
+            exit(1);
+        }
+
+        auto sym = recursive_name_lookup(mod->symbols(), args.root_type);
+        if (!sym) {
+            std::cerr << fmt::format("Unknown root type: {}\n", args.root_type);
+            exit(1);
+        }
+
+        // The root object is stored inline at the end of the message, even if it's a
+        // reference type, so we need the type itself rather than its wire type.
+        root = get_type<wire_type>(*mod, name{*sym});
+    }
+
+    YAML::Node decode(gsl::span<const uint8_t> message) const {
+        binary_reader reader(message);
+        reader.seek(-root->wire_layout(*mod).size());
+        return root->bin2yaml(*mod, reader);
+    }
+
+    std::string decode_to_string(gsl::span<const uint8_t> message,
+                                 output_format format) const {
+        if (format == output_format::json) {
+            return decode_to_json(message);
+        }
+        std::ostringstream out;
+        out << "---\n" << decode(message) << '\n';
+        return out.str();
+    }
+
+    std::string decode_to_json(gsl::span<const uint8_t> message) const {
+        std::string res;
+        json_writer writer(res);
+        binary_reader reader(message);
+        reader.seek(-root->wire_layout(*mod).size());
+        root->bin2json(*mod, reader, writer);
+        res.push_back('\n');
+        return res;
+    }
 
     lidl::load_context ctx;
-    ctx.set_importer(std::move(importer));
-    auto mod = ctx.do_import(argv[1], "");
+    module* mod;
+    const wire_type* root;
+};
+
+// Decodes a frame, or returns false and the error if the frame is truncated or corrupt.
+bool try_decode(const decoder& dec,
+                gsl::span<const uint8_t> frame,
+                output_format format,
+                std::string& out) {
+    try {
+        out = dec.decode_to_string(frame, format);
+        return true;
+    } catch (const std::exception& err) {
+        out = err.what();
+        return false;
+    }
+}
 
-    if (!mod) {
-        std::cerr << "Module parsing failed!\n";
-        exit(1);
+void report_bad_frame(size_t index, const std::string& error) {
+    std::cerr << fmt::format("Could not decode frame {}: {}\n", index, error);
+}
+
+/**
+ * Decodes every frame in order. Frames that can't be decoded are reported and skipped,
+ * so a single corrupt frame doesn't lose the rest of a capture. Returns the number of
+ * frames that couldn't be decoded.
+ */
+size_t decode_frames(const bin2yaml_args& args,
+                     const std::vector<gsl::span<const uint8_t>>& frames) {
+    auto jobs  = std::max(1, std::min<int>(args.jobs, frames.size()));
+    size_t bad = 0;
+
+    if (jobs == 1) {
+        decoder dec(args);
+        std::string out;
+        for (size_t i = 0; i < frames.size(); ++i) {
+            if (try_decode(dec, frames[i], args.format, out)) {
+                std::cout << out;
+            } else {
+                report_bad_frame(i, out);
+                ++bad;
+            }
+        }
+        return bad;
     }
-    auto root =
-        get_wire_type(*mod, name{recursive_name_lookup(mod->symbols(), argv[2]).value()});
 
-    std::ifstream datafile(argv[3], std::ios::binary);
-    std::vector<uint8_t> data(std::istreambuf_iterator<char>(datafile),
-                              std::istreambuf_iterator<char>{});
+    std::vector<std::unique_ptr<decoder>> decoders(jobs);
+    for (auto& dec : decoders) {
+        dec = std::make_unique<decoder>(args);
+    }
+
+    // Frames are decoded in batches. Within a batch, every thread decodes an interleaved
+    // share of the frames, and the batch is written out in order once all are done.
+    constexpr size_t batch_size = 4096;
+    std::vector<std::string> outputs(batch_size);
+    // Whether the output of the frame is its decoded form, rather than an error.
+    std::vector<char> decoded(batch_size);
+    for (size_t begin = 0; begin < frames.size(); begin += batch_size) {
+        auto count = std::min(batch_size, frames.size() - begin);
+
+        std::vector<std::thread> threads;
+        threads.reserve(jobs);
+        for (int t = 0; t < jobs; ++t) {
+            threads.emplace_back([&, t] {
+                for (size_t i = t; i < count; i += jobs) {
+                    decoded[i] = try_decode(
+                        *decoders[t], frames[begin + i], args.format, outputs[i]);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (decoded[i]) {
+                std::cout << outputs[i];
+            } else {
+                report_bad_frame(begin + i, outputs[i]);
+                ++bad;
+            }
+        }
+    }
+    return bad;
+}
 
-    lidl::memory_reader reader(data);
+void bin2yaml(const bin2yaml_args& args) {
+    mapped_file file(args.input_path);
 
-    reader.seek(-root->wire_layout(*mod).size());
+    if (args.frames) {
+        if (auto bad = decode_frames(args, split_frames(file.data())); bad != 0) {
+            std::cerr << fmt::format("{} frames could not be decoded\n", bad);
+            exit(1);
+        }
+        return;
+    }
 
-    auto yaml = root->bin2yaml(*mod, reader);
+    decoder dec(args);
 
-    yaml["$lidlmeta"]["root_type"] = argv[2];
+    if (args.format == output_format::json) {
+        std::cout << dec.decode_to_json(file.data());
+        return;
+    }
 
+    auto yaml = dec.decode(file.data());
+    yaml["$lidlmeta"]["root_type"] = args.root_type;
     std::cout << yaml << '\n';
-}
\ No newline at end of file
+}
+} // namespace
+} // namespace lidl
+
+int main(int argc, char** argv) {
+    lidl::bin2yaml_args args;
+    bool help = false;
+    std::string format;
+
+    auto cli =
+        lyra::cli_parser() |
+        lyra::arg(args.schema_path, "schema")("Schema the messages conform to.")
+            .required() |
+        lyra::arg(args.root_type, "root_type")("Type of the root object of messages.")
+            .required() |
+        lyra::arg(args.input_path, "input")("Binary file to decode.").required() |
+        lyra::opt(args.frames)["--frames"](
+            "The input is a capture of 4 byte length prefixed messages.") |
+        lyra::opt(format, "yaml|json")["--format"]("Output format, yaml by default.") |
+        lyra::opt(args.jobs, "jobs")["-j"]["--jobs"](
+            "Number of threads decoding frames in parallel.") |
+        lyra::help(help);
+
+    auto res = cli.parse({argc, argv});
+    if (help) {
+        std::cout << cli << '\n';
+        return 0;
+    }
+
+    if (!res) {
+        std::cerr << res.errorMessage() << '\n' << cli << '\n';
+        return -1;
+    }
+
+    if (format == "json") {
+        args.format = lidl::output_format::json;
+    } else if (!format.empty() && format != "yaml") {
+        std::cerr << fmt::format("Unknown output format: {}\n", format);
+        return -1;
+    }
+
+    std::ios::sync_with_stdio(false);
+    lidl::bin2yaml(args);
+}
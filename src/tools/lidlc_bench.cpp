@@ -0,0 +1,264 @@
+#include "backends.hpp"
+#include "frontend/parser.hpp"
+#include "schemagen.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <lidl/eval/constants.hpp>
+#include <lidl/eval/evaluation.hpp>
+#include <lidl/json.hpp>
+#include <lidl/loader.hpp>
+#include <lidl/module.hpp>
+#include <lidl/structure.hpp>
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+
+#if __has_include(<sys/resource.h>)
+#include <sys/resource.h>
+#define LIDL_HAS_RUSAGE
+#endif
+
+namespace lidl {
+namespace {
+// Names of the phases, in the order they run in.
+constexpr std::string_view phase_names[] = {
+    "parse", "import", "instantiate", "layout", "check", "codegen"};
+constexpr size_t num_phases = std::size(phase_names);
+
+struct phase_result {
+    std::vector<double> millis;
+    // Peak resident set size of the process after the phase, in kilobytes.
+    long peak_rss_kb = 0;
+
+    double min() const {
+        return *std::min_element(millis.begin(), millis.end());
+    }
+
+    double mean() const {
+        double total = 0;
+        for (auto ms : millis) {
+            total += ms;
+        }
+        return total / millis.size();
+    }
+};
+
+long peak_rss_kb() {
+#if defined(LIDL_HAS_RUSAGE)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+std::string read_file(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Looks up the wire type of every member of every structure, which instantiates every
+// generic the schema uses. This is otherwise done lazily by the layout pass.
+void instantiate_all(const module& mod) {
+    for (auto& [_, child] : mod.children) {
+        instantiate_all(*child);
+    }
+
+    for (auto& str : mod.structs) {
+        for (auto& [_, mem] : str->all_members()) {
+            get_wire_type(mod, mem.type_);
+        }
+    }
+}
+
+class bench {
+public:
+    bench(std::filesystem::path dir,
+          schemagen::schema_format format,
+          std::string backend)
+        : m_dir(std::move(dir))
+        , m_format(format)
+        , m_backend(std::move(backend)) {
+    }
+
+    void round(std::array<phase_result, num_phases>& results) {
+        size_t phase = 0;
+        auto time    = [&](auto&& fn) {
+            auto begin = std::chrono::steady_clock::now();
+            fn();
+            auto end = std::chrono::steady_clock::now();
+            results[phase].millis.push_back(
+                std::chrono::duration<double, std::milli>(end - begin).count());
+            results[phase].peak_rss_kb = peak_rss_kb();
+            ++phase;
+        };
+
+        time([&] { parse(); });
+
+        load_context ctx;
+        auto importer = std::make_unique<path_resolver>();
+        importer->add_import_path(m_dir.string());
+        ctx.set_importer(std::move(importer));
+        module* mod = nullptr;
+        time([&] {
+            auto root = m_dir / schemagen::root_file_name(m_format);
+            mod       = ctx.do_import(root.string(), "");
+        });
+        if (!mod) {
+            throw std::runtime_error("Could not load the generated schema");
+        }
+
+        time([&] { instantiate_all(root_module(*mod)); });
+        time([&] { compute_layouts(*mod); });
+        time([&] {
+            eval::check_constants(root_module(*mod));
+            eval::check_static_assertions(root_module(*mod));
+        });
+        time([&] {
+            codegen::output out;
+            out.output_path = (m_dir / "generated.out").string();
+            backends.at(m_backend)()->generate(*mod, out);
+        });
+    }
+
+private:
+    // Parses every file of the schema on its own, without resolving any names.
+    void parse() {
+        for (auto& entry : std::filesystem::directory_iterator(m_dir)) {
+            auto ext = entry.path().extension();
+            if (ext == ".lidl") {
+                if (!frontend::parse_module(read_file(entry.path()))) {
+                    throw std::runtime_error("Could not parse " + entry.path().string());
+                }
+            } else if (ext == ".yaml") {
+                YAML::Load(read_file(entry.path()));
+            }
+        }
+    }
+
+    std::filesystem::path m_dir;
+    schemagen::schema_format m_format;
+    std::string m_backend;
+};
+
+std::string to_json(const schemagen::schema_params& params,
+                    std::string_view format,
+                    const std::array<phase_result, num_phases>& results) {
+    std::string res;
+    json_writer writer(res);
+    writer.begin_object();
+    writer.key("schema");
+    writer.begin_object();
+    writer.key("format");
+    writer.value(format);
+    writer.key("types");
+    writer.value(int64_t(params.types));
+    writer.key("depth");
+    writer.value(int64_t(params.depth));
+    writer.key("generic_instantiations");
+    writer.value(int64_t(params.generic_instantiations));
+    writer.key("services");
+    writer.value(int64_t(params.services));
+    writer.key("procedures");
+    writer.value(int64_t(params.procedures));
+    writer.key("imports");
+    writer.value(int64_t(params.imports));
+    writer.end_object();
+    writer.key("phases");
+    writer.begin_array();
+    for (size_t i = 0; i < num_phases; ++i) {
+        writer.begin_object();
+        writer.key("name");
+        writer.value(phase_names[i]);
+        writer.key("min_ms");
+        writer.value(results[i].min());
+        writer.key("mean_ms");
+        writer.value(results[i].mean());
+        writer.key("peak_rss_kb");
+        writer.value(int64_t(results[i].peak_rss_kb));
+        writer.end_object();
+    }
+    writer.end_array();
+    writer.end_object();
+    return res;
+}
+} // namespace
+} // namespace lidl
+
+int main(int argc, char** argv) {
+    lidl::schemagen::schema_params params;
+    std::string format = "lidl";
+    std::string backend = "cpp";
+    std::string json_path;
+    int rounds = 5;
+    bool help  = false;
+
+    auto cli = lidl::schemagen::schema_options(params, format) |
+               lyra::opt(rounds, "rounds")["--rounds"]("Number of times to compile.") |
+               lyra::opt(backend, "backend")["-g"]["--backend"]("Backend to use.") |
+               lyra::opt(json_path, "file")["--json"]("Write the results as JSON.") |
+               lyra::help(help);
+    auto res = cli.parse({argc, argv});
+
+    if (help) {
+        std::cout << cli << '\n';
+        return 0;
+    }
+
+    if (!res) {
+        std::cerr << res.errorMessage() << '\n';
+        return -1;
+    }
+
+    auto schema_format = lidl::schemagen::parse_format(format);
+    if (!schema_format) {
+        std::cerr << "Unknown schema format: " << format << '\n';
+        return -1;
+    }
+
+    if (lidl::backends.find(backend) == lidl::backends.end()) {
+        std::cerr << "Unknown backend: " << backend << '\n';
+        return -1;
+    }
+
+    if (rounds <= 0) {
+        std::cerr << "Need at least one round\n";
+        return -1;
+    }
+
+    auto dir = std::filesystem::temp_directory_path() /
+               fmt::format("lidlc_bench_{}",
+                           std::chrono::steady_clock::now().time_since_epoch().count());
+    std::filesystem::create_directories(dir);
+    for (auto& [file_name, contents] : generate_schema(params, *schema_format)) {
+        std::ofstream(dir / file_name) << contents;
+    }
+
+    std::array<lidl::phase_result, lidl::num_phases> results;
+    lidl::bench bench(dir, *schema_format, backend);
+    for (int i = 0; i < rounds; ++i) {
+        bench.round(results);
+    }
+
+    std::filesystem::remove_all(dir);
+
+    std::cout << fmt::format(
+        "{:<12} {:>10} {:>10} {:>14}\n", "phase", "min ms", "mean ms", "peak rss kb");
+    for (size_t i = 0; i < lidl::num_phases; ++i) {
+        std::cout << fmt::format("{:<12} {:>10.3f} {:>10.3f} {:>14}\n",
+                                 lidl::phase_names[i],
+                                 results[i].min(),
+                                 results[i].mean(),
+                                 results[i].peak_rss_kb);
+    }
+
+    if (!json_path.empty()) {
+        std::ofstream(json_path) << lidl::to_json(params, format, results) << '\n';
+    }
+}
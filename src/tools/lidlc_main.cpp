@@ -1,3 +1,4 @@
+#include "backends.hpp"
 #include "lidl/union.hpp"
 
 #include <codegen.hpp>
@@ -7,50 +8,28 @@
 #include <gsl/span>
 #include <iostream>
 #include <lidl/basic.hpp>
+#include <lidl/eval/constants.hpp>
+#include <lidl/eval/evaluation.hpp>
 #include <lidl/loader.hpp>
+#include <lidl/time_report.hpp>
 #include <lyra/lyra.hpp>
 #include <string_view>
 #include <yaml.hpp>
 
 namespace lidl {
-#if defined(ENABLE_CPP)
-namespace cpp {
-std::unique_ptr<codegen::backend> make_backend();
-}
-#endif
-#if defined(ENABLE_JS)
-namespace js {
-std::unique_ptr<codegen::backend> make_backend();
-}
-#endif
-#if defined(ENABLE_PY)
-namespace py {
-std::unique_ptr<codegen::backend> make_backend();
-}
-#endif
-std::unordered_map<std::string_view, std::function<std::unique_ptr<codegen::backend>()>>
-    backends {
-#if defined(ENABLE_CPP)
-    {"cpp", cpp::make_backend},
-#endif
-#if defined(ENABLE_JS)
-        {"js", js::make_backend}, {"ts", js::make_backend},
-#endif
-#if defined(ENABLE_PY)
-        {"py", py::make_backend},
-#endif
-};
-
 struct lidlc_args {
     std::istream* input_stream;
     lidl::codegen::output output;
     std::string backend;
     std::optional<std::string> origin;
     std::vector<std::string> import_paths;
-    bool just_details = false;
+    bool just_details    = false;
+    bool reorder_members = false;
 };
 
 void run(const lidlc_args& args) {
+    time_report::phase lidlc_phase("lidlc");
+
     auto importer = std::make_unique<lidl::path_resolver>();
     for (auto& path : args.import_paths) {
         importer->add_import_path(path);
@@ -78,6 +57,32 @@ void run(const lidlc_args& args) {
         return;
     }
 
+    if (args.reorder_members) {
+        enable_member_reordering(root_module(*mod));
+    }
+
+    {
+        time_report::phase layout_phase("layout");
+        compute_layouts(*mod);
+    }
+
+    {
+        time_report::phase check_phase("check");
+        eval::check_constants(root_module(*mod));
+        eval::check_static_assertions(root_module(*mod));
+    }
+
+    for (auto& report : report_member_reordering(*mod)) {
+        if (report.reordered_size >= report.declared_size) {
+            continue;
+        }
+        std::cerr << fmt::format("Reordered {}: {} -> {} bytes, saved {}\n",
+                                 report.type_name,
+                                 report.declared_size,
+                                 report.reordered_size,
+                                 report.declared_size - report.reordered_size);
+    }
+
     auto backend_maker = backends.find(args.backend);
     if (backend_maker == backends.end()) {
         std::cerr << fmt::format("Unknown backend: {}\n", args.backend);
@@ -89,6 +94,7 @@ void run(const lidlc_args& args) {
         exit(1);
     }
 
+    time_report::phase codegen_phase("codegen", args.backend);
     auto backend = backend_maker->second();
     backend->generate(*mod, args.output);
 }
@@ -99,9 +105,12 @@ int main(int argc, char** argv) {
     bool help            = false;
     bool read_from_stdin = false;
     bool build_details   = false;
+    bool reorder_members = false;
     std::string input_path;
     std::string out_path;
     std::string backend;
+    std::string time_report_format;
+    std::string time_report_path;
     std::vector<std::string> import_paths;
     auto cli =
         lyra::cli_parser() |
@@ -116,6 +125,15 @@ int main(int argc, char** argv) {
             .optional() |
         lyra::opt(backend, "backend")["-g"]["--backend"]("Backend to use.") |
         lyra::opt(build_details, "build details")["-d"].optional() |
+        lyra::opt(reorder_members)["--reorder-members"](
+            "Reorder the members of every structure to minimize padding.")
+            .optional() |
+        lyra::opt(time_report_format, "table|trace")["--time-report"](
+            "Report the time spent in every phase of the compilation, as a table or as "
+            "a Chrome trace.")
+            .choices("table", "trace") |
+        lyra::opt(time_report_path, "report file")["--time-report-file"](
+            "File to write the time report to, instead of the standard error.") |
         lyra::opt(version)["--version"]("Print lidl version") | lyra::help(help);
     auto res = cli.parse({argc, argv});
 
@@ -140,6 +158,10 @@ int main(int argc, char** argv) {
         return -1;
     }
 
+    if (!time_report_format.empty()) {
+        lidl::time_report::enable();
+    }
+
     lidl::lidlc_args args;
     args.input_stream = &std::cin;
     if (!out_path.empty()) {
@@ -158,10 +180,22 @@ int main(int argc, char** argv) {
     args.backend = std::move(backend);
 
     args.import_paths = std::move(import_paths);
-    args.just_details = build_details;
+    args.just_details    = build_details;
+    args.reorder_members = reorder_members;
 
     lidl::run(args);
 
+    if (lidl::time_report::enabled()) {
+        auto report = time_report_format == "trace"
+                          ? lidl::time_report::format_chrome_trace()
+                          : lidl::time_report::format_table();
+        if (time_report_path.empty()) {
+            std::cerr << report << '\n';
+        } else {
+            std::ofstream(time_report_path) << report << '\n';
+        }
+    }
+
     if (!input_path.empty()) {
         delete args.input_stream;
     }
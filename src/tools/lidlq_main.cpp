@@ -1,9 +1,11 @@
 #include <filesystem>
+#include <fmt/format.h>
 #include <iostream>
 #include <lidl/basic.hpp>
 #include <lidl/loader.hpp>
 #include <lidl/module.hpp>
 #include <lyra/lyra.hpp>
+#include <yaml-cpp/yaml.h>
 
 namespace {
 enum class output_format
@@ -27,6 +29,58 @@ struct list_services : query_base {
     }
 };
 
+struct layout_query : query_base {
+    explicit layout_query(std::optional<std::string> filter)
+        : m_filter{std::move(filter)} {
+    }
+
+    void perform(const lidl::module& mod, output_format format) override {
+        lidl::compute_layouts(mod);
+
+        YAML::Node res;
+        for (auto& str : mod.structs) {
+            add(res, mod, str.get(), str->layout(mod));
+        }
+        for (auto& u : mod.unions) {
+            add(res, mod, u.get(), u->layout(mod));
+        }
+        std::cout << res << '\n';
+    }
+
+private:
+    void add(YAML::Node& res,
+             const lidl::module& mod,
+             const lidl::base* type,
+             const lidl::compound_layout& layout) {
+        auto sym = recursive_definition_lookup(root_module(mod).get_scope(), type);
+        if (!sym) {
+            return;
+        }
+
+        auto name = fmt::format("{}", fmt::join(lidl::absolute_name(*sym), "::"));
+        if (m_filter && name != *m_filter && lidl::local_name(*sym) != *m_filter) {
+            return;
+        }
+
+        YAML::Node node;
+        node["size"]      = layout.get().size();
+        node["alignment"] = layout.get().alignment();
+        node["padding"]   = layout.padding_bytes();
+        for (auto& mem : layout.members()) {
+            YAML::Node mem_node;
+            mem_node["name"]           = mem.name;
+            mem_node["offset"]         = mem.offset;
+            mem_node["size"]           = mem.size;
+            mem_node["alignment"]      = mem.alignment;
+            mem_node["padding_before"] = mem.padding_before;
+            node["members"].push_back(mem_node);
+        }
+        res[name] = node;
+    }
+
+    std::optional<std::string> m_filter;
+};
+
 struct lidlq_args {
     std::string input_path;
     std::vector<std::string> import_paths;
@@ -56,18 +110,27 @@ void run(const lidlq_args& args) {
 } // namespace
 
 int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: lidlq <services|layout> [options]\n";
+        return -1;
+    }
+
     std::string verb = argv[1];
 
     bool help = false;
     std::string input_path;
+    std::string type_name;
     std::vector<std::string> import_paths;
     auto cli =
         lyra::cli_parser() |
         lyra::opt(input_path, "input")["-f"]["--input-file"]("Input file to read from.")
             .optional() |
         lyra::opt(import_paths, "import_paths")["-I"]("Import prefixes") |
+        lyra::opt(type_name, "type")["-t"]["--type"](
+            "Only print the layout of the given type.")
+            .optional() |
         lyra::help(help);
-    auto res = cli.parse({argc - 2, argv + 2});
+    auto res = cli.parse({argc - 1, argv + 1});
 
     if (!res) {
         std::cerr << res.errorMessage() << '\n';
@@ -84,7 +147,16 @@ int main(int argc, char** argv) {
 
     args.input_path   = path.string();
     args.import_paths = import_paths;
-    args.query        = std::make_unique<list_services>();
+
+    if (verb == "services") {
+        args.query = std::make_unique<list_services>();
+    } else if (verb == "layout") {
+        args.query = std::make_unique<layout_query>(
+            type_name.empty() ? std::nullopt : std::optional<std::string>(type_name));
+    } else {
+        std::cerr << fmt::format("Unknown query: {}\n", verb);
+        return -1;
+    }
 
     run(args);
 }
\ No newline at end of file
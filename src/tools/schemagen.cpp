@@ -0,0 +1,270 @@
+#include "schemagen.hpp"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+namespace lidl::schemagen {
+namespace {
+// A type as written in a schema. Integer generic arguments are stored as names too,
+// since both formats spell them the same way.
+struct type_ref {
+    std::string name;
+    std::vector<type_ref> args{};
+};
+
+struct member_def {
+    std::string name;
+    type_ref type;
+};
+
+struct struct_def {
+    std::string name;
+    // Generic parameters, empty for regular structures.
+    std::vector<std::string> params{};
+    std::vector<member_def> members{};
+};
+
+struct procedure_def {
+    std::string name;
+    std::vector<member_def> params;
+    type_ref return_type;
+};
+
+struct service_def {
+    std::string name;
+    std::vector<procedure_def> procedures{};
+};
+
+struct module_def {
+    std::string file_stem;
+    std::string name_space;
+    std::vector<std::string> imports{};
+    std::vector<struct_def> structs{};
+    std::vector<service_def> services{};
+};
+
+std::string type_name(int i) {
+    return fmt::format("type_{}", i);
+}
+
+std::vector<struct_def> make_structs(const schema_params& params,
+                                     const std::vector<std::string>& imported_spaces) {
+    std::vector<struct_def> res;
+    for (int i = 0; i < params.types; ++i) {
+        struct_def str{type_name(i)};
+        str.members = {
+            {"id", {"u32"}},
+            {"value", {"f64"}},
+            {"name", {"string"}},
+            {"data", {"vector", {{"u8"}}}},
+        };
+
+        bool chain_head = params.depth <= 1 || i % params.depth == 0;
+        if (!chain_head) {
+            str.members.push_back({"inner", {type_name(i - 1)}});
+        } else if (!imported_spaces.empty()) {
+            auto& space = imported_spaces[i / std::max(params.depth, 1) %
+                                          imported_spaces.size()];
+            str.members.push_back(
+                {"imported",
+                 {fmt::format("{}::{}", space, type_name(params.types - 1))}});
+        }
+
+        res.push_back(std::move(str));
+    }
+    return res;
+}
+
+void add_generics(const schema_params& params, module_def& mod) {
+    if (params.generic_instantiations <= 0 || params.types <= 0) {
+        return;
+    }
+
+    mod.structs.push_back({"duo", {"T", "U"}, {{"first", {"T"}}, {"second", {"U"}}}});
+
+    // Pairs of distinct structures make distinct instantiations, up to types^2 of them.
+    for (int i = 0; i < params.generic_instantiations; ++i) {
+        auto first  = type_name(i % params.types);
+        auto second = type_name(i / params.types % params.types);
+        mod.structs.push_back(
+            {fmt::format("generic_holder_{}", i),
+             {},
+             {{"value", {"duo", {{first}, {second}}}}}});
+    }
+}
+
+void add_services(const schema_params& params, module_def& mod) {
+    for (int i = 0; i < params.services; ++i) {
+        service_def serv{fmt::format("service_{}", i)};
+        for (int j = 0; j < params.procedures; ++j) {
+            auto ret = params.types > 0
+                           ? type_name((i * params.procedures + j) % params.types)
+                           : std::string("u32");
+            serv.procedures.push_back({fmt::format("proc_{}", j),
+                                       {{"id", {"u32"}}, {"name", {"string_view"}}},
+                                       {ret}});
+        }
+        mod.services.push_back(std::move(serv));
+    }
+}
+
+std::vector<module_def> make_modules(const schema_params& params) {
+    std::vector<module_def> res;
+
+    std::vector<std::string> imported_spaces;
+    for (int i = 0; i < params.imports; ++i) {
+        module_def dep{fmt::format("dep_{}", i), fmt::format("bench::dep_{}", i)};
+        dep.structs = make_structs(params, {});
+        imported_spaces.push_back(dep.name_space);
+        res.push_back(std::move(dep));
+    }
+
+    module_def root{"root", "bench"};
+    for (auto& dep : res) {
+        root.imports.push_back(dep.file_stem);
+    }
+    root.structs = make_structs(params, imported_spaces);
+    add_generics(params, root);
+    add_services(params, root);
+    res.push_back(std::move(root));
+
+    return res;
+}
+
+std::string to_lidl(const type_ref& type) {
+    if (type.args.empty()) {
+        return type.name;
+    }
+    std::vector<std::string> args;
+    for (auto& arg : type.args) {
+        args.push_back(to_lidl(arg));
+    }
+    return fmt::format("{}<{}>", type.name, fmt::join(args, ", "));
+}
+
+std::string to_lidl(const module_def& mod) {
+    std::string res = fmt::format("namespace {};\n\n", mod.name_space);
+
+    for (auto& import : mod.imports) {
+        res += fmt::format("import \"./{}.lidl\";\n", import);
+    }
+
+    for (auto& str : mod.structs) {
+        auto params =
+            str.params.empty() ? "" : fmt::format("<{}>", fmt::join(str.params, ", "));
+        res += fmt::format("\nstruct{} {} {{\n", params, str.name);
+        for (auto& mem : str.members) {
+            res += fmt::format("    {}: {};\n", mem.name, to_lidl(mem.type));
+        }
+        res += "}\n";
+    }
+
+    for (auto& serv : mod.services) {
+        res += fmt::format("\nservice {} {{\n", serv.name);
+        for (auto& proc : serv.procedures) {
+            std::vector<std::string> params;
+            for (auto& param : proc.params) {
+                params.push_back(fmt::format("{}: {}", param.name, to_lidl(param.type)));
+            }
+            res += fmt::format("    {}({}) -> {};\n",
+                               proc.name,
+                               fmt::join(params, ", "),
+                               to_lidl(proc.return_type));
+        }
+        res += "}\n";
+    }
+
+    return res;
+}
+
+// Generic arguments are plain names in YAML modules, so only the outermost type may
+// have arguments.
+YAML::Node to_yaml(const type_ref& type) {
+    if (type.args.empty()) {
+        return YAML::Node(type.name);
+    }
+    YAML::Node res;
+    res["name"] = type.name;
+    for (auto& arg : type.args) {
+        res["parameters"].push_back(arg.name);
+    }
+    return res;
+}
+
+YAML::Node to_yaml_member(const type_ref& type) {
+    if (type.args.empty()) {
+        return to_yaml(type);
+    }
+    YAML::Node res;
+    res["type"] = to_yaml(type);
+    return res;
+}
+
+std::string to_yaml(const module_def& mod) {
+    YAML::Node res;
+    res["$lidlmeta"]["name"] = mod.name_space;
+    for (auto& import : mod.imports) {
+        res["$lidlmeta"]["imports"].push_back(fmt::format("./{}.yaml", import));
+    }
+
+    for (auto& str : mod.structs) {
+        YAML::Node node;
+        node["type"] = str.params.empty() ? "structure" : "generic<structure>";
+        for (auto& param : str.params) {
+            node["parameters"][param] = "type";
+        }
+        for (auto& mem : str.members) {
+            node["members"][mem.name] = to_yaml_member(mem.type);
+        }
+        res[str.name] = node;
+    }
+
+    for (auto& serv : mod.services) {
+        YAML::Node node;
+        node["type"] = "service";
+        for (auto& proc : serv.procedures) {
+            YAML::Node proc_node;
+            proc_node["returns"].push_back(to_yaml(proc.return_type));
+            for (auto& param : proc.params) {
+                proc_node["parameters"][param.name] = to_yaml(param.type);
+            }
+            node["procedures"][proc.name] = proc_node;
+        }
+        res[serv.name] = node;
+    }
+
+    YAML::Emitter out;
+    out << res;
+    return std::string(out.c_str()) + '\n';
+}
+} // namespace
+
+std::string root_file_name(schema_format format) {
+    return format == schema_format::lidl ? "root.lidl" : "root.yaml";
+}
+
+std::optional<schema_format> parse_format(std::string_view name) {
+    if (name == "lidl") {
+        return schema_format::lidl;
+    }
+    if (name == "yaml") {
+        return schema_format::yaml;
+    }
+    return {};
+}
+
+std::map<std::string, std::string> generate_schema(const schema_params& params,
+                                                   schema_format format) {
+    std::map<std::string, std::string> res;
+    for (auto& mod : make_modules(params)) {
+        if (format == schema_format::lidl) {
+            res.emplace(mod.file_stem + ".lidl", to_lidl(mod));
+        } else {
+            res.emplace(mod.file_stem + ".yaml", to_yaml(mod));
+        }
+    }
+    return res;
+}
+} // namespace lidl::schemagen
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <lyra/lyra.hpp>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace lidl::schemagen {
+enum class schema_format
+{
+    lidl,
+    yaml
+};
+
+struct schema_params {
+    // Number of structures in every module.
+    int types = 100;
+    // Structures contain each other in chains of this length.
+    int depth = 4;
+    // Number of distinct instantiations of a generic structure in the root module.
+    int generic_instantiations = 20;
+    int services   = 4;
+    int procedures = 8;
+    // Number of modules the root module imports. Every imported module has its own set
+    // of structures, some of which the root module refers to.
+    int imports = 0;
+};
+
+/**
+ * Generates a synthetic schema of the given scale for benchmarking the compiler.
+ * Returns the contents of every file of the schema by its file name. The root module
+ * is in root.lidl or root.yaml.
+ */
+std::map<std::string, std::string> generate_schema(const schema_params& params,
+                                                   schema_format format);
+
+std::string root_file_name(schema_format format);
+
+std::optional<schema_format> parse_format(std::string_view name);
+
+/**
+ * Command line options that set the scale and format of a generated schema.
+ */
+inline lyra::cli_parser schema_options(schema_params& params, std::string& format) {
+    return lyra::cli_parser() |
+           lyra::opt(params.types, "types")["--types"]("Structures per module.") |
+           lyra::opt(params.depth, "depth")["--depth"]("Nesting depth of structures.") |
+           lyra::opt(params.generic_instantiations, "instantiations")["--generics"](
+               "Distinct generic instantiations.") |
+           lyra::opt(params.services, "services")["--services"]("Number of services.") |
+           lyra::opt(params.procedures, "procedures")["--procedures"](
+               "Procedures per service.") |
+           lyra::opt(params.imports, "imports")["--imports"](
+               "Modules imported by the root module.") |
+           lyra::opt(format, "format")["--format"]("Schema format, lidl or yaml.");
+}
+} // namespace lidl::schemagen
@@ -0,0 +1,46 @@
+#include "schemagen.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    lidl::schemagen::schema_params params;
+    std::string format = "lidl";
+    std::string out_dir;
+    bool help = false;
+
+    auto cli = lidl::schemagen::schema_options(params, format) |
+               lyra::opt(out_dir, "directory")["-o"]["--output-dir"](
+                   "Directory to write the schema files to.")
+                   .required() |
+               lyra::help(help);
+    auto res = cli.parse({argc, argv});
+
+    if (help) {
+        std::cout << cli << '\n';
+        return 0;
+    }
+
+    if (!res) {
+        std::cerr << res.errorMessage() << '\n';
+        return -1;
+    }
+
+    auto schema_format = lidl::schemagen::parse_format(format);
+    if (!schema_format) {
+        std::cerr << "Unknown schema format: " << format << '\n';
+        return -1;
+    }
+
+    std::filesystem::create_directories(out_dir);
+    for (auto& [file_name, contents] : generate_schema(params, *schema_format)) {
+        auto path = std::filesystem::path(out_dir) / file_name;
+        std::ofstream file(path);
+        file << contents;
+        if (!file.good()) {
+            std::cerr << "Could not write " << path << '\n';
+            return 1;
+        }
+    }
+}
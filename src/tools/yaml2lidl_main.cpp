@@ -3,26 +3,13 @@
 //
 
 #include <fstream>
+#include <lidl/json.hpp>
 #include <lidl/loader.hpp>
 #include <lidl/module.hpp>
 #include <lidlrt/buffer.hpp>
 #include <yaml-cpp/yaml.h>
 #include <yaml.hpp>
 
-struct ostream_writer : lidl::ibinary_writer {
-    std::ostream* str;
-    int written = 0;
-
-    void write_raw(gsl::span<const char> data) override {
-        str->write(data.data(), data.size());
-        written += data.size();
-    }
-
-    int tell() override {
-        return written;
-    }
-};
-
 struct yaml2lidl_args {
     std::string root_type;
     std::string schema_path;
@@ -35,11 +22,28 @@ void yaml2lidl(yaml2lidl_args args) {
     auto root_mod = std::make_unique<module>();
     root_mod->add_child("", basic_module());
 
+    // JSON inputs are converted without going through a YAML document.
+    auto is_json = std::string_view(args.yaml_path).ends_with(".json");
+
     std::ifstream datafile(args.yaml_path);
-    YAML::Node yaml_root = YAML::Load(datafile);
-    if (auto meta = yaml_root["$lidlmeta"]; meta) {
-        if (auto root = meta["root_type"]; root) {
-            args.root_type = root.as<std::string>();
+    std::string json_text;
+    std::optional<json_document> json_root;
+    YAML::Node yaml_root;
+    if (is_json) {
+        json_text.assign(std::istreambuf_iterator<char>(datafile),
+                         std::istreambuf_iterator<char>{});
+        json_root = json_document::parse(json_text);
+        if (auto meta = json_root->root().find("$lidlmeta"); meta) {
+            if (auto root = meta->find("root_type"); root) {
+                args.root_type = root->as_string();
+            }
+        }
+    } else {
+        yaml_root = YAML::Load(datafile);
+        if (auto meta = yaml_root["$lidlmeta"]; meta) {
+            if (auto root = meta["root_type"]; root) {
+                args.root_type = root.as<std::string>();
+            }
         }
     }
 
@@ -68,16 +72,21 @@ void yaml2lidl(yaml2lidl_args args) {
     auto root = dynamic_cast<const type*>(
         get_symbol(*recursive_name_lookup(mod->symbols(), args.root_type)));
 
-    ostream_writer output;
-    output.str = &std::cout;
+    binary_writer output;
+    if (json_root) {
+        root->json2bin(*mod, json_root->root(), output);
+    } else {
+        root->yaml2bin(*mod, yaml_root, output);
+    }
 
-    root->yaml2bin(*mod, yaml_root, output);
+    auto data = output.get();
+    std::cout.write(reinterpret_cast<const char*>(data.data()), data.size());
 }
 
 int main(int argc, char** argv) {
     if (argc < 2) {
-        std::cerr << fmt::format("Usage {} path_to_yaml path_to_schema [root_type]\n",
-                                 argv[1]);
+        std::cerr << fmt::format(
+            "Usage {} path_to_yaml_or_json path_to_schema [root_type]\n", argv[1]);
     }
 
     yaml2lidl_args args;
@@ -1,14 +1,14 @@
 #include <cassert>
+#include <lidl/generics.hpp>
 #include <lidl/module.hpp>
 #include <lidl/union.hpp>
 
 namespace lidl {
 raw_layout union_type::wire_layout(const lidl::module& mod) const {
-    auto overall_computer = layout(mod);
-    return overall_computer.get();
+    return layout(mod).get();
 }
 
-YAML::Node union_type::bin2yaml(const module& mod, ibinary_reader& reader) const {
+YAML::Node union_type::bin2yaml(const module& mod, binary_reader& reader) const {
     if (raw) {
         std::cerr << "[WARN]"
                   << " Cannot determine the type of a raw union. Skipping the field\n";
@@ -17,21 +17,47 @@ YAML::Node union_type::bin2yaml(const module& mod, ibinary_reader& reader) const
     YAML::Node node;
 
     const auto& enumerator = get_enum(mod);
-    auto enum_layout       = enumerator.wire_layout(mod);
+    auto begin             = reader.tell();
 
     auto alternative_node = enumerator.bin2yaml(mod, reader);
     int alternative       = enumerator.find_by_name(alternative_node.as<std::string>());
 
-    reader.seek(enum_layout.size());
-
     auto& [name, member] = members[alternative];
     auto member_type     = lidl::get_wire_type(mod, member.type_);
-    reader.align(member_type->wire_layout(mod).alignment());
+    reader.seek(begin + layout(mod).offset_of("val").value(), std::ios::beg);
     node[name] = member_type->bin2yaml(mod, reader);
 
     return node;
 }
 
+void union_type::bin2json(const module& mod,
+                          binary_reader& reader,
+                          json_writer& writer) const {
+    if (raw) {
+        std::cerr << "[WARN]"
+                  << " Cannot determine the type of a raw union. Skipping the field\n";
+        return writer.null();
+    }
+
+    const auto& enumerator = get_enum(mod);
+    auto begin             = reader.tell();
+
+    auto alternative = enumerator.read_value(mod, reader);
+    if (alternative < 0 || size_t(alternative) >= members.size()) {
+        throw std::runtime_error("unknown union alternative");
+    }
+
+    auto& [name, member] = members[alternative];
+    auto member_type     = lidl::get_wire_type(mod, member.type_);
+    // Every alternative is at the offset of the largest one.
+    reader.seek(begin + layout(mod).offset_of("val").value(), std::ios::beg);
+
+    writer.begin_object();
+    writer.key(name);
+    member_type->bin2json(mod, reader, writer);
+    writer.end_object();
+}
+
 type_categories union_type::category(const module& mod) const {
     return std::any_of(members.begin(),
                        members.end(),
@@ -55,7 +81,7 @@ const enumeration& union_type::get_enum(const module& m) const {
 
 int union_type::yaml2bin(const module& mod,
                          const YAML::Node& node,
-                         ibinary_writer& writer) const {
+                         binary_writer& writer) const {
     if (node.size() != 1) {
         throw std::runtime_error("Union does not have exactly 1 member!");
     }
@@ -68,30 +94,83 @@ int union_type::yaml2bin(const module& mod,
 
     int pointee_pos = 0;
     if (t->is_reference_type(mod)) {
-        auto pointee      = std::get<name>(mem.type_.args[0].get_variant());
-        auto pointee_type = lidl::get_wire_type(mod, pointee);
-        writer.align(pointee_type->wire_layout(mod).alignment());
+        auto pointee_type = lidl::get_pointee_type(mod, mem.type_);
         pointee_pos = pointee_type->yaml2bin(mod, node.begin()->second, writer);
     }
 
-    writer.align(wire_layout(mod).alignment());
+    auto union_layout = wire_layout(mod);
+    writer.align(union_layout.alignment());
     auto pos = writer.tell();
 
     YAML::Node enumerator_val(enum_index);
     enumerator.yaml2bin(mod, enumerator_val, writer);
 
+    writer.pad_to(pos + layout(mod).offset_of("val").value());
     if (!t->is_reference_type(mod)) {
-        writer.align(t->wire_layout(mod).alignment());
         t->yaml2bin(mod, node.begin()->second, writer);
     } else {
         YAML::Node ptr_node(pointee_pos);
         t->yaml2bin(mod, ptr_node, writer);
     }
+    writer.pad_to(pos + union_layout.size());
+
+    return pos;
+}
+
+int union_type::json2bin(const module& mod,
+                         const json_value& value,
+                         binary_writer& writer) const {
+    if (value.size() != 1) {
+        throw std::runtime_error("Union does not have exactly 1 member!");
+    }
+
+    std::string active_member;
+    std::optional<json_value> active_value;
+    value.for_each_member([&](std::string key, const json_value& val) {
+        active_member = std::move(key);
+        active_value  = val;
+    });
+
+    const auto& enumerator = get_enum(mod);
+    auto enum_index        = enumerator.find_by_name(active_member);
+    if (enum_index < 0) {
+        throw std::runtime_error(
+            fmt::format("Union has no member named \"{}\"", active_member));
+    }
+
+    auto& [mem_name, mem] = members[enum_index];
+    auto t                = lidl::get_wire_type(mod, mem.type_);
+
+    int pointee_pos = 0;
+    if (t->is_reference_type(mod)) {
+        auto pointee_type = lidl::get_pointee_type(mod, mem.type_);
+        pointee_pos       = pointee_type->json2bin(mod, *active_value, writer);
+    }
+
+    auto union_layout = wire_layout(mod);
+    writer.align(union_layout.alignment());
+    auto pos = writer.tell();
+
+    enumerator.write_value(mod, enum_index, writer);
+
+    // Every alternative is at the offset of the largest one, and smaller ones are
+    // padded to the size of the union.
+    writer.pad_to(pos + layout(mod).offset_of("val").value());
+    if (!t->is_reference_type(mod)) {
+        t->json2bin(mod, *active_value, writer);
+    } else {
+        pointer_type::write(writer, pointee_pos);
+    }
+    writer.pad_to(pos + union_layout.size());
 
     return pos;
 }
 
-compound_layout union_type::layout(const module& mod) const {
+const compound_layout& union_type::layout(const module& mod) const {
+    if (m_layout) {
+        return *m_layout;
+    }
+
     union_layout_computer computer;
     for (auto& [name, member] : members) {
         computer.add(lidl::get_wire_type(mod, member.type_)->wire_layout(mod));
@@ -102,7 +181,8 @@ compound_layout union_type::layout(const module& mod) const {
         overall_computer.add_member("discriminator", get_enum(mod).wire_layout(mod));
     }
     overall_computer.add_member("val", computer.get());
-    return overall_computer;
+    m_layout = std::move(overall_computer);
+    return *m_layout;
 }
 name union_type::get_wire_type_name_impl(const module& mod, const name& your_name) const {
     get_enum(mod);
@@ -11,6 +11,7 @@
 #include <lidl/generics.hpp>
 #include <lidl/loader.hpp>
 #include <lidl/service.hpp>
+#include <lidl/time_report.hpp>
 #include <lidl/types.hpp>
 #include <lidl/union.hpp>
 #include <stdexcept>
@@ -26,6 +27,14 @@ public:
     }
 };
 
+class invalid_alignment_error : public error {
+public:
+    invalid_alignment_error(int64_t alignment, std::optional<source_info> inf)
+        : error(fmt::format("Alignment must be a power of two, got {}", alignment),
+                std::move(inf)) {
+    }
+};
+
 class yaml_loader final : public module_loader {
     std::optional<source_info> make_source_info(const YAML::Node& node) {
         auto&& mark = node.Mark();
@@ -117,13 +126,27 @@ class yaml_loader final : public module_loader {
         return p;
     }
 
-    static void read_member_attributes(const YAML::Node& attrib_node, member& mem) {
+    size_t read_alignment(const YAML::Node& node) {
+        auto alignment = node.as<int64_t>();
+        if (alignment <= 0 || (alignment & (alignment - 1)) != 0) {
+            throw invalid_alignment_error(alignment, make_source_info(node));
+        }
+        return static_cast<size_t>(alignment);
+    }
+
+    void read_member_attributes(const YAML::Node& attrib_node, member& mem) {
         if (!attrib_node) {
             return;
         }
         if (auto&& nullable = attrib_node["nullable"]) {
             mem.nullable = nullable.as<bool>();
         }
+        if (auto&& alignment = attrib_node["align"]) {
+            mem.alignment = read_alignment(alignment);
+        }
+        if (auto&& cold = attrib_node["cold"]) {
+            mem.cold = cold.as<bool>();
+        }
     }
 
     member read_member(const YAML::Node& node, base& s) {
@@ -146,9 +169,23 @@ class yaml_loader final : public module_loader {
         return m;
     }
 
+    void read_structure_attributes(const YAML::Node& attrib_node, structure& str) {
+        if (!attrib_node) {
+            return;
+        }
+        if (auto&& reorder = attrib_node["reorder"]) {
+            str.set_reorder_members(reorder.as<bool>());
+        }
+        if (auto&& alignment = attrib_node["align"]) {
+            str.set_alignment(read_alignment(alignment));
+        }
+    }
+
     std::unique_ptr<structure> read_structure(const YAML::Node& node, base& scop) {
         auto s = std::make_unique<structure>(&scop, make_source_info(node));
 
+        read_structure_attributes(node["attributes"], *s);
+
         auto members = node["members"];
         if (!members) {
             throw missing_node_error("members", make_source_info(node));
@@ -277,6 +314,9 @@ public:
         , m_origin{std::move(origin)} {
         auto meta = get_metadata();
         m_mod     = &m_root->get_child(meta.name ? *meta.name : std::string("module"));
+        m_mod->src_info = source_info{
+            .origin = m_origin
+        };
     }
 
     module& get_module() override {
@@ -331,7 +371,9 @@ public:
 
             if (type_str == "structure") {
                 m_mod->structs.emplace_back(read_structure(val, *m_mod));
-                define(m_mod->symbols(), name, m_mod->structs.back().get());
+                auto& str = *m_mod->structs.back();
+                define(m_mod->symbols(), name, &str);
+                split_cold_members(*m_mod, str, name);
             } else if (type_str == "union") {
                 m_mod->unions.emplace_back(read_union(val, *m_mod));
                 define(m_mod->symbols(), name, m_mod->unions.back().get());
@@ -352,7 +394,11 @@ public:
     }
 
     void load() override {
-        declare_pass();
+        {
+            time_report::phase declare_phase("declare");
+            declare_pass();
+        }
+        time_report::phase define_phase("define");
         define_pass();
     }
 
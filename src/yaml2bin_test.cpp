@@ -4,28 +4,6 @@
 
 namespace lidl {
 namespace {
-class memory_writer : public ibinary_writer {
-public:
-    explicit memory_writer(gsl::span<uint8_t> data)
-        : m_data{data} {
-    }
-
-    int tell() override {
-        return m_loc;
-    }
-    void write_raw(gsl::span<const char> data) override {
-        memcpy(m_data.data() + m_loc, data.data(), data.size());
-        m_loc += data.size();
-    }
-
-    gsl::span<uint8_t> get_data() {
-        return m_data.subspan(0, m_loc);
-    }
-
-    gsl::span<uint8_t> m_data;
-    int m_loc = 0;
-};
-
 TEST_CASE("yaml2bin") {
     auto root_module = std::make_unique<lidl::module>();
 
@@ -51,14 +29,12 @@ TEST_CASE("yaml2bin") {
     auto& un = module.unions.back();
     un->add_member("foo", member{name{ptr_handle, {name{str_handle}}}});
 
-    uint8_t buff[64];
-
     SUBCASE("ints") {
         auto i32 = get_wire_type(module, name{i32_handle});
-        memory_writer writer(buff);
+        binary_writer writer;
 
         i32->yaml2bin(module, YAML::Node(42), writer);
-        auto res = writer.get_data();
+        auto res = writer.get();
 
         REQUIRE_EQ(std::vector<uint8_t>{42, 0, 0, 0},
                    std::vector<uint8_t>(res.begin(), res.end()));
@@ -66,11 +42,11 @@ TEST_CASE("yaml2bin") {
 
     SUBCASE("ints alignment") {
         auto i32 = get_wire_type(module, name{i32_handle});
-        memory_writer writer(buff);
+        binary_writer writer;
 
         writer.write<uint8_t>(0);
         i32->yaml2bin(module, YAML::Node(42), writer);
-        auto res = writer.get_data();
+        auto res = writer.get();
 
         REQUIRE_EQ(std::vector<uint8_t>{0, 0, 0, 0, 42, 0, 0, 0},
                    std::vector<uint8_t>(res.begin(), res.end()));
@@ -78,10 +54,10 @@ TEST_CASE("yaml2bin") {
 
     SUBCASE("strings") {
         auto str = get_wire_type(module, name{str_handle});
-        memory_writer writer(buff);
+        binary_writer writer;
 
         str->yaml2bin(module, YAML::Node("hello world"), writer);
-        auto res = writer.get_data();
+        auto res = writer.get();
 
         REQUIRE_EQ(
             std::vector<uint8_t>{
@@ -92,10 +68,10 @@ TEST_CASE("yaml2bin") {
     SUBCASE("vector of ints") {
         auto vec_of_int = dynamic_cast<const wire_type*>(
             resolve(module, name{vec_handle, {name{i32_handle}}}));
-        memory_writer writer(buff);
+        binary_writer writer;
 
         vec_of_int->yaml2bin(module, YAML::Node(std::vector<int64_t>{1, 2, 3}), writer);
-        auto res = writer.get_data();
+        auto res = writer.get();
 
         REQUIRE_EQ(std::vector<uint8_t>{3, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 3, 0, 0, 0},
                    std::vector<uint8_t>(res.begin(), res.end()));
@@ -104,11 +80,11 @@ TEST_CASE("yaml2bin") {
     SUBCASE("vector of pointers to strings") {
         auto vec_of_int = dynamic_cast<const wire_type*>(
             resolve(module, name{vec_handle, {name{ptr_handle, {{name{str_handle}}}}}}));
-        memory_writer writer(buff);
+        binary_writer writer;
 
         vec_of_int->yaml2bin(
             module, YAML::Node(std::vector<std::string>{"hello", "world"}), writer);
-        auto res = writer.get_data();
+        auto res = writer.get();
         auto vec = std::vector<uint8_t>(res.begin(), res.end());
 
         REQUIRE_EQ(std::vector<uint8_t>{5,   0,   'h', 'e', 'l', 'l', 'o', 0,  5, 0,  'w',